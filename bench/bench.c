@@ -0,0 +1,551 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include "../common/compare.h"
+#include "../common/cpu_dispatch.h"
+#include "../searching/binary_search/binary_search.h"
+#include "../sorting/block_merge_sort/block_merge_sort.h"
+#include "../sorting/bubble_sort/bubble_sort.h"
+#include "../sorting/heap_sort/heap_sort.h"
+#include "../sorting/insertion_sort/insertion_sort.h"
+#include "../sorting/merge_sort/merge_sort.h"
+#include "../sorting/quick_sort/quick_sort.h"
+#include "../sorting/sample_sort/sample_sort.h"
+#include "../sorting/selection_sort/selection_sort.h"
+#include "../sorting/sort_stats.h"
+#include "distributions.h"
+#include "perf_counters.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Benchmark suite for the sorting and searching kernels.
+ *
+ * For every distribution and every size n in min_n, 10*min_n, ... up to
+ * max_n, each selected algorithm runs `warmup` untimed times and then
+ * `reps` timed times on a fresh copy of the same input. Each timed run
+ * is also measured with hardware counters when the machine provides
+ * them. Each run is checked for correctness: the output must be sorted and
+ * hold the same elements, and every lookup must land on the key.
+ *
+ * binary_search sorts the input once (untimed), then looks up all n
+ * original elements in their original order, so every lookup hits.
+ *
+ * Kernels get compare_int, so the ones with SIMD variants (insertion_sort,
+ * binary_search) run the path cpu_isa() picks; the level is recorded in the
+ * output metadata. Compare paths on one machine with ALGO_ISA=scalar|avx2.
+ *
+ * Quadratic sorts would take hours at large n. Before each size, the
+ * driver predicts the run time from the previous size and the algorithm's
+ * growth rate. If the prediction exceeds --budget seconds, that
+ * (algorithm, distribution) pair stops there. quick_sort on few_unique
+ * input is quadratic in practice, so the budget cuts it off as well.
+ *
+ * One record per (algorithm, distribution, n) goes to stdout or --out:
+ *   - JSON: {"meta": {...}, "results": [{...}, ...]};
+ *   - CSV: one header line, then one row per record.
+ * Times are in nanoseconds per run; counters are means per run, null (JSON)
+ * or empty (CSV) when unavailable.
+ *
+ * Built with -DSORT_STATS, records also carry the sorts' operation counts
+ * for one run (comparisons, swaps, bytes_moved, max_depth and, for
+ * quick_sort, partition_balance; see sorting/sort_stats.h). Every rep sees
+ * the same input and pivot seed, so one run stands for all. The counting
+ * itself slows the sorts down, so compare times only between builds made
+ * the same way.
+ *
+ * Build: gcc -O2 -pthread bench.c distributions.c perf_counters.c \
+ *        ../common/compare.c ../common/cpu_dispatch.c ../common/parallel.c \
+ *        ../sorting/sort_stats.c ../sorting/bubble_sort/bubble_sort.c \
+ *        ../sorting/insertion_sort/insertion_sort.c \
+ *        ../sorting/selection_sort/selection_sort.c \
+ *        ../sorting/merge_sort/merge_sort.c \
+ *        ../sorting/quick_sort/quick_sort.c \
+ *        ../sorting/sample_sort/sample_sort.c \
+ *        ../sorting/block_merge_sort/block_merge_sort.c \
+ *        ../sorting/heap_sort/heap_sort.c ../data-structures/heap/heap.c \
+ *        ../data-structures/dynamic_array/dynamic_array.c \
+ *        ../searching/binary_search/binary_search.c -lm -o bench
+ *
+ * Usage: ./bench [--algo a,b] [--dist d,e] [--min-n N] [--max-n N]
+ *                [--reps R] [--warmup W] [--budget SECONDS] [--seed S]
+ *                [--format json|csv] [--out FILE] [--list]
+ * e.g.   ./bench --algo quick_sort,merge_sort --max-n 100000000 --format csv
+ */
+
+#define MAX_REPS 101
+
+typedef enum { GROWTH_NLOGN, GROWTH_QUADRATIC } Growth;
+
+typedef struct {
+  const char *name;
+  Growth growth;
+  int is_search;
+  // Sorts arr[0..n) in place; for searches, arr is sorted and the kernel
+  // looks up keys[0..n), returning how many lookups failed to match.
+  size_t (*run)(int *arr, size_t n, const int *keys);
+} Algorithm;
+
+static size_t run_bubble(int *arr, size_t n, const int *keys) {
+  (void)keys;
+  bubble_sort(arr, n, sizeof *arr, compare_int);
+  return 0;
+}
+
+static size_t run_insertion(int *arr, size_t n, const int *keys) {
+  (void)keys;
+  insertion_sort(arr, n, sizeof *arr, compare_int);
+  return 0;
+}
+
+static size_t run_selection(int *arr, size_t n, const int *keys) {
+  (void)keys;
+  selection_sort(arr, n);
+  return 0;
+}
+
+static size_t run_merge(int *arr, size_t n, const int *keys) {
+  (void)keys;
+  if (n > 0)
+    merge_sort(arr, 0, n - 1);
+  return 0;
+}
+
+static size_t run_quick(int *arr, size_t n, const int *keys) {
+  (void)keys;
+  if (n > 0)
+    quick_sort(arr, 0, n - 1);
+  return 0;
+}
+
+static size_t run_sample(int *arr, size_t n, const int *keys) {
+  (void)keys;
+  sample_sort(arr, n, 0); // all online CPUs
+  return 0;
+}
+
+static size_t run_block_merge(int *arr, size_t n, const int *keys) {
+  (void)keys;
+  block_merge_sort(arr, n, sizeof *arr, compare_int);
+  return 0;
+}
+
+static size_t run_heap(int *arr, size_t n, const int *keys) {
+  (void)keys;
+  heap_sort(arr, n, sizeof *arr, compare_int);
+  return 0;
+}
+
+static size_t run_binary_search(int *arr, size_t n, const int *keys) {
+  size_t misses = 0;
+  for (size_t i = 0; i < n; ++i) {
+    ptrdiff_t at = binary_search(arr, n, sizeof *arr, &keys[i], compare_int);
+    misses += at < 0 || arr[at] != keys[i];
+  }
+  return misses;
+}
+
+static const Algorithm algorithms[] = {
+    {"bubble_sort", GROWTH_QUADRATIC, 0, run_bubble},
+    {"insertion_sort", GROWTH_QUADRATIC, 0, run_insertion},
+    {"selection_sort", GROWTH_QUADRATIC, 0, run_selection},
+    {"merge_sort", GROWTH_NLOGN, 0, run_merge},
+    {"quick_sort", GROWTH_NLOGN, 0, run_quick},
+    {"sample_sort", GROWTH_NLOGN, 0, run_sample},
+    {"block_merge_sort", GROWTH_NLOGN, 0, run_block_merge},
+    {"heap_sort", GROWTH_NLOGN, 0, run_heap},
+    {"binary_search", GROWTH_NLOGN, 1, run_binary_search},
+};
+
+#define ALGO_COUNT (sizeof algorithms / sizeof algorithms[0])
+
+typedef enum { FORMAT_JSON, FORMAT_CSV } Format;
+
+typedef struct {
+  int algo_on[ALGO_COUNT];
+  int dist_on[DIST_COUNT];
+  size_t min_n, max_n;
+  int reps, warmup;
+  double budget; // seconds per timed run
+  uint64_t seed;
+  Format format;
+  FILE *out;
+} Options;
+
+typedef struct {
+  double ns_min, ns_median, ns_mean;
+  double counter[PERF_COUNTER_COUNT]; // mean per run, or NAN
+  int has_ops;                        // built with SORT_STATS
+  SortStats ops;                      // of the last run
+} Result;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+/*
+ * Option parsing
+ */
+
+// Marks each name of a comma-separated list; -1 on an unknown name.
+static int parse_list(char *list, int *on, int count,
+                      int (*lookup)(const char *)) {
+  memset(on, 0, count * sizeof *on);
+  for (char *name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+    int idx = lookup(name);
+    if (idx < 0) {
+      fprintf(stderr, "unknown name: %s (see --list)\n", name);
+      return -1;
+    }
+    on[idx] = 1;
+  }
+  return 0;
+}
+
+static int algo_from_name(const char *name) {
+  for (size_t a = 0; a < ALGO_COUNT; ++a)
+    if (strcmp(name, algorithms[a].name) == 0)
+      return (int)a;
+  return -1;
+}
+
+static void print_list(void) {
+  printf("algorithms:");
+  for (size_t a = 0; a < ALGO_COUNT; ++a)
+    printf(" %s", algorithms[a].name);
+  printf("\ndistributions:");
+  for (int d = 0; d < DIST_COUNT; ++d)
+    printf(" %s", dist_name(d));
+  printf("\n");
+}
+
+static int parse_options(int argc, char **argv, Options *opt) {
+  *opt = (Options){.min_n = 1000,
+                   .max_n = 1000000,
+                   .reps = 5,
+                   .warmup = 1,
+                   .budget = 1.0,
+                   .seed = 42,
+                   .format = FORMAT_JSON,
+                   .out = stdout};
+  for (size_t a = 0; a < ALGO_COUNT; ++a)
+    opt->algo_on[a] = 1;
+  for (int d = 0; d < DIST_COUNT; ++d)
+    opt->dist_on[d] = 1;
+
+  for (int i = 1; i < argc; ++i) {
+    const char *flag = argv[i];
+    if (strcmp(flag, "--list") == 0) {
+      print_list();
+      exit(0);
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "missing value for %s\n", flag);
+      return -1;
+    }
+    char *value = argv[++i];
+    if (strcmp(flag, "--algo") == 0) {
+      if (parse_list(value, opt->algo_on, ALGO_COUNT, algo_from_name) < 0)
+        return -1;
+    } else if (strcmp(flag, "--dist") == 0) {
+      if (parse_list(value, opt->dist_on, DIST_COUNT, dist_from_name) < 0)
+        return -1;
+    } else if (strcmp(flag, "--min-n") == 0) {
+      opt->min_n = strtoull(value, NULL, 10);
+    } else if (strcmp(flag, "--max-n") == 0) {
+      opt->max_n = strtoull(value, NULL, 10);
+    } else if (strcmp(flag, "--reps") == 0) {
+      opt->reps = atoi(value);
+    } else if (strcmp(flag, "--warmup") == 0) {
+      opt->warmup = atoi(value);
+    } else if (strcmp(flag, "--budget") == 0) {
+      opt->budget = atof(value);
+    } else if (strcmp(flag, "--seed") == 0) {
+      opt->seed = strtoull(value, NULL, 10);
+    } else if (strcmp(flag, "--format") == 0) {
+      if (strcmp(value, "json") == 0)
+        opt->format = FORMAT_JSON;
+      else if (strcmp(value, "csv") == 0)
+        opt->format = FORMAT_CSV;
+      else {
+        fprintf(stderr, "unknown format: %s\n", value);
+        return -1;
+      }
+    } else if (strcmp(flag, "--out") == 0) {
+      opt->out = fopen(value, "w");
+      if (opt->out == NULL) {
+        perror(value);
+        return -1;
+      }
+    } else {
+      fprintf(stderr, "unknown option: %s\n", flag);
+      return -1;
+    }
+  }
+
+  // n must fit an int (the kernels sort ints and index with them)
+  if (opt->min_n == 0 || opt->max_n < opt->min_n || opt->max_n > 1u << 30 ||
+      opt->reps < 1 || opt->reps > MAX_REPS || opt->warmup < 0) {
+    fprintf(stderr, "bad sizes or repetition counts\n");
+    return -1;
+  }
+  return 0;
+}
+
+/*
+ * Output
+ */
+
+static void print_counter(FILE *out, Format format, double value) {
+  if (isnan(value))
+    fputs(format == FORMAT_JSON ? "null" : "", out);
+  else
+    fprintf(out, "%.0f", value);
+}
+
+static void emit_header(const Options *opt, const PerfCounters *pc) {
+  if (opt->format == FORMAT_CSV) {
+    fprintf(opt->out,
+            "algo,dist,n,isa,reps,ns_min,ns_median,ns_mean,ns_per_elem");
+    for (int c = 0; c < PERF_COUNTER_COUNT; ++c)
+      fprintf(opt->out, ",%s", perf_counter_name(c));
+    fprintf(opt->out, ",ipc,comparisons,swaps,bytes_moved,max_depth,"
+                      "partition_balance\n");
+    return;
+  }
+  fprintf(opt->out,
+          "{\n  \"meta\": {\"seed\": %llu, \"reps\": %d, \"warmup\": %d, "
+          "\"isa\": \"%s\", \"counters\": [",
+          (unsigned long long)opt->seed, opt->reps, opt->warmup,
+          cpu_isa_name(cpu_isa()));
+  int first = 1;
+  for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+    if (pc->fd[c] < 0)
+      continue;
+    fprintf(opt->out, "%s\"%s\"", first ? "" : ", ", perf_counter_name(c));
+    first = 0;
+  }
+  fprintf(opt->out, "]},\n  \"results\": [");
+}
+
+// Operation counts; null (JSON) / empty (CSV) without SORT_STATS.
+static void emit_ops(const Options *opt, const Result *r) {
+  const SortStats *ops = &r->ops;
+  double balance = ops->partitioned > 0 ? (double)ops->smaller_side /
+                                               (double)ops->partitioned
+                                         : NAN;
+  double values[] = {(double)ops->comparisons, (double)ops->swaps,
+                     (double)ops->bytes_moved, (double)ops->max_depth};
+  static const char *names[] = {"comparisons", "swaps", "bytes_moved",
+                                "max_depth"};
+
+  for (int i = 0; i < 4; ++i) {
+    if (opt->format == FORMAT_JSON)
+      fprintf(opt->out, ", \"%s\": ", names[i]);
+    else
+      fputc(',', opt->out);
+    print_counter(opt->out, opt->format, r->has_ops ? values[i] : NAN);
+  }
+  if (opt->format == FORMAT_JSON)
+    fprintf(opt->out, ", \"partition_balance\": ");
+  else
+    fputc(',', opt->out);
+  if (r->has_ops && !isnan(balance))
+    fprintf(opt->out, "%.3f", balance);
+  else if (opt->format == FORMAT_JSON)
+    fputs("null", opt->out);
+}
+
+static void emit_result(const Options *opt, const Algorithm *algo,
+                        Distribution dist, size_t n, const Result *r,
+                        int first) {
+  FILE *out = opt->out;
+  double ipc = r->counter[PERF_INSTRUCTIONS] / r->counter[PERF_CYCLES];
+  if (opt->format == FORMAT_CSV) {
+    fprintf(out, "%s,%s,%zu,%s,%d,%.0f,%.0f,%.0f,%.3f", algo->name,
+            dist_name(dist), n, cpu_isa_name(cpu_isa()), opt->reps, r->ns_min,
+            r->ns_median, r->ns_mean, r->ns_median / n);
+    for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+      fputc(',', out);
+      print_counter(out, opt->format, r->counter[c]);
+    }
+    fputc(',', out);
+    if (!isnan(ipc))
+      fprintf(out, "%.3f", ipc);
+    emit_ops(opt, r);
+    fputc('\n', out);
+    return;
+  }
+  fprintf(out,
+          "%s\n    {\"algo\": \"%s\", \"dist\": \"%s\", \"n\": %zu, "
+          "\"reps\": %d, \"ns_min\": %.0f, \"ns_median\": %.0f, "
+          "\"ns_mean\": %.0f, \"ns_per_elem\": %.3f",
+          first ? "" : ",", algo->name, dist_name(dist), n, opt->reps,
+          r->ns_min, r->ns_median, r->ns_mean, r->ns_median / n);
+  for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+    fprintf(out, ", \"%s\": ", perf_counter_name(c));
+    print_counter(out, opt->format, r->counter[c]);
+  }
+  if (isnan(ipc))
+    fprintf(out, ", \"ipc\": null");
+  else
+    fprintf(out, ", \"ipc\": %.3f", ipc);
+  emit_ops(opt, r);
+  fputc('}', out);
+}
+
+static void emit_footer(const Options *opt) {
+  if (opt->format == FORMAT_JSON)
+    fprintf(opt->out, "\n  ]\n}\n");
+}
+
+/*
+ * Measurement
+ */
+
+// Sorted and a permutation of the input (checked through a sorted copy).
+static int check_sorted(const int *out, const int *reference, size_t n) {
+  for (size_t i = 1; i < n; ++i)
+    if (out[i - 1] > out[i])
+      return 0;
+  return memcmp(out, reference, n * sizeof *out) == 0;
+}
+
+/*
+ * Runs one (algorithm, input) pair. `sorted` is the input sorted with
+ * qsort: the array searched by binary_search and the expected output of
+ * every sort. Returns -1 if the kernel produced a wrong answer.
+ */
+static int measure(const Options *opt, const Algorithm *algo, const int *input,
+                   const int *sorted, int *work, size_t n, PerfCounters *pc,
+                   Result *r) {
+  double times[MAX_REPS];
+  double sums[PERF_COUNTER_COUNT] = {0};
+  int counted[PERF_COUNTER_COUNT] = {0};
+
+  for (int rep = -opt->warmup; rep < opt->reps; ++rep) {
+    memcpy(work, algo->is_search ? sorted : input, n * sizeof *work);
+    srand((unsigned)opt->seed); // quick_sort draws pivots from rand()
+
+    PerfSample sample;
+    sort_stats_reset();
+    perf_start(pc);
+    double t0 = now_ns();
+    size_t misses = algo->run(work, n, input);
+    double t1 = now_ns();
+    perf_stop(pc, &sample);
+    r->has_ops = sort_stats_get(&r->ops) == 0;
+
+    if (algo->is_search ? misses != 0 : !check_sorted(work, sorted, n))
+      return -1;
+    if (rep < 0)
+      continue;
+    times[rep] = t1 - t0;
+    for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+      if (sample.value[c] == PERF_UNAVAILABLE)
+        continue;
+      sums[c] += (double)sample.value[c];
+      counted[c]++;
+    }
+  }
+
+  qsort(times, opt->reps, sizeof *times, cmp_double);
+  double total = 0;
+  for (int rep = 0; rep < opt->reps; ++rep)
+    total += times[rep];
+  r->ns_min = times[0];
+  r->ns_median = times[opt->reps / 2];
+  r->ns_mean = total / opt->reps;
+  for (int c = 0; c < PERF_COUNTER_COUNT; ++c)
+    r->counter[c] = counted[c] == opt->reps ? sums[c] / opt->reps : NAN;
+  return 0;
+}
+
+// Expected run time at next_n given the median time at n.
+static double predict_ns(Growth growth, double ns, size_t n, size_t next_n) {
+  double ratio = (double)next_n / n;
+  if (growth == GROWTH_QUADRATIC)
+    return ns * ratio * ratio;
+  return ns * ratio * log2((double)next_n) / log2((double)n > 2 ? n : 2);
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (parse_options(argc, argv, &opt) < 0)
+    return 1;
+
+  PerfCounters pc;
+  if (perf_open(&pc) == 0)
+    fprintf(stderr, "bench: hardware counters unavailable, timing only\n");
+
+  int *input = malloc(opt.max_n * sizeof *input);
+  int *sorted = malloc(opt.max_n * sizeof *sorted);
+  int *work = malloc(opt.max_n * sizeof *work);
+  if (input == NULL || sorted == NULL || work == NULL) {
+    fprintf(stderr, "bench: cannot allocate %zu elements\n", opt.max_n);
+    return 1;
+  }
+
+  emit_header(&opt, &pc);
+  int status = 0, first = 1;
+  for (int d = 0; d < DIST_COUNT; ++d) {
+    if (!opt.dist_on[d])
+      continue;
+    double last_ns[ALGO_COUNT] = {0}; // median at the previous size
+    size_t last_n[ALGO_COUNT] = {0};
+    int stopped[ALGO_COUNT] = {0};
+
+    for (size_t n = opt.min_n; n <= opt.max_n; n *= 10) {
+      dist_fill(input, n, d, opt.seed ^ n);
+      memcpy(sorted, input, n * sizeof *sorted);
+      qsort(sorted, n, sizeof *sorted, compare_int);
+
+      for (size_t a = 0; a < ALGO_COUNT; ++a) {
+        const Algorithm *algo = &algorithms[a];
+        if (!opt.algo_on[a] || stopped[a])
+          continue;
+        if (last_n[a] != 0 &&
+            predict_ns(algo->growth, last_ns[a], last_n[a], n) >
+                opt.budget * 1e9) {
+          fprintf(stderr, "bench: %s/%s stops at n = %zu (over budget)\n",
+                  algo->name, dist_name(d), last_n[a]);
+          stopped[a] = 1;
+          continue;
+        }
+
+        Result r;
+        if (measure(&opt, algo, input, sorted, work, n, &pc, &r) < 0) {
+          fprintf(stderr, "bench: %s/%s gave a wrong result at n = %zu\n",
+                  algo->name, dist_name(d), n);
+          stopped[a] = 1;
+          status = 1;
+          continue;
+        }
+        emit_result(&opt, algo, d, n, &r, first);
+        first = 0;
+        fflush(opt.out);
+        last_ns[a] = r.ns_median;
+        last_n[a] = n;
+      }
+      if (n > opt.max_n / 10) // n * 10 would pass max_n (or overflow)
+        break;
+    }
+  }
+  emit_footer(&opt);
+
+  perf_close(&pc);
+  if (opt.out != stdout)
+    fclose(opt.out);
+  free(input);
+  free(sorted);
+  free(work);
+  return status;
+}
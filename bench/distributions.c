@@ -0,0 +1,74 @@
+#include "distributions.h"
+#include <math.h>
+#include <string.h>
+
+static const char *names[DIST_COUNT] = {
+    [DIST_RANDOM] = "random",
+    [DIST_SORTED] = "sorted",
+    [DIST_REVERSED] = "reversed",
+    [DIST_FEW_UNIQUE_VALUES] = "few_unique",
+    [DIST_ZIPF] = "zipf",
+    [DIST_ORGAN_PIPE] = "organ_pipe",
+};
+
+const char *dist_name(Distribution dist) {
+  return (unsigned)dist < DIST_COUNT ? names[dist] : "?";
+}
+
+int dist_from_name(const char *name) {
+  for (int d = 0; d < DIST_COUNT; ++d)
+    if (strcmp(name, names[d]) == 0)
+      return d;
+  return -1;
+}
+
+uint64_t dist_next(uint64_t *state) {
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+// Uniform double in [0, 1).
+static double next_unit(uint64_t *state) {
+  return (dist_next(state) >> 11) * 0x1.0p-53;
+}
+
+void dist_fill(int *arr, size_t n, Distribution dist, uint64_t seed) {
+  uint64_t state = seed;
+  switch (dist) {
+  case DIST_RANDOM:
+    for (size_t i = 0; i < n; ++i)
+      arr[i] = (int)(uint32_t)dist_next(&state);
+    break;
+  case DIST_SORTED:
+    for (size_t i = 0; i < n; ++i)
+      arr[i] = (int)i;
+    break;
+  case DIST_REVERSED:
+    for (size_t i = 0; i < n; ++i)
+      arr[i] = (int)(n - 1 - i);
+    break;
+  case DIST_FEW_UNIQUE_VALUES:
+    for (size_t i = 0; i < n; ++i)
+      arr[i] = (int)(dist_next(&state) % DIST_FEW_UNIQUE);
+    break;
+  case DIST_ZIPF: {
+    // Continuous inverse CDF of 1/x on [1, n + 1): x = (n + 1)^u. Flooring
+    // gives P(k) ~ log((k + 1) / k) ~ 1/k, i.e. Zipf with s = 1, in O(1)
+    // memory (a table-based inverse would need n doubles at 100M).
+    double log_range = log((double)n + 1);
+    for (size_t i = 0; i < n; ++i) {
+      size_t rank = (size_t)exp(next_unit(&state) * log_range) - 1;
+      arr[i] = (int)(rank < n ? rank : n - 1);
+    }
+    break;
+  }
+  case DIST_ORGAN_PIPE:
+    for (size_t i = 0; i < n; ++i)
+      arr[i] = (int)(i < n / 2 ? i : n - 1 - i);
+    break;
+  default:
+    memset(arr, 0, n * sizeof *arr);
+  }
+}
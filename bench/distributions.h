@@ -0,0 +1,44 @@
+#ifndef DISTRIBUTIONS_H
+#define DISTRIBUTIONS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Input generators for the benchmarks.
+ *
+ * Every generator is deterministic for a given seed, so two runs (or two
+ * commits) sort exactly the same arrays.
+ *
+ *   random      - uniform over the whole int range
+ *   sorted      - 0, 1, ..., n-1
+ *   reversed    - n-1, ..., 1, 0
+ *   few_unique  - uniform over DIST_FEW_UNIQUE values (lots of duplicates)
+ *   zipf        - rank k drawn with P(k) ~ 1/k over [0, n): a few values
+ *                 dominate, with a long tail
+ *   organ_pipe  - ascending to the middle, then descending
+ */
+
+#define DIST_FEW_UNIQUE 16
+
+typedef enum {
+  DIST_RANDOM,
+  DIST_SORTED,
+  DIST_REVERSED,
+  DIST_FEW_UNIQUE_VALUES,
+  DIST_ZIPF,
+  DIST_ORGAN_PIPE,
+  DIST_COUNT
+} Distribution;
+
+const char *dist_name(Distribution dist);
+
+// Distribution with that name, or -1.
+int dist_from_name(const char *name);
+
+void dist_fill(int *arr, size_t n, Distribution dist, uint64_t seed);
+
+// splitmix64 step; exposed so the driver draws lookup keys the same way.
+uint64_t dist_next(uint64_t *state);
+
+#endif // DISTRIBUTIONS_H
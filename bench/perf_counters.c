@@ -0,0 +1,114 @@
+#define _GNU_SOURCE // syscall
+#include "perf_counters.h"
+
+static const char *names[PERF_COUNTER_COUNT] = {
+    [PERF_CYCLES] = "cycles",
+    [PERF_INSTRUCTIONS] = "instructions",
+    [PERF_CACHE_MISSES] = "cache_misses",
+    [PERF_BRANCH_MISSES] = "branch_misses",
+};
+
+const char *perf_counter_name(PerfCounter counter) {
+  return (unsigned)counter < PERF_COUNTER_COUNT ? names[counter] : "?";
+}
+
+#ifdef __linux__
+
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static const uint64_t configs[PERF_COUNTER_COUNT] = {
+    [PERF_CYCLES] = PERF_COUNT_HW_CPU_CYCLES,
+    [PERF_INSTRUCTIONS] = PERF_COUNT_HW_INSTRUCTIONS,
+    [PERF_CACHE_MISSES] = PERF_COUNT_HW_CACHE_MISSES,
+    [PERF_BRANCH_MISSES] = PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+// read() layout for PERF_FORMAT_TOTAL_TIME_ENABLED | _RUNNING
+typedef struct {
+  uint64_t value;
+  uint64_t time_enabled;
+  uint64_t time_running;
+} CounterRead;
+
+static int open_counter(uint64_t config) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof attr);
+  attr.size = sizeof attr;
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // pid 0, cpu -1: this thread on any CPU; no glibc wrapper exists
+  return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+int perf_open(PerfCounters *pc) {
+  int opened = 0;
+  for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+    pc->fd[c] = open_counter(configs[c]);
+    opened += pc->fd[c] >= 0;
+  }
+  return opened;
+}
+
+void perf_start(PerfCounters *pc) {
+  for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+    if (pc->fd[c] < 0)
+      continue;
+    ioctl(pc->fd[c], PERF_EVENT_IOC_RESET, 0);
+    ioctl(pc->fd[c], PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+void perf_stop(PerfCounters *pc, PerfSample *out) {
+  for (int c = 0; c < PERF_COUNTER_COUNT; ++c)
+    if (pc->fd[c] >= 0)
+      ioctl(pc->fd[c], PERF_EVENT_IOC_DISABLE, 0);
+
+  for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+    CounterRead r;
+    out->value[c] = PERF_UNAVAILABLE;
+    if (pc->fd[c] < 0 || read(pc->fd[c], &r, sizeof r) != sizeof r ||
+        r.time_running == 0)
+      continue;
+    out->value[c] = r.time_running == r.time_enabled
+                        ? r.value
+                        : (uint64_t)((double)r.value * r.time_enabled /
+                                     r.time_running);
+  }
+}
+
+void perf_close(PerfCounters *pc) {
+  for (int c = 0; c < PERF_COUNTER_COUNT; ++c) {
+    if (pc->fd[c] >= 0)
+      close(pc->fd[c]);
+    pc->fd[c] = -1;
+  }
+}
+
+#else // no perf_event_open: every counter reads as unavailable
+
+int perf_open(PerfCounters *pc) {
+  for (int c = 0; c < PERF_COUNTER_COUNT; ++c)
+    pc->fd[c] = -1;
+  return 0;
+}
+
+void perf_start(PerfCounters *pc) { (void)pc; }
+
+void perf_stop(PerfCounters *pc, PerfSample *out) {
+  (void)pc;
+  for (int c = 0; c < PERF_COUNTER_COUNT; ++c)
+    out->value[c] = PERF_UNAVAILABLE;
+}
+
+void perf_close(PerfCounters *pc) { (void)pc; }
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+
+/*
+ * Hardware counters through Linux perf_event_open.
+ *
+ * Each counter is opened on its own (not as a group), so a machine or VM
+ * that lacks one event still reports the others. Counters count user space
+ * of the calling thread only. When the kernel multiplexes them, values are
+ * scaled by time_enabled / time_running.
+ *
+ * Unavailable counters (no PMU in the VM, perf_event_paranoid too high,
+ * not Linux) read as PERF_UNAVAILABLE; the driver prints those as null.
+ */
+
+#define PERF_UNAVAILABLE UINT64_MAX
+
+typedef enum {
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_CACHE_MISSES,
+  PERF_BRANCH_MISSES,
+  PERF_COUNTER_COUNT
+} PerfCounter;
+
+typedef struct {
+  int fd[PERF_COUNTER_COUNT]; // -1 when unavailable
+} PerfCounters;
+
+typedef struct {
+  uint64_t value[PERF_COUNTER_COUNT];
+} PerfSample;
+
+const char *perf_counter_name(PerfCounter counter);
+
+// Opens whatever counters are available. Returns how many opened.
+int perf_open(PerfCounters *pc);
+
+// Zero and start / stop every open counter.
+void perf_start(PerfCounters *pc);
+void perf_stop(PerfCounters *pc, PerfSample *out);
+
+void perf_close(PerfCounters *pc);
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,6 @@
+#include "compare.h"
+
+int compare_int(const void *a, const void *b) {
+  int x = *(const int *)a, y = *(const int *)b;
+  return (x > y) - (x < y);
+}
@@ -0,0 +1,15 @@
+#ifndef COMPARE_H
+#define COMPARE_H
+
+/*
+ * Shared comparators (qsort convention: <0, 0, >0).
+ *
+ * Generic kernels recognise these by address: insertion_sort or
+ * binary_search called with compare_int on int-sized elements take their
+ * typed, SIMD-dispatched path instead of calling the comparator per
+ * element. Any other comparator works as before.
+ */
+
+int compare_int(const void *a, const void *b);
+
+#endif // COMPARE_H
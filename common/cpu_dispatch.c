@@ -0,0 +1,45 @@
+#include "cpu_dispatch.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *names[] = {
+    [CPU_ISA_SCALAR] = "scalar",
+    [CPU_ISA_AVX2] = "avx2",
+    [CPU_ISA_AVX512] = "avx512",
+};
+
+const char *cpu_isa_name(CpuIsa isa) {
+  return (unsigned)isa <= CPU_ISA_AVX512 ? names[isa] : "?";
+}
+
+CpuIsa cpu_detected_isa(void) {
+#if CPU_X86
+  // also checks that the OS saves the wide registers (XCR0)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return CPU_ISA_AVX512;
+  if (__builtin_cpu_supports("avx2"))
+    return CPU_ISA_AVX2;
+#endif
+  return CPU_ISA_SCALAR;
+}
+
+// -1 until the first call; racing first calls compute the same value
+static atomic_int resolved = -1;
+
+CpuIsa cpu_isa(void) {
+  int isa = atomic_load_explicit(&resolved, memory_order_relaxed);
+  if (isa >= 0)
+    return (CpuIsa)isa;
+
+  isa = cpu_detected_isa();
+  const char *forced = getenv(CPU_ISA_ENV);
+  if (forced != NULL) {
+    for (int level = CPU_ISA_SCALAR; level <= CPU_ISA_AVX512; ++level)
+      if (strcmp(forced, names[level]) == 0 && level < isa)
+        isa = level;
+  }
+  atomic_store_explicit(&resolved, isa, memory_order_relaxed);
+  return (CpuIsa)isa;
+}
@@ -0,0 +1,42 @@
+#ifndef CPU_DISPATCH_H
+#define CPU_DISPATCH_H
+
+/*
+ * Runtime CPU feature dispatch
+ *
+ * Kernels with SIMD variants are compiled into every binary (through
+ * per-function target attributes, so no -mavx2 / -mavx512f build flags)
+ * and pick one at their first call from cpu_isa():
+ *
+ *   CPU_ISA_SCALAR  - portable C, any CPU
+ *   CPU_ISA_AVX2    - 8 x int32 lanes
+ *   CPU_ISA_AVX512  - 16 x int32 lanes (AVX-512F)
+ *
+ * Detection runs once. Setting the environment variable CPU_ISA_ENV
+ * ("ALGO_ISA") to scalar, avx2 or avx512 forces a level, e.g. to benchmark
+ * the paths against each other on one machine. A level the CPU does not
+ * support is clamped down to the best one it does, so the override can
+ * never produce an illegal instruction. Unknown values are ignored.
+ */
+
+#define CPU_ISA_ENV "ALGO_ISA"
+
+typedef enum { CPU_ISA_SCALAR, CPU_ISA_AVX2, CPU_ISA_AVX512 } CpuIsa;
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_X86 1
+#define CPU_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#define CPU_TARGET_AVX512 __attribute__((target("avx512f,popcnt")))
+#else
+#define CPU_X86 0
+#endif
+
+// Best level the hardware (and OS) supports.
+CpuIsa cpu_detected_isa(void);
+
+// Level kernels should use: detected, lowered by CPU_ISA_ENV if set.
+CpuIsa cpu_isa(void);
+
+const char *cpu_isa_name(CpuIsa isa);
+
+#endif // CPU_DISPATCH_H
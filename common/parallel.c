@@ -0,0 +1,34 @@
+#include "parallel.h"
+
+void parallel_chunk(size_t len, unsigned threads, unsigned t, size_t *begin,
+                    size_t *end) {
+  *begin = len * t / threads;
+  *end = len * (t + 1) / threads;
+}
+
+static ParallelTask *task_of(void *workers, size_t size, unsigned t) {
+  return (ParallelTask *)((char *)workers + (size_t)t * size);
+}
+
+void parallel_run(void *workers, size_t size, unsigned threads,
+                  void *(*phase)(void *)) {
+  if (threads == 1) {
+    *task_of(workers, size, 0) = (ParallelTask){.id = 0};
+    phase(workers);
+    return;
+  }
+  for (unsigned t = 0; t < threads; ++t) {
+    ParallelTask *task = task_of(workers, size, t);
+    task->id = t;
+    task->own_thread = 1;
+    if (pthread_create(&task->thread, NULL, phase, task) != 0) {
+      task->own_thread = 0; // no thread: do it here
+      phase(task);
+    }
+  }
+  for (unsigned t = 0; t < threads; ++t) {
+    ParallelTask *task = task_of(workers, size, t);
+    if (task->own_thread)
+      pthread_join(task->thread, NULL);
+  }
+}
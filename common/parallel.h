@@ -0,0 +1,35 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <pthread.h>
+#include <stddef.h> // For size_t
+
+/*
+ * Fork-join phases for the parallel sorts
+ *
+ * A sort splits its work among `threads` workers and runs it as a series
+ * of phases. parallel_run starts one thread per worker and joins them,
+ * which is the only synchronisation between phases. If a thread cannot be
+ * started, the caller runs that worker's share itself, so a phase always
+ * completes; a single worker runs inline without starting a thread.
+ *
+ * Each sort keeps its per-worker state in its own struct whose first
+ * member is a ParallelTask, and passes an array of them.
+ */
+
+typedef struct {
+  unsigned id;      // worker index, 0 .. threads - 1
+  int own_thread;   // 0 when run by the caller instead
+  pthread_t thread;
+} ParallelTask;
+
+// Worker t of `threads` owns elements [*begin, *end) of len.
+void parallel_chunk(size_t len, unsigned threads, unsigned t, size_t *begin,
+                    size_t *end);
+
+// Run phase(&workers[t]) for every t, where workers is an array of
+// `threads` structs of `size` bytes, each starting with a ParallelTask.
+void parallel_run(void *workers, size_t size, unsigned threads,
+                  void *(*phase)(void *));
+
+#endif // PARALLEL_H
@@ -0,0 +1,563 @@
+#include "concurrent_queue.h"
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE 64
+
+/*
+ * Nodes
+ */
+
+static QueueNode *alloc_node(size_t payload_len) {
+  if (payload_len > SIZE_MAX - sizeof(QueueNode))
+    return NULL;
+  QueueNode *node = malloc(sizeof(QueueNode) + payload_len);
+  if (node == NULL)
+    return NULL;
+  atomic_init(&node->next, NULL);
+  return node;
+}
+
+QueueNode *create_queue_node(const void *dt, size_t len) {
+  if (dt == NULL && len > 0)
+    return NULL;
+  QueueNode *node = alloc_node(len);
+  if (node == NULL)
+    return NULL;
+  if (len > 0)
+    memcpy(node->payload, dt, len);
+  node->data = node->payload;
+  node->data_len = len;
+  node->data_reference = 0;
+  return node;
+}
+
+QueueNode *create_queue_reference_node(void *dt, size_t len) {
+  QueueNode *node = alloc_node(0);
+  if (node == NULL)
+    return NULL;
+  node->data = dt;
+  node->data_len = len;
+  node->data_reference = 1;
+  return node;
+}
+
+void free_queue_node(QueueNode *node) { free(node); }
+
+/*
+ * MPSC (Vyukov)
+ *
+ * head is the producer end, tail the consumer end. A producer swaps itself
+ * into head and then links the previous head to itself; between those two
+ * steps the chain is briefly broken, which the consumer sees as "empty".
+ * The stub node keeps the list non-empty so neither end is ever NULL.
+ */
+
+struct mpsc_queue {
+  alignas(CACHE_LINE) _Atomic(QueueNode *) head;
+  alignas(CACHE_LINE) QueueNode *tail;
+  QueueNode *stub;
+};
+
+MpscQueue *create_mpsc_queue(void) {
+  MpscQueue *q = aligned_alloc(CACHE_LINE, sizeof(MpscQueue));
+  if (q == NULL)
+    return NULL;
+  q->stub = create_queue_reference_node(NULL, 0);
+  if (q->stub == NULL) {
+    free(q);
+    return NULL;
+  }
+  atomic_init(&q->head, q->stub);
+  q->tail = q->stub;
+  return q;
+}
+
+// Links first..last (already chained) after the current head.
+static void mpsc_push_chain(MpscQueue *q, QueueNode *first, QueueNode *last) {
+  atomic_store_explicit(&last->next, NULL, memory_order_relaxed);
+  QueueNode *prev =
+      atomic_exchange_explicit(&q->head, last, memory_order_acq_rel);
+  atomic_store_explicit(&prev->next, first, memory_order_release);
+}
+
+void mpsc_push_node(MpscQueue *q, QueueNode *node) {
+  mpsc_push_chain(q, node, node);
+}
+
+void mpsc_push_batch(MpscQueue *q, QueueNode **nodes, size_t n) {
+  if (n == 0)
+    return;
+  for (size_t i = 0; i + 1 < n; ++i)
+    atomic_store_explicit(&nodes[i]->next, nodes[i + 1], memory_order_relaxed);
+  mpsc_push_chain(q, nodes[0], nodes[n - 1]);
+}
+
+int mpsc_enqueue(MpscQueue *q, const void *dt, size_t len) {
+  if (q == NULL)
+    return -1;
+  QueueNode *node = create_queue_node(dt, len);
+  if (node == NULL)
+    return -1;
+  mpsc_push_node(q, node);
+  return 0;
+}
+
+int mpsc_enqueue_reference(MpscQueue *q, void *dt, size_t len) {
+  if (q == NULL)
+    return -1;
+  QueueNode *node = create_queue_reference_node(dt, len);
+  if (node == NULL)
+    return -1;
+  mpsc_push_node(q, node);
+  return 0;
+}
+
+QueueNode *mpsc_dequeue(MpscQueue *q) {
+  QueueNode *tail = q->tail;
+  QueueNode *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+  if (tail == q->stub) {
+    if (next == NULL)
+      return NULL;
+    q->tail = tail = next;
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+  }
+  if (next != NULL) {
+    q->tail = next;
+    return tail;
+  }
+  // tail is the last linked node: only take it if no push is in flight
+  if (tail != atomic_load_explicit(&q->head, memory_order_acquire))
+    return NULL;
+  mpsc_push_node(q, q->stub);
+  next = atomic_load_explicit(&tail->next, memory_order_acquire);
+  if (next != NULL) {
+    q->tail = next;
+    return tail;
+  }
+  return NULL;
+}
+
+size_t mpsc_dequeue_batch(MpscQueue *q, QueueNode **out, size_t max) {
+  size_t n = 0;
+  while (n < max && (out[n] = mpsc_dequeue(q)) != NULL)
+    n++;
+  return n;
+}
+
+void free_mpsc_queue(MpscQueue *q) {
+  if (q == NULL)
+    return;
+  QueueNode *node;
+  while ((node = mpsc_dequeue(q)) != NULL)
+    free_queue_node(node);
+  free_queue_node(q->stub);
+  free(q);
+}
+
+/*
+ * MPMC (Michael-Scott)
+ *
+ * head always points at a dummy node; the first real item is head->next.
+ * A dequeuer swings head forward, takes the item from the new head (which
+ * becomes the next dummy) and retires the old one.
+ *
+ * Reclamation uses hazard pointers: each thread owns one record per queue
+ * with two slots (hp[0] for head/tail, hp[1] for head->next). A retired
+ * node is freed only once no slot holds it. Records are claimed on first
+ * use and tagged with the owner's thread id; a small direct-mapped
+ * thread-local cache keyed by queue id finds them, and on a miss (first
+ * use, or two queues sharing a cache slot) the thread looks for a record
+ * it already owns before claiming a new one.
+ *
+ * At thread exit a pthread key destructor releases the thread's records on
+ * every queue still alive: it scans their retired lists, and the few nodes
+ * still protected stay in the record for its next owner to free. Live
+ * queues are tracked in a registry under one mutex, so a queue freed first
+ * is simply skipped.
+ */
+
+#define HP_PER_THREAD 2
+#define HP_RETIRE_MAX (2 * HP_PER_THREAD * MSQ_MAX_THREADS)
+#define HP_CACHE 8
+
+struct hp_record {
+  alignas(CACHE_LINE) _Atomic(QueueNode *) hp[HP_PER_THREAD];
+  atomic_int owned;
+  atomic_ulong owner;  // thread id of the owner, 0 when free
+  QueueNode **retired; // HP_RETIRE_MAX slots, owner thread only
+  size_t nretired;
+};
+
+struct ms_queue {
+  alignas(CACHE_LINE) _Atomic(QueueNode *) head;
+  alignas(CACHE_LINE) _Atomic(QueueNode *) tail;
+  alignas(CACHE_LINE) atomic_size_t records_used; // high-water mark
+  size_t max_payload;
+  unsigned long id;
+  MsQueue *next_live; // registry, under registry_lock
+  struct hp_record records[MSQ_MAX_THREADS];
+};
+
+static atomic_ulong next_queue_id = 1;
+static atomic_ulong next_thread_id = 1;
+
+static _Thread_local unsigned long hp_thread_id;
+static _Thread_local struct {
+  unsigned long id;
+  struct hp_record *rec;
+} hp_cache[HP_CACHE];
+
+// Records this thread owns, released by release_records at thread exit.
+typedef struct owned_record {
+  MsQueue *q;
+  unsigned long queue_id; // q may be freed and its address reused
+  struct hp_record *rec;
+  struct owned_record *next;
+} OwnedRecord;
+
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static MsQueue *live_queues;
+static pthread_once_t owned_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t owned_key;
+static int owned_key_ok;
+
+static void hp_scan(MsQueue *q, struct hp_record *rec);
+
+// Caller holds registry_lock.
+static int queue_alive(const MsQueue *q, unsigned long id) {
+  for (const MsQueue *l = live_queues; l != NULL; l = l->next_live)
+    if (l == q && l->id == id)
+      return 1;
+  return 0;
+}
+
+static void release_records(void *arg) {
+  OwnedRecord *o = arg;
+  pthread_mutex_lock(&registry_lock);
+  while (o != NULL) {
+    OwnedRecord *next = o->next;
+    if (queue_alive(o->q, o->queue_id)) {
+      hp_scan(o->q, o->rec);
+      atomic_store(&o->rec->owner, 0);
+      atomic_store(&o->rec->owned, 0);
+    }
+    free(o);
+    o = next;
+  }
+  pthread_mutex_unlock(&registry_lock);
+}
+
+static void make_owned_key(void) {
+  owned_key_ok = pthread_key_create(&owned_key, release_records) == 0;
+}
+
+// Remembers rec for release at thread exit, dropping entries of freed
+// queues on the way. -1 if the bookkeeping cannot be allocated.
+static int remember_record(MsQueue *q, struct hp_record *rec) {
+  pthread_once(&owned_key_once, make_owned_key);
+  if (!owned_key_ok)
+    return -1;
+  OwnedRecord *o = malloc(sizeof *o);
+  if (o == NULL)
+    return -1;
+  pthread_mutex_lock(&registry_lock);
+  OwnedRecord *head = pthread_getspecific(owned_key), **link = &head;
+  while (*link != NULL) {
+    OwnedRecord *cur = *link;
+    if (queue_alive(cur->q, cur->queue_id)) {
+      link = &cur->next;
+    } else {
+      *link = cur->next;
+      free(cur);
+    }
+  }
+  pthread_mutex_unlock(&registry_lock);
+  *o = (OwnedRecord){.q = q, .queue_id = q->id, .rec = rec, .next = head};
+  if (pthread_setspecific(owned_key, o) != 0) {
+    pthread_setspecific(owned_key, head);
+    free(o);
+    return -1;
+  }
+  return 0;
+}
+
+static struct hp_record *hp_claim(MsQueue *q) {
+  for (size_t i = 0; i < MSQ_MAX_THREADS; ++i) {
+    struct hp_record *rec = &q->records[i];
+    int expected = 0;
+    if (atomic_load_explicit(&rec->owned, memory_order_relaxed) ||
+        !atomic_compare_exchange_strong(&rec->owned, &expected, 1))
+      continue;
+    if (rec->retired == NULL)
+      rec->retired = malloc(HP_RETIRE_MAX * sizeof(QueueNode *));
+    if (rec->retired == NULL || remember_record(q, rec) != 0) {
+      atomic_store(&rec->owned, 0);
+      return NULL;
+    }
+    atomic_store(&rec->owner, hp_thread_id);
+    size_t used = atomic_load(&q->records_used);
+    while (used < i + 1 &&
+           !atomic_compare_exchange_weak(&q->records_used, &used, i + 1))
+      ;
+    return rec;
+  }
+  return NULL; // more than MSQ_MAX_THREADS live threads
+}
+
+static struct hp_record *hp_self(MsQueue *q) {
+  size_t c = q->id % HP_CACHE;
+  if (hp_cache[c].id == q->id)
+    return hp_cache[c].rec;
+
+  if (hp_thread_id == 0)
+    hp_thread_id = atomic_fetch_add(&next_thread_id, 1);
+  struct hp_record *rec = NULL;
+  size_t used = atomic_load(&q->records_used);
+  for (size_t i = 0; i < used && rec == NULL; ++i)
+    if (atomic_load_explicit(&q->records[i].owner, memory_order_relaxed) ==
+        hp_thread_id)
+      rec = &q->records[i];
+  if (rec == NULL && (rec = hp_claim(q)) == NULL)
+    return NULL;
+  hp_cache[c].id = q->id;
+  hp_cache[c].rec = rec;
+  return rec;
+}
+
+// Publishes *src in slot i and returns it once the value is stable.
+static QueueNode *hp_protect(struct hp_record *rec, int i,
+                             _Atomic(QueueNode *) *src) {
+  QueueNode *p = atomic_load(src);
+  for (;;) {
+    atomic_store(&rec->hp[i], p);
+    QueueNode *again = atomic_load(src);
+    if (again == p)
+      return p;
+    p = again;
+  }
+}
+
+static void hp_clear(struct hp_record *rec) {
+  for (int i = 0; i < HP_PER_THREAD; ++i)
+    atomic_store_explicit(&rec->hp[i], NULL, memory_order_release);
+}
+
+static int hp_is_protected(MsQueue *q, size_t used, QueueNode *node) {
+  for (size_t r = 0; r < used; ++r)
+    for (int i = 0; i < HP_PER_THREAD; ++i)
+      if (atomic_load(&q->records[r].hp[i]) == node)
+        return 1;
+  return 0;
+}
+
+// Frees every retired node that no hazard slot points at.
+static void hp_scan(MsQueue *q, struct hp_record *rec) {
+  size_t used = atomic_load(&q->records_used);
+  size_t kept = 0;
+  for (size_t i = 0; i < rec->nretired; ++i) {
+    QueueNode *node = rec->retired[i];
+    if (hp_is_protected(q, used, node))
+      rec->retired[kept++] = node;
+    else
+      free_queue_node(node);
+  }
+  rec->nretired = kept;
+}
+
+// At most used * HP_PER_THREAD nodes survive a scan, so there is always room.
+static void hp_retire(MsQueue *q, struct hp_record *rec, QueueNode *node) {
+  rec->retired[rec->nretired++] = node;
+  if (rec->nretired == HP_RETIRE_MAX)
+    hp_scan(q, rec);
+}
+
+MsQueue *create_ms_queue(size_t max_payload) {
+  size_t bytes = (sizeof(MsQueue) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+  MsQueue *q = aligned_alloc(CACHE_LINE, bytes);
+  if (q == NULL)
+    return NULL;
+  memset(q, 0, bytes);
+  QueueNode *dummy = create_queue_reference_node(NULL, 0);
+  if (dummy == NULL) {
+    free(q);
+    return NULL;
+  }
+  atomic_init(&q->head, dummy);
+  atomic_init(&q->tail, dummy);
+  atomic_init(&q->records_used, 0);
+  for (size_t i = 0; i < MSQ_MAX_THREADS; ++i) {
+    for (int h = 0; h < HP_PER_THREAD; ++h)
+      atomic_init(&q->records[i].hp[h], NULL);
+    atomic_init(&q->records[i].owned, 0);
+    atomic_init(&q->records[i].owner, 0);
+  }
+  q->max_payload = max_payload;
+  q->id = atomic_fetch_add(&next_queue_id, 1);
+  pthread_mutex_lock(&registry_lock);
+  q->next_live = live_queues;
+  live_queues = q;
+  pthread_mutex_unlock(&registry_lock);
+  return q;
+}
+
+// Appends the private chain first..last.
+static int msq_push_chain(MsQueue *q, QueueNode *first, QueueNode *last) {
+  struct hp_record *rec = hp_self(q);
+  if (rec == NULL)
+    return -1;
+  atomic_store_explicit(&last->next, NULL, memory_order_relaxed);
+  for (;;) {
+    QueueNode *t = hp_protect(rec, 0, &q->tail);
+    QueueNode *next = atomic_load(&t->next);
+    if (t != atomic_load(&q->tail))
+      continue;
+    if (next != NULL) {
+      // tail is lagging: help it forward
+      atomic_compare_exchange_strong(&q->tail, &t, next);
+      continue;
+    }
+    QueueNode *expected = NULL;
+    if (atomic_compare_exchange_strong(&t->next, &expected, first)) {
+      atomic_compare_exchange_strong(&q->tail, &t, last);
+      break;
+    }
+  }
+  hp_clear(rec);
+  return 0;
+}
+
+int msq_enqueue(MsQueue *q, const void *dt, size_t len) {
+  if (q == NULL || len > q->max_payload)
+    return -1;
+  QueueNode *node = create_queue_node(dt, len);
+  if (node == NULL)
+    return -1;
+  if (msq_push_chain(q, node, node) != 0) {
+    free_queue_node(node);
+    return -1;
+  }
+  return 0;
+}
+
+int msq_enqueue_reference(MsQueue *q, void *dt, size_t len) {
+  if (q == NULL)
+    return -1;
+  QueueNode *node = create_queue_reference_node(dt, len);
+  if (node == NULL)
+    return -1;
+  if (msq_push_chain(q, node, node) != 0) {
+    free_queue_node(node);
+    return -1;
+  }
+  return 0;
+}
+
+static void free_chain(QueueNode *node) {
+  while (node != NULL) {
+    QueueNode *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+    free_queue_node(node);
+    node = next;
+  }
+}
+
+int msq_enqueue_batch(MsQueue *q, const void *const *items, const size_t *lens,
+                      size_t n) {
+  if (q == NULL || (n > 0 && (items == NULL || lens == NULL)))
+    return -1;
+  if (n == 0)
+    return 0;
+  QueueNode *first = NULL, *last = NULL;
+  for (size_t i = 0; i < n; ++i) {
+    QueueNode *node =
+        lens[i] > q->max_payload ? NULL : create_queue_node(items[i], lens[i]);
+    if (node == NULL) {
+      free_chain(first); // all or nothing
+      return -1;
+    }
+    if (last == NULL)
+      first = node;
+    else
+      atomic_store_explicit(&last->next, node, memory_order_relaxed);
+    last = node;
+  }
+  if (msq_push_chain(q, first, last) != 0) {
+    free_chain(first);
+    return -1;
+  }
+  return 0;
+}
+
+int msq_dequeue(MsQueue *q, QueueItem *item, void *buf) {
+  if (q == NULL || item == NULL)
+    return -1;
+  struct hp_record *rec = hp_self(q);
+  if (rec == NULL)
+    return -1;
+  QueueNode *h, *next;
+  for (;;) {
+    h = hp_protect(rec, 0, &q->head);
+    QueueNode *t = atomic_load(&q->tail);
+    next = atomic_load(&h->next);
+    atomic_store(&rec->hp[1], next);
+    if (h != atomic_load(&q->head))
+      continue;
+    if (next == NULL) {
+      hp_clear(rec);
+      return -1; // empty
+    }
+    if (h == t) {
+      atomic_compare_exchange_strong(&q->tail, &t, next);
+      continue;
+    }
+    if (atomic_compare_exchange_strong(&q->head, &h, next))
+      break;
+  }
+
+  // next is the new dummy; hp[1] keeps it alive while the item is read
+  item->data_len = next->data_len;
+  item->data_reference = next->data_reference;
+  if (next->data_reference) {
+    item->data = next->data;
+  } else {
+    if (next->data_len > 0)
+      memcpy(buf, next->payload, next->data_len);
+    item->data = buf;
+  }
+  hp_clear(rec);
+  hp_retire(q, rec, h);
+  return 0;
+}
+
+size_t msq_dequeue_batch(MsQueue *q, QueueItem *items, void *bufs, size_t max) {
+  if (q == NULL)
+    return 0;
+  unsigned char *buf = bufs;
+  size_t n = 0;
+  while (n < max && msq_dequeue(q, &items[n], buf + n * q->max_payload) == 0)
+    n++;
+  return n;
+}
+
+void free_ms_queue(MsQueue *q) {
+  if (q == NULL)
+    return;
+  pthread_mutex_lock(&registry_lock); // exiting threads skip it from now on
+  MsQueue **link = &live_queues;
+  while (*link != NULL && *link != q)
+    link = &(*link)->next_live;
+  if (*link != NULL)
+    *link = q->next_live;
+  pthread_mutex_unlock(&registry_lock);
+  free_chain(atomic_load(&q->head));
+  for (size_t i = 0; i < MSQ_MAX_THREADS; ++i) {
+    struct hp_record *rec = &q->records[i];
+    for (size_t r = 0; r < rec->nretired; ++r)
+      free_queue_node(rec->retired[r]);
+    free(rec->retired);
+  }
+  free(q);
+}
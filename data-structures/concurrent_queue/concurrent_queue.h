@@ -0,0 +1,114 @@
+#ifndef CONCURRENT_QUEUE_H
+#define CONCURRENT_QUEUE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/*
+ * Lock-free work queues built on the linked_list node design.
+ *
+ * Both queues keep linked_list's ownership model: an item is either a copy
+ * of the caller's bytes stored inline in its node (enqueue) or a borrowed
+ * pointer that the queue never frees (enqueue_reference).
+ *
+ *   MpscQueue  Vyukov's intrusive multi-producer / single-consumer queue.
+ *              Producers do one atomic exchange; the consumer gets the node
+ *              itself back (no copy) and may free it, reuse it or push it
+ *              into another queue.
+ *
+ *   MsQueue    Michael-Scott multi-producer / multi-consumer queue with
+ *              hazard-pointer reclamation. The dequeued node stays in the
+ *              queue as the new dummy, so copied payloads are copied out
+ *              into a caller buffer of max_payload bytes.
+ *
+ * Both support batch enqueue (a privately linked chain published with one
+ * atomic operation) and batch dequeue.
+ *
+ * Return values follow linked_list: 0 on success, -1 on failure.
+ */
+
+#ifndef MSQ_MAX_THREADS
+#define MSQ_MAX_THREADS 128 // live threads that may touch one MsQueue
+#endif
+
+typedef struct queue_node QueueNode;
+
+struct queue_node {
+  _Atomic(QueueNode *) next;
+  void *data; // payload (inline) or borrowed pointer
+  size_t data_len;
+  int data_reference;
+  _Alignas(max_align_t) unsigned char payload[];
+};
+
+// A dequeued MsQueue item. For copies, data points into the caller buffer.
+typedef struct {
+  void *data;
+  size_t data_len;
+  int data_reference;
+} QueueItem;
+
+/* -------------------------
+ * Nodes
+ * ------------------------- */
+
+// Node holding a copy of len bytes (one allocation).
+QueueNode *create_queue_node(const void *dt, size_t len);
+
+// Node holding a borrowed pointer.
+QueueNode *create_queue_reference_node(void *dt, size_t len);
+
+void free_queue_node(QueueNode *node);
+
+/* -------------------------
+ * MPSC (Vyukov)
+ * ------------------------- */
+
+typedef struct mpsc_queue MpscQueue;
+
+MpscQueue *create_mpsc_queue(void);
+
+// Producers: any number of threads.
+int mpsc_enqueue(MpscQueue *q, const void *dt, size_t len);
+int mpsc_enqueue_reference(MpscQueue *q, void *dt, size_t len);
+void mpsc_push_node(MpscQueue *q, QueueNode *node);
+
+// Publishes nodes[0..n) in order with a single atomic exchange.
+void mpsc_push_batch(MpscQueue *q, QueueNode **nodes, size_t n);
+
+// Consumer: one thread only. Returns NULL when empty (or when a producer is
+// between its exchange and its link; retry later). The caller owns the node.
+QueueNode *mpsc_dequeue(MpscQueue *q);
+
+// Dequeues up to max nodes into out; returns how many.
+size_t mpsc_dequeue_batch(MpscQueue *q, QueueNode **out, size_t max);
+
+// Frees the queue and any nodes still in it. No concurrent users allowed.
+void free_mpsc_queue(MpscQueue *q);
+
+/* -------------------------
+ * MPMC (Michael-Scott + hazard pointers)
+ * ------------------------- */
+
+typedef struct ms_queue MsQueue;
+
+// Copied payloads are limited to max_payload bytes.
+MsQueue *create_ms_queue(size_t max_payload);
+
+int msq_enqueue(MsQueue *q, const void *dt, size_t len);
+int msq_enqueue_reference(MsQueue *q, void *dt, size_t len);
+
+// Enqueues n copies (lens[i] bytes from items[i]) as one linked chain.
+int msq_enqueue_batch(MsQueue *q, const void *const *items, const size_t *lens,
+                      size_t n);
+
+// Returns 0 and fills item, or -1 when empty. buf must hold max_payload bytes.
+int msq_dequeue(MsQueue *q, QueueItem *item, void *buf);
+
+// Dequeues up to max items; item i uses bufs + i * max_payload.
+size_t msq_dequeue_batch(MsQueue *q, QueueItem *items, void *bufs, size_t max);
+
+// Frees the queue, queued nodes and retired nodes. No concurrent users.
+void free_ms_queue(MsQueue *q);
+
+#endif // CONCURRENT_QUEUE_H
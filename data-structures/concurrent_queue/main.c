@@ -0,0 +1,320 @@
+#include "../linked_list/linked_list.h"
+#include "concurrent_queue.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Producer/consumer throughput:
+ *   - MPSC: P producers, one consumer, single and batched pushes, against a
+ *     mutex-protected LinkedList;
+ *   - MPMC: P producers, C consumers on the Michael-Scott queue, single and
+ *     batched.
+ * Every item is a uint64_t (producer << 32 | sequence). The MPSC consumer
+ * checks that each producer's items arrive in order; all runs check counts
+ * and sums.
+ *
+ * Two hazard-record regression checks run first: one thread alternating
+ * between queues whose ids share a thread-local cache slot, and more than
+ * MSQ_MAX_THREADS short-lived threads using one queue over its lifetime.
+ *
+ * Build: gcc -O2 -pthread main.c concurrent_queue.c ../linked_list/linked_list.c \
+ *        ../node_pool/node_pool.c
+ */
+
+#define PER_PRODUCER 500000
+#define BATCH 32
+#define MAX_PRODUCERS 8
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t expected_sum(int producers) {
+  uint64_t sum = 0;
+  for (uint64_t p = 0; p < (uint64_t)producers; ++p)
+    sum += p * PER_PRODUCER * (1ull << 32) +
+           (uint64_t)PER_PRODUCER * (PER_PRODUCER - 1) / 2;
+  return sum;
+}
+
+typedef struct {
+  void *queue;
+  int id;
+  int batched;
+  pthread_mutex_t *lock;
+  atomic_size_t *consumed; // MPMC consumers
+  size_t total;
+  uint64_t sum;
+} Worker;
+
+/* --- MPSC --- */
+
+static void *mpsc_producer(void *arg) {
+  Worker *w = arg;
+  QueueNode *nodes[BATCH];
+  size_t pending = 0;
+  for (uint64_t i = 0; i < PER_PRODUCER; ++i) {
+    uint64_t v = (uint64_t)w->id << 32 | i;
+    if (!w->batched) {
+      while (mpsc_enqueue(w->queue, &v, sizeof(v)) != 0)
+        ;
+      continue;
+    }
+    while ((nodes[pending] = create_queue_node(&v, sizeof(v))) == NULL)
+      ;
+    if (++pending == BATCH) {
+      mpsc_push_batch(w->queue, nodes, pending);
+      pending = 0;
+    }
+  }
+  mpsc_push_batch(w->queue, nodes, pending);
+  return NULL;
+}
+
+static void *mpsc_consumer(void *arg) {
+  Worker *w = arg;
+  int64_t last[MAX_PRODUCERS];
+  for (int p = 0; p < MAX_PRODUCERS; ++p)
+    last[p] = -1;
+  QueueNode *nodes[BATCH];
+  size_t got = 0;
+  while (got < w->total) {
+    size_t n = mpsc_dequeue_batch(w->queue, nodes, w->batched ? BATCH : 1);
+    for (size_t i = 0; i < n; ++i) {
+      uint64_t v = *(uint64_t *)nodes[i]->data;
+      int p = (int)(v >> 32);
+      assert((int64_t)(v & 0xffffffffu) > last[p]); // per-producer FIFO
+      last[p] = (int64_t)(v & 0xffffffffu);
+      w->sum += v;
+      free_queue_node(nodes[i]);
+    }
+    got += n;
+  }
+  return NULL;
+}
+
+static void *locked_producer(void *arg) {
+  Worker *w = arg;
+  for (uint64_t i = 0; i < PER_PRODUCER; ++i) {
+    uint64_t v = (uint64_t)w->id << 32 | i;
+    pthread_mutex_lock(w->lock);
+    list_append(w->queue, &v, sizeof(v), NULL);
+    pthread_mutex_unlock(w->lock);
+  }
+  return NULL;
+}
+
+static void *locked_consumer(void *arg) {
+  Worker *w = arg;
+  size_t got = 0;
+  while (got < w->total) {
+    pthread_mutex_lock(w->lock);
+    if (list_remove_head(w->queue) == 0)
+      got++;
+    pthread_mutex_unlock(w->lock);
+  }
+  return NULL;
+}
+
+static void run_mpsc(int producers, int mode) {
+  static const char *names[] = {"mutex+LinkedList", "mpsc", "mpsc batch"};
+  pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+  LinkedList *list = NULL;
+  MpscQueue *q = NULL;
+  void *queue;
+  if (mode == 0)
+    queue = list = create_list();
+  else
+    queue = q = create_mpsc_queue();
+  assert(queue);
+
+  Worker w[MAX_PRODUCERS + 1] = {0};
+  pthread_t th[MAX_PRODUCERS + 1];
+  double t0 = now();
+  for (int i = 0; i <= producers; ++i) {
+    w[i] = (Worker){.queue = queue, .id = i, .batched = mode == 2,
+                    .lock = &lock,
+                    .total = (size_t)producers * PER_PRODUCER};
+    void *(*fn)(void *) = i == producers
+                              ? (mode == 0 ? locked_consumer : mpsc_consumer)
+                              : (mode == 0 ? locked_producer : mpsc_producer);
+    pthread_create(&th[i], NULL, fn, &w[i]);
+  }
+  for (int i = 0; i <= producers; ++i)
+    pthread_join(th[i], NULL);
+  double dt = now() - t0;
+
+  if (mode != 0)
+    assert(w[producers].sum == expected_sum(producers));
+  printf("  %-18s %dP/1C: %6.1f Mops/s\n", names[mode], producers,
+         producers * (double)PER_PRODUCER / dt / 1e6);
+  free_list(list);
+  free_mpsc_queue(q);
+}
+
+/* --- MPMC --- */
+
+static void *msq_producer(void *arg) {
+  Worker *w = arg;
+  uint64_t vals[BATCH];
+  const void *items[BATCH];
+  size_t lens[BATCH];
+  for (size_t i = 0; i < BATCH; ++i) {
+    items[i] = &vals[i];
+    lens[i] = sizeof(uint64_t);
+  }
+  for (uint64_t i = 0; i < PER_PRODUCER;) {
+    if (!w->batched) {
+      uint64_t v = (uint64_t)w->id << 32 | i;
+      while (msq_enqueue(w->queue, &v, sizeof(v)) != 0)
+        ;
+      i++;
+      continue;
+    }
+    size_t n = 0;
+    for (; n < BATCH && i < PER_PRODUCER; ++n, ++i)
+      vals[n] = (uint64_t)w->id << 32 | i;
+    while (msq_enqueue_batch(w->queue, items, lens, n) != 0)
+      ;
+  }
+  return NULL;
+}
+
+static void *msq_consumer(void *arg) {
+  Worker *w = arg;
+  QueueItem items[BATCH];
+  uint64_t bufs[BATCH];
+  for (;;) {
+    if (atomic_load_explicit(w->consumed, memory_order_relaxed) >= w->total)
+      break;
+    size_t n = msq_dequeue_batch(w->queue, items, bufs, w->batched ? BATCH : 1);
+    for (size_t i = 0; i < n; ++i)
+      w->sum += *(uint64_t *)items[i].data;
+    if (n > 0)
+      atomic_fetch_add_explicit(w->consumed, n, memory_order_relaxed);
+  }
+  return NULL;
+}
+
+static void run_mpmc(int producers, int consumers, int batched) {
+  MsQueue *q = create_ms_queue(sizeof(uint64_t));
+  assert(q);
+  atomic_size_t consumed = 0;
+  Worker w[2 * MAX_PRODUCERS] = {0};
+  pthread_t th[2 * MAX_PRODUCERS];
+  int n = producers + consumers;
+  double t0 = now();
+  for (int i = 0; i < n; ++i) {
+    w[i] = (Worker){.queue = q, .id = i, .batched = batched,
+                    .consumed = &consumed,
+                    .total = (size_t)producers * PER_PRODUCER};
+    pthread_create(&th[i], NULL, i < producers ? msq_producer : msq_consumer,
+                   &w[i]);
+  }
+  for (int i = 0; i < n; ++i)
+    pthread_join(th[i], NULL);
+  double dt = now() - t0;
+
+  uint64_t sum = 0;
+  for (int i = producers; i < n; ++i)
+    sum += w[i].sum;
+  assert(atomic_load(&consumed) == (size_t)producers * PER_PRODUCER);
+  assert(sum == expected_sum(producers));
+  printf("  %-18s %dP/%dC: %6.1f Mops/s\n", batched ? "msq batch" : "msq",
+         producers, consumers, producers * (double)PER_PRODUCER / dt / 1e6);
+  free_ms_queue(q);
+}
+
+/* --- hazard records --- */
+
+#define ROUNDS 1000
+#define SHORT_LIVED (3 * MSQ_MAX_THREADS)
+
+// q[0] and q[8] map to the same cache slot; each miss must find the
+// record this thread already owns instead of claiming another.
+static void check_colliding_queues(void) {
+  MsQueue *q[9];
+  for (int i = 0; i < 9; ++i) {
+    q[i] = create_ms_queue(sizeof(uint64_t));
+    assert(q[i]);
+  }
+  for (uint64_t r = 0; r < ROUNDS; ++r) {
+    int a = msq_enqueue(q[0], &r, sizeof(r));
+    int b = msq_enqueue(q[8], &r, sizeof(r));
+    assert(a == 0 && b == 0);
+  }
+  QueueItem item;
+  uint64_t buf0, buf8;
+  for (uint64_t r = 0; r < ROUNDS; ++r) {
+    int a = msq_dequeue(q[0], &item, &buf0);
+    int b = msq_dequeue(q[8], &item, &buf8);
+    assert(a == 0 && b == 0 && buf0 == r && buf8 == r);
+  }
+  for (int i = 0; i < 9; ++i)
+    free_ms_queue(q[i]);
+  printf("colliding queues: %d rounds ok\n", ROUNDS);
+}
+
+static void *short_lived(void *arg) {
+  Worker *w = arg;
+  uint64_t v = (uint64_t)w->id, buf;
+  QueueItem item;
+  w->sum = msq_enqueue(w->queue, &v, sizeof(v)) == 0 &&
+           msq_dequeue(w->queue, &item, &buf) == 0;
+  return NULL;
+}
+
+// Exiting threads must hand their records back, or the queue runs out
+// after MSQ_MAX_THREADS of them.
+static void check_short_lived_threads(void) {
+  MsQueue *q = create_ms_queue(sizeof(uint64_t));
+  assert(q);
+  for (int i = 0; i < SHORT_LIVED; i += 4) {
+    Worker w[4] = {0};
+    pthread_t th[4];
+    for (int t = 0; t < 4; ++t) {
+      w[t] = (Worker){.queue = q, .id = i + t};
+      pthread_create(&th[t], NULL, short_lived, &w[t]);
+    }
+    for (int t = 0; t < 4; ++t) {
+      pthread_join(th[t], NULL);
+      assert(w[t].sum == 1);
+    }
+  }
+  free_ms_queue(q);
+  printf("short-lived threads: %d ok\n", SHORT_LIVED);
+}
+
+int main() {
+  check_colliding_queues();
+  check_short_lived_threads();
+
+  // small demo: copied and referenced payloads, nodes handed back intact
+  MpscQueue *q = create_mpsc_queue();
+  char msg[] = "borrowed";
+  int x = 42;
+  mpsc_enqueue(q, &x, sizeof(x));
+  mpsc_enqueue_reference(q, msg, sizeof(msg));
+  QueueNode *a = mpsc_dequeue(q), *b = mpsc_dequeue(q);
+  printf("copied %d, reference \"%s\" (same pointer: %s)\n", *(int *)a->data,
+         (char *)b->data, b->data == msg ? "yes" : "no");
+  free_queue_node(a);
+  free_queue_node(b);
+  free_mpsc_queue(q);
+
+  printf("MPSC (%d items per producer):\n", PER_PRODUCER);
+  for (int p = 1; p <= 4; p *= 2)
+    for (int mode = 0; mode < 3; ++mode)
+      run_mpsc(p, mode);
+
+  printf("MPMC:\n");
+  for (int p = 1; p <= 4; p *= 2)
+    for (int batched = 0; batched < 2; ++batched)
+      run_mpmc(p, p, batched);
+  return 0;
+}
@@ -0,0 +1,162 @@
+#include "deque.h"
+#include "../linked_list/intrusive_list.h"
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The deque is an IntrusiveList whose links are embedded in pool-allocated
+ * nodes, so push/pop/unlink/splice are the intrusive list's O(1) pointer
+ * updates plus one pool allocation or release.
+ */
+
+struct deque_node {
+  ListLink link;
+  alignas(max_align_t) unsigned char payload[];
+};
+
+struct deque {
+  IntrusiveList list;
+  size_t elem_size;
+  size_t node_bytes;
+  NodePool pool;
+};
+
+static DequeNode *node_of(ListLink *link) {
+  return link == NULL ? NULL : list_container_of(link, DequeNode, link);
+}
+
+Deque *create_deque(size_t elem_size, const NodeAllocator *hooks) {
+  if (elem_size == 0 || elem_size > SIZE_MAX / 2)
+    return NULL;
+  Deque *dq = malloc(sizeof(Deque));
+  if (dq == NULL)
+    return NULL;
+  ilist_init(&dq->list);
+  dq->elem_size = elem_size;
+  dq->node_bytes = NODE_POOL_ROUND(sizeof(DequeNode) + elem_size);
+  node_pool_init(&dq->pool, hooks);
+  return dq;
+}
+
+DequeNode *deque_emplace_front(Deque *dq) {
+  if (dq == NULL)
+    return NULL;
+  DequeNode *node = node_pool_alloc(&dq->pool, dq->node_bytes);
+  if (node != NULL)
+    ilist_push_front(&dq->list, &node->link);
+  return node;
+}
+
+DequeNode *deque_emplace_back(Deque *dq) {
+  if (dq == NULL)
+    return NULL;
+  DequeNode *node = node_pool_alloc(&dq->pool, dq->node_bytes);
+  if (node != NULL)
+    ilist_push_back(&dq->list, &node->link);
+  return node;
+}
+
+DequeNode *deque_push_front(Deque *dq, const void *elem) {
+  if (elem == NULL)
+    return NULL;
+  DequeNode *node = deque_emplace_front(dq);
+  if (node != NULL)
+    memcpy(node->payload, elem, dq->elem_size);
+  return node;
+}
+
+DequeNode *deque_push_back(Deque *dq, const void *elem) {
+  if (elem == NULL)
+    return NULL;
+  DequeNode *node = deque_emplace_back(dq);
+  if (node != NULL)
+    memcpy(node->payload, elem, dq->elem_size);
+  return node;
+}
+
+void deque_remove(Deque *dq, DequeNode *node) {
+  ilist_remove(&dq->list, &node->link);
+  node_pool_free(&dq->pool, node, dq->node_bytes);
+}
+
+static int pop(Deque *dq, DequeNode *node, void *out) {
+  if (node == NULL)
+    return -1;
+  if (out != NULL)
+    memcpy(out, node->payload, dq->elem_size);
+  deque_remove(dq, node);
+  return 0;
+}
+
+int deque_pop_front(Deque *dq, void *out) {
+  if (dq == NULL)
+    return -1;
+  return pop(dq, deque_front(dq), out);
+}
+
+int deque_pop_back(Deque *dq, void *out) {
+  if (dq == NULL)
+    return -1;
+  return pop(dq, deque_back(dq), out);
+}
+
+DequeNode *deque_front(Deque *dq) {
+  return dq == NULL ? NULL : node_of(ilist_first(&dq->list));
+}
+
+DequeNode *deque_back(Deque *dq) {
+  return dq == NULL ? NULL : node_of(ilist_last(&dq->list));
+}
+
+DequeNode *deque_next(Deque *dq, DequeNode *node) {
+  return node_of(ilist_next(&dq->list, &node->link));
+}
+
+DequeNode *deque_prev(Deque *dq, DequeNode *node) {
+  ListLink *prev = node->link.prev;
+  return prev == &dq->list.head ? NULL : node_of(prev);
+}
+
+void *deque_data(DequeNode *node) { return node->payload; }
+
+void deque_move_to_front(Deque *dq, DequeNode *node) {
+  if (dq->list.head.next == &node->link)
+    return;
+  ilist_remove(&dq->list, &node->link);
+  ilist_push_front(&dq->list, &node->link);
+}
+
+void deque_move_to_back(Deque *dq, DequeNode *node) {
+  if (dq->list.head.prev == &node->link)
+    return;
+  ilist_remove(&dq->list, &node->link);
+  ilist_push_back(&dq->list, &node->link);
+}
+
+int deque_splice_back(Deque *dst, Deque *src) {
+  if (dst == NULL || src == NULL || dst == src ||
+      dst->elem_size != src->elem_size)
+    return -1;
+  if (node_pool_absorb(&dst->pool, &src->pool) != 0)
+    return -1;
+  ilist_splice_back(&dst->list, &src->list);
+  return 0;
+}
+
+size_t deque_size(const Deque *dq) {
+  return dq == NULL ? 0 : ilist_size(&dq->list);
+}
+
+void free_deque(Deque *dq) {
+  if (dq == NULL)
+    return;
+  if (dq->pool.heap_nodes > 0) {
+    ListLink *link;
+    while ((link = ilist_pop_front(&dq->list)) != NULL)
+      node_pool_free(&dq->pool, node_of(link), dq->node_bytes);
+  }
+  node_pool_destroy(&dq->pool);
+  free(dq);
+}
@@ -0,0 +1,64 @@
+#ifndef DEQUE_H
+#define DEQUE_H
+
+#include "../node_pool/node_pool.h"
+#include <stddef.h>
+
+/*
+ * Doubly linked deque of fixed-size elements.
+ *
+ * Every element is copied into its own node and the node pointer is a stable
+ * handle: it stays valid until that element is removed, so callers (an LRU
+ * index, a timer wheel, ...) can keep it and later unlink or move the node
+ * in O(1) without searching.
+ *
+ * Nodes come from a per-deque NodePool (the same allocator linked_list
+ * uses); pass NodeAllocator hooks to back it with something other than
+ * malloc.
+ *
+ * Return values follow linked_list: 0 on success, -1 on failure.
+ */
+
+typedef struct deque Deque;
+typedef struct deque_node DequeNode;
+
+// hooks may be NULL (malloc/free). NULL on failure.
+Deque *create_deque(size_t elem_size, const NodeAllocator *hooks);
+
+// Copy elem in; return the new node's handle (NULL on failure).
+DequeNode *deque_push_front(Deque *dq, const void *elem);
+DequeNode *deque_push_back(Deque *dq, const void *elem);
+
+// Like push, but leaves the element uninitialised for the caller to fill
+// through deque_data (saves building it in a temporary first).
+DequeNode *deque_emplace_front(Deque *dq);
+DequeNode *deque_emplace_back(Deque *dq);
+
+// Remove an end element, copying it to out when out is not NULL.
+int deque_pop_front(Deque *dq, void *out);
+int deque_pop_back(Deque *dq, void *out);
+
+// Ends and neighbours; NULL past either end.
+DequeNode *deque_front(Deque *dq);
+DequeNode *deque_back(Deque *dq);
+DequeNode *deque_next(Deque *dq, DequeNode *node);
+DequeNode *deque_prev(Deque *dq, DequeNode *node);
+
+// The element stored in node.
+void *deque_data(DequeNode *node);
+
+// O(1) operations on a node that belongs to dq.
+void deque_remove(Deque *dq, DequeNode *node);
+void deque_move_to_front(Deque *dq, DequeNode *node);
+void deque_move_to_back(Deque *dq, DequeNode *node);
+
+// Moves every element of src to the back of dst in O(1): the nodes are
+// relinked and src's node memory is spliced over by node_pool_absorb. Both
+// deques must have the same elem_size and allocator hooks. src is left empty.
+int deque_splice_back(Deque *dst, Deque *src);
+
+size_t deque_size(const Deque *dq);
+
+void free_deque(Deque *dq);
+
+#endif // DEQUE_H
@@ -0,0 +1,196 @@
+#include "lru_cache.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Entry layout inside a deque element:
+ *   uint64_t hash | key (key_size bytes) | value at value_offset
+ * The cached hash makes probing compare keys only on a full hash match and
+ * lets deletion shift entries back without rehashing keys.
+ */
+
+#define VALUE_ALIGN 16
+
+struct lru_cache {
+  Deque *order; // front = most recently used
+  DequeNode **slots;
+  size_t mask; // table size - 1 (a power of two)
+  size_t capacity;
+  size_t key_size;
+  size_t value_size;
+  size_t value_offset;
+  LruEvict evict;
+  void *evict_ctx;
+};
+
+static uint64_t hash_key(const void *key, size_t len) {
+  // FNV-1a with a final avalanche so linear probing sees well-mixed bits
+  const unsigned char *p = key;
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < len; ++i)
+    h = (h ^ p[i]) * 0x100000001b3ull;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  return h;
+}
+
+static uint64_t entry_hash(DequeNode *node) {
+  return *(uint64_t *)deque_data(node);
+}
+
+static void *entry_key(DequeNode *node) {
+  return (unsigned char *)deque_data(node) + sizeof(uint64_t);
+}
+
+static void *entry_value(const LruCache *cache, DequeNode *node) {
+  return (unsigned char *)deque_data(node) + cache->value_offset;
+}
+
+LruCache *lru_create(size_t key_size, size_t value_size, size_t capacity,
+                     const NodeAllocator *hooks) {
+  if (key_size == 0 || capacity == 0 || capacity > SIZE_MAX / 4 ||
+      key_size > SIZE_MAX / 4 || value_size > SIZE_MAX / 4)
+    return NULL;
+  LruCache *cache = calloc(1, sizeof(LruCache));
+  if (cache == NULL)
+    return NULL;
+  cache->key_size = key_size;
+  cache->value_size = value_size;
+  cache->capacity = capacity;
+  cache->value_offset = (sizeof(uint64_t) + key_size + VALUE_ALIGN - 1) &
+                        ~(size_t)(VALUE_ALIGN - 1);
+  size_t table = 2;
+  while (table < 2 * capacity)
+    table *= 2;
+  cache->mask = table - 1;
+  cache->slots = calloc(table, sizeof(DequeNode *));
+  cache->order = create_deque(cache->value_offset + value_size, hooks);
+  if (cache->slots == NULL || cache->order == NULL) {
+    lru_destroy(cache);
+    return NULL;
+  }
+  return cache;
+}
+
+void lru_set_evict(LruCache *cache, LruEvict evict, void *ctx) {
+  if (cache == NULL)
+    return;
+  cache->evict = evict;
+  cache->evict_ctx = ctx;
+}
+
+// Slot holding key, or the empty slot where it would go.
+static size_t probe(const LruCache *cache, const void *key, uint64_t h) {
+  size_t i = (size_t)h & cache->mask;
+  for (;;) {
+    DequeNode *node = cache->slots[i];
+    if (node == NULL ||
+        (entry_hash(node) == h &&
+         memcmp(entry_key(node), key, cache->key_size) == 0))
+      return i;
+    i = (i + 1) & cache->mask;
+  }
+}
+
+// Empties slot i and shifts later entries of the probe run back into it.
+static void clear_slot(LruCache *cache, size_t i) {
+  cache->slots[i] = NULL;
+  size_t j = i;
+  for (;;) {
+    j = (j + 1) & cache->mask;
+    DequeNode *node = cache->slots[j];
+    if (node == NULL)
+      return;
+    size_t home = (size_t)entry_hash(node) & cache->mask;
+    // node may move to i only if i lies on its probe path home..j
+    int movable = i <= j ? (home <= i || home > j) : (home <= i && home > j);
+    if (movable) {
+      cache->slots[i] = node;
+      cache->slots[j] = NULL;
+      i = j;
+    }
+  }
+}
+
+void *lru_peek(LruCache *cache, const void *key) {
+  if (cache == NULL || key == NULL)
+    return NULL;
+  DequeNode *node =
+      cache->slots[probe(cache, key, hash_key(key, cache->key_size))];
+  return node == NULL ? NULL : entry_value(cache, node);
+}
+
+void *lru_get(LruCache *cache, const void *key) {
+  if (cache == NULL || key == NULL)
+    return NULL;
+  DequeNode *node =
+      cache->slots[probe(cache, key, hash_key(key, cache->key_size))];
+  if (node == NULL)
+    return NULL;
+  deque_move_to_front(cache->order, node);
+  return entry_value(cache, node);
+}
+
+static void drop(LruCache *cache, DequeNode *node) {
+  clear_slot(cache, probe(cache, entry_key(node), entry_hash(node)));
+  deque_remove(cache->order, node);
+}
+
+int lru_put(LruCache *cache, const void *key, const void *value) {
+  if (cache == NULL || key == NULL || (value == NULL && cache->value_size))
+    return -1;
+  uint64_t h = hash_key(key, cache->key_size);
+  size_t i = probe(cache, key, h);
+  DequeNode *node = cache->slots[i];
+  if (node != NULL) {
+    if (cache->value_size > 0)
+      memcpy(entry_value(cache, node), value, cache->value_size);
+    deque_move_to_front(cache->order, node);
+    return 0;
+  }
+
+  if (deque_size(cache->order) == cache->capacity) {
+    DequeNode *victim = deque_back(cache->order);
+    if (cache->evict != NULL)
+      cache->evict(entry_key(victim), entry_value(cache, victim),
+                   cache->evict_ctx);
+    drop(cache, victim); // its node is recycled by the push below
+    i = probe(cache, key, h);
+  }
+
+  node = deque_emplace_front(cache->order);
+  if (node == NULL)
+    return -1;
+  *(uint64_t *)deque_data(node) = h;
+  memcpy(entry_key(node), key, cache->key_size);
+  if (cache->value_size > 0)
+    memcpy(entry_value(cache, node), value, cache->value_size);
+  cache->slots[i] = node;
+  return 0;
+}
+
+int lru_remove(LruCache *cache, const void *key) {
+  if (cache == NULL || key == NULL)
+    return -1;
+  size_t i = probe(cache, key, hash_key(key, cache->key_size));
+  DequeNode *node = cache->slots[i];
+  if (node == NULL)
+    return -1;
+  clear_slot(cache, i);
+  deque_remove(cache->order, node);
+  return 0;
+}
+
+size_t lru_size(const LruCache *cache) {
+  return cache == NULL ? 0 : deque_size(cache->order);
+}
+
+void lru_destroy(LruCache *cache) {
+  if (cache == NULL)
+    return;
+  free_deque(cache->order);
+  free(cache->slots);
+  free(cache);
+}
@@ -0,0 +1,48 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include "deque.h"
+#include <stddef.h>
+
+/*
+ * Fixed-capacity LRU cache on top of Deque.
+ *
+ * Entries (hash, key, value) live in deque nodes ordered from most to least
+ * recently used; an open-addressing hash table (linear probing, backward
+ * shift deletion, sized to at most 50% load) maps keys to node handles.
+ * get, put and remove are O(1) expected; a hit moves its node to the front
+ * and a put into a full cache evicts the back node.
+ *
+ * Keys and values are fixed-size byte strings; keys compare with memcmp.
+ *
+ * Return values follow linked_list: 0 on success, -1 on failure.
+ */
+
+typedef struct lru_cache LruCache;
+
+// Called with the entry being evicted by lru_put (not by lru_remove).
+typedef void (*LruEvict)(const void *key, void *value, void *ctx);
+
+// hooks may be NULL (malloc/free). NULL on failure.
+LruCache *lru_create(size_t key_size, size_t value_size, size_t capacity,
+                     const NodeAllocator *hooks);
+
+void lru_set_evict(LruCache *cache, LruEvict evict, void *ctx);
+
+// Value stored under key (marked most recently used), or NULL.
+void *lru_get(LruCache *cache, const void *key);
+
+// Like lru_get but leaves the recency order alone.
+void *lru_peek(LruCache *cache, const void *key);
+
+// Inserts or overwrites key, making it the most recently used entry.
+int lru_put(LruCache *cache, const void *key, const void *value);
+
+// Returns -1 if key is absent.
+int lru_remove(LruCache *cache, const void *key);
+
+size_t lru_size(const LruCache *cache);
+
+void lru_destroy(LruCache *cache);
+
+#endif // LRU_CACHE_H
@@ -0,0 +1,99 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include "deque.h"
+#include "lru_cache.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Deque demo, then an LRU cache driven by a skewed key stream: 80% of the
+ * requests go to 20% of the keys. Misses are "loaded" and inserted, so the
+ * hit ratio shows how well the cache holds the hot set.
+ *
+ * Build: gcc -O2 main.c deque.c lru_cache.c ../node_pool/node_pool.c
+ */
+
+#define KEYS 1000000
+#define CAPACITY 250000
+#define REQUESTS 5000000
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t xorshift(uint64_t *s) {
+  *s ^= *s << 13;
+  *s ^= *s >> 7;
+  *s ^= *s << 17;
+  return *s;
+}
+
+typedef struct {
+  uint64_t payload[4];
+} Value;
+
+static void count_evict(const void *key, void *value, void *ctx) {
+  (void)key;
+  (void)value;
+  ++*(size_t *)ctx;
+}
+
+static void bench_lru(void) {
+  LruCache *cache = lru_create(sizeof(uint64_t), sizeof(Value), CAPACITY, NULL);
+  assert(cache);
+  size_t evictions = 0;
+  lru_set_evict(cache, count_evict, &evictions);
+
+  uint64_t seed = 88172645463325252ull;
+  size_t hits = 0;
+  double t0 = now();
+  for (int i = 0; i < REQUESTS; ++i) {
+    uint64_t r = xorshift(&seed);
+    uint64_t key = (r >> 60) < 13 ? r % (KEYS / 5) // hot fifth, ~80%
+                                  : KEYS / 5 + r % (KEYS - KEYS / 5);
+    Value *v = lru_get(cache, &key);
+    if (v != NULL) {
+      assert(v->payload[0] == key);
+      hits++;
+    } else {
+      Value fresh = {{key, key * 2, key * 3, key * 4}};
+      lru_put(cache, &key, &fresh);
+    }
+  }
+  double dt = now() - t0;
+  assert(lru_size(cache) == CAPACITY);
+  assert(evictions == REQUESTS - hits - CAPACITY);
+  printf("lru (%d slots, %d keys): %.1f%% hits, %.2f Mops/s, %zu evictions\n",
+         CAPACITY, KEYS, 100.0 * hits / REQUESTS, REQUESTS / dt / 1e6,
+         evictions);
+  lru_destroy(cache);
+}
+
+int main() {
+  // small demo: both ends, O(1) unlink and move-to-front by handle, splice
+  Deque *a = create_deque(sizeof(int), NULL);
+  Deque *b = create_deque(sizeof(int), NULL);
+  DequeNode *handles[6];
+  for (int i = 0; i < 6; ++i)
+    handles[i] = deque_push_back(a, &i);
+  deque_remove(a, handles[2]);
+  deque_move_to_front(a, handles[4]);
+  int x = 100;
+  deque_push_front(b, &x);
+  deque_splice_back(a, b);
+  int front, back;
+  deque_pop_front(a, &front);
+  deque_pop_back(a, &back);
+  printf("front %d, back %d, left:", front, back);
+  for (DequeNode *n = deque_front(a); n != NULL; n = deque_next(a, n))
+    printf(" %d", *(int *)deque_data(n));
+  printf(" (b has %zu)\n", deque_size(b));
+  free_deque(a);
+  free_deque(b);
+
+  bench_lru();
+  return 0;
+}
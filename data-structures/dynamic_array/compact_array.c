@@ -0,0 +1,314 @@
+// src/compact_array.c
+#include "compact_array.h"
+
+#include <limits.h>
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Implementation notes / invariants:
+ *  - A CompactArray is a 24-byte header followed by inline_cap * elem_size
+ *    bytes of inline storage in the same block.
+ *  - data == inline_buf while the array is inline; otherwise data is a heap
+ *    block owned by the array.
+ *  - A slab is a list of chunks, each holding `per_chunk` fixed-size array
+ *    blocks. A free block has CPA_FLAG_FREE set and links to the next free
+ *    block through its `data` field.
+ */
+
+#define CPA_FLAG_SLAB 0x1u /* block belongs to a slab */
+#define CPA_FLAG_FREE 0x2u /* block sits on the slab free list */
+
+/* Target chunk size for slabs; at least one block per chunk. */
+#define CPA_SLAB_CHUNK_BYTES (64u * 1024u)
+
+struct CompactArray {
+  void *data;         /* inline_buf or heap block */
+  uint32_t size;      /* number of elements currently stored */
+  uint32_t capacity;  /* capacity in elements */
+  uint32_t elem_size; /* element size in bytes */
+  uint16_t inline_cap; /* inline capacity in elements */
+  uint16_t flags;      /* CPA_FLAG_* */
+  alignas(8) unsigned char inline_buf[];
+};
+
+typedef struct slab_chunk {
+  struct slab_chunk *next;
+  alignas(8) unsigned char blocks[];
+} slab_chunk;
+
+struct CompactSlab {
+  slab_chunk *chunks;
+  CompactArray *free_list;
+  size_t block_bytes; /* header + inline bytes, rounded to 8 */
+  size_t per_chunk;   /* blocks per chunk */
+  size_t nchunks;
+  uint32_t elem_size;
+  uint16_t inline_cap;
+};
+
+/* Helper: check multiplication overflow for a * b */
+static inline bool mul_overflow_size_t(size_t a, size_t b) {
+  if (a == 0 || b == 0)
+    return false;
+  return a > SIZE_MAX / b;
+}
+
+static inline bool is_inline(const CompactArray *a) {
+  return a->data == a->inline_buf;
+}
+
+/* Validate a shape and compute the block size; 0 on invalid input. */
+static size_t block_bytes_for(size_t elem_size, size_t inline_cap) {
+  if (elem_size == 0 || elem_size > UINT32_MAX || inline_cap > UINT16_MAX)
+    return 0;
+  if (mul_overflow_size_t(elem_size, inline_cap))
+    return 0;
+  size_t inline_bytes = elem_size * inline_cap;
+  if (inline_bytes > SIZE_MAX - sizeof(CompactArray) - 7)
+    return 0;
+  return (sizeof(CompactArray) + inline_bytes + 7) & ~(size_t)7;
+}
+
+static void init_header(CompactArray *a, size_t elem_size, size_t inline_cap,
+                        uint16_t flags) {
+  a->data = a->inline_buf;
+  a->size = 0;
+  a->capacity = (uint32_t)inline_cap;
+  a->elem_size = (uint32_t)elem_size;
+  a->inline_cap = (uint16_t)inline_cap;
+  a->flags = flags;
+}
+
+CompactArray *cpa_create(size_t elem_size, size_t inline_cap) {
+  size_t bytes = block_bytes_for(elem_size, inline_cap);
+  if (!bytes)
+    return NULL;
+  CompactArray *a = malloc(bytes);
+  if (!a)
+    return NULL;
+  init_header(a, elem_size, inline_cap, 0);
+  return a;
+}
+
+void cpa_destroy(CompactArray *a) {
+  if (!a || (a->flags & CPA_FLAG_SLAB))
+    return; /* slab blocks are released through cpa_slab_free */
+  if (!is_inline(a))
+    free(a->data);
+  free(a);
+}
+
+/* -------------------------
+ * Slab
+ * ------------------------- */
+
+CompactSlab *cpa_slab_create(size_t elem_size, size_t inline_cap) {
+  size_t bytes = block_bytes_for(elem_size, inline_cap);
+  if (!bytes)
+    return NULL;
+  CompactSlab *slab = malloc(sizeof(*slab));
+  if (!slab)
+    return NULL;
+  slab->chunks = NULL;
+  slab->free_list = NULL;
+  slab->block_bytes = bytes;
+  slab->per_chunk = bytes < CPA_SLAB_CHUNK_BYTES ? CPA_SLAB_CHUNK_BYTES / bytes
+                                                 : 1;
+  slab->nchunks = 0;
+  slab->elem_size = (uint32_t)elem_size;
+  slab->inline_cap = (uint16_t)inline_cap;
+  return slab;
+}
+
+static CompactArray *block_at(const CompactSlab *slab, slab_chunk *c,
+                              size_t i) {
+  return (CompactArray *)(c->blocks + i * slab->block_bytes);
+}
+
+/* Allocate a new chunk and thread all its blocks onto the free list. */
+static int slab_grow(CompactSlab *slab) {
+  if (mul_overflow_size_t(slab->per_chunk, slab->block_bytes))
+    return DYN_ERR_OVERFLOW;
+  slab_chunk *c = malloc(sizeof(*c) + slab->per_chunk * slab->block_bytes);
+  if (!c)
+    return DYN_ERR_OOM;
+  c->next = slab->chunks;
+  slab->chunks = c;
+  ++slab->nchunks;
+
+  /* push in reverse so allocation walks the chunk front to back */
+  for (size_t i = slab->per_chunk; i-- > 0;) {
+    CompactArray *b = block_at(slab, c, i);
+    b->flags = CPA_FLAG_SLAB | CPA_FLAG_FREE;
+    b->data = slab->free_list;
+    slab->free_list = b;
+  }
+  return DYN_OK;
+}
+
+CompactArray *cpa_slab_alloc(CompactSlab *slab) {
+  if (!slab)
+    return NULL;
+  if (!slab->free_list && slab_grow(slab) != DYN_OK)
+    return NULL;
+  CompactArray *a = slab->free_list;
+  slab->free_list = a->data;
+  init_header(a, slab->elem_size, slab->inline_cap, CPA_FLAG_SLAB);
+  return a;
+}
+
+void cpa_slab_free(CompactSlab *slab, CompactArray *a) {
+  if (!slab || !a)
+    return;
+  if (!is_inline(a))
+    free(a->data);
+  a->flags = CPA_FLAG_SLAB | CPA_FLAG_FREE;
+  a->data = slab->free_list;
+  slab->free_list = a;
+}
+
+void cpa_slab_destroy(CompactSlab *slab) {
+  if (!slab)
+    return;
+  slab_chunk *c = slab->chunks;
+  while (c) {
+    slab_chunk *next = c->next;
+    for (size_t i = 0; i < slab->per_chunk; ++i) {
+      CompactArray *a = block_at(slab, c, i);
+      if (!(a->flags & CPA_FLAG_FREE) && !is_inline(a))
+        free(a->data);
+    }
+    free(c);
+    c = next;
+  }
+  free(slab);
+}
+
+size_t cpa_slab_bytes(const CompactSlab *slab) {
+  if (!slab)
+    return 0;
+  return slab->nchunks *
+         (sizeof(slab_chunk) + slab->per_chunk * slab->block_bytes);
+}
+
+/* -------------------------
+ * Observers
+ * ------------------------- */
+
+size_t cpa_size(const CompactArray *a) { return a ? a->size : 0; }
+size_t cpa_capacity(const CompactArray *a) { return a ? a->capacity : 0; }
+size_t cpa_elem_size(const CompactArray *a) { return a ? a->elem_size : 0; }
+size_t cpa_inline_capacity(const CompactArray *a) {
+  return a ? a->inline_cap : 0;
+}
+void *cpa_data(CompactArray *a) { return a ? a->data : NULL; }
+const void *cpa_cdata(const CompactArray *a) { return a ? a->data : NULL; }
+
+void cpa_clear(CompactArray *a) {
+  if (a)
+    a->size = 0;
+}
+
+/* -------------------------
+ * Capacity management
+ * ------------------------- */
+
+int cpa_reserve(CompactArray *a, size_t min_capacity) {
+  if (!a)
+    return DYN_ERR_INVAL;
+  if (min_capacity <= a->capacity)
+    return DYN_OK;
+  if (min_capacity > UINT32_MAX)
+    return DYN_ERR_OVERFLOW;
+
+  /* doubling, clamped to the 32-bit limit */
+  uint64_t new_cap = a->capacity ? a->capacity : 1;
+  while (new_cap < min_capacity)
+    new_cap *= 2;
+  if (new_cap > UINT32_MAX)
+    new_cap = UINT32_MAX;
+
+  if (mul_overflow_size_t((size_t)new_cap, a->elem_size))
+    return DYN_ERR_OVERFLOW;
+  size_t new_bytes = (size_t)new_cap * a->elem_size;
+
+  if (is_inline(a)) {
+    void *heap = malloc(new_bytes);
+    if (!heap)
+      return DYN_ERR_OOM;
+    memcpy(heap, a->inline_buf, (size_t)a->size * a->elem_size);
+    a->data = heap;
+  } else {
+    void *tmp = realloc(a->data, new_bytes);
+    if (!tmp)
+      return DYN_ERR_OOM;
+    a->data = tmp;
+  }
+  a->capacity = (uint32_t)new_cap;
+  return DYN_OK;
+}
+
+int cpa_shrink_to_fit(CompactArray *a) {
+  if (!a)
+    return DYN_ERR_INVAL;
+  if (is_inline(a))
+    return DYN_OK;
+
+  if (a->size <= a->inline_cap) {
+    /* move back into inline storage */
+    memcpy(a->inline_buf, a->data, (size_t)a->size * a->elem_size);
+    free(a->data);
+    a->data = a->inline_buf;
+    a->capacity = a->inline_cap;
+    return DYN_OK;
+  }
+
+  void *tmp = realloc(a->data, (size_t)a->size * a->elem_size);
+  if (!tmp)
+    return DYN_ERR_OOM;
+  a->data = tmp;
+  a->capacity = a->size;
+  return DYN_OK;
+}
+
+/* -------------------------
+ * Element insertion / access
+ * ------------------------- */
+
+int cpa_push_back(CompactArray *a, const void *elem) {
+  if (!a || !elem)
+    return DYN_ERR_INVAL;
+  if (a->size == UINT32_MAX)
+    return DYN_ERR_OVERFLOW;
+  if (a->size >= a->capacity) {
+    int st = cpa_reserve(a, (size_t)a->size + 1);
+    if (st != DYN_OK)
+      return st;
+  }
+  unsigned char *base = a->data;
+  memcpy(base + (size_t)a->size * a->elem_size, elem, a->elem_size);
+  ++a->size;
+  return DYN_OK;
+}
+
+int cpa_pop_back(CompactArray *a, void *out) {
+  if (!a)
+    return DYN_ERR_INVAL;
+  if (a->size == 0)
+    return DYN_ERR_RANGE;
+  --a->size;
+  if (out) {
+    unsigned char *base = a->data;
+    memcpy(out, base + (size_t)a->size * a->elem_size, a->elem_size);
+  }
+  return DYN_OK;
+}
+
+void *cpa_back(CompactArray *a) {
+  if (!a || a->size == 0)
+    return NULL;
+  unsigned char *base = a->data;
+  return base + (size_t)(a->size - 1) * a->elem_size;
+}
@@ -0,0 +1,113 @@
+// include/compact_array.h
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dynamic_array.h" /* da_status */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file compact_array.h
+ * @brief Dynamic array with a 24-byte header for programs holding millions of
+ * small arrays.
+ *
+ * Differences from DynamicArray:
+ *  - size, capacity and elem_size are 32-bit fields, so an array holds at most
+ *    UINT32_MAX elements of at most UINT32_MAX bytes. Operations that would
+ *    exceed that return DYN_ERR_OVERFLOW; use DynamicArray for larger data.
+ *  - The inline (SBO) capacity is chosen per array at creation instead of the
+ *    fixed DA_INLINE_BYTES, and it lives right after the header in the same
+ *    block. Inline storage is 8-byte aligned.
+ *  - Arrays of one shape can be carved out of a CompactSlab: one system
+ *    allocation serves thousands of arrays, with no per-array malloc header.
+ *
+ * For a million 4-int arrays this is 40 bytes per array from a slab, versus
+ * roughly 300 bytes (struct + malloc header) per DynamicArray.
+ *
+ * Thread-safety: not thread-safe, including the slab.
+ */
+
+typedef struct CompactArray CompactArray;
+typedef struct CompactSlab CompactSlab;
+
+/* -------------------------
+ * Construction / Destruction
+ * ------------------------- */
+
+/**
+ * @brief Create a standalone compact array (one malloc).
+ *
+ * @param elem_size Element size in bytes (1 .. UINT32_MAX).
+ * @param inline_cap Elements stored inline before the first heap allocation
+ *        (0 .. UINT16_MAX). 0 means the first push allocates.
+ * @return New array or NULL on error.
+ */
+CompactArray *cpa_create(size_t elem_size, size_t inline_cap);
+
+/**
+ * @brief Destroy an array created by cpa_create(). Passing NULL is safe.
+ *
+ * Arrays obtained from a slab must be released with cpa_slab_free() instead.
+ */
+void cpa_destroy(CompactArray *a);
+
+/**
+ * @brief Create a slab that hands out arrays of one shape.
+ *
+ * @param elem_size,inline_cap Shape of every array allocated from the slab.
+ * @return New slab or NULL on error.
+ */
+CompactSlab *cpa_slab_create(size_t elem_size, size_t inline_cap);
+
+/**
+ * @brief Take an empty array from the slab. O(1), no system allocation
+ * unless the current chunk is exhausted.
+ */
+CompactArray *cpa_slab_alloc(CompactSlab *slab);
+
+/**
+ * @brief Return an array to its slab (frees its heap buffer, if any).
+ */
+void cpa_slab_free(CompactSlab *slab, CompactArray *a);
+
+/**
+ * @brief Destroy the slab, every array still allocated from it and their
+ * heap buffers. Passing NULL is safe.
+ */
+void cpa_slab_destroy(CompactSlab *slab);
+
+/**
+ * @brief Bytes the slab holds from the system (chunks only, excluding heap
+ * buffers of arrays that outgrew their inline storage).
+ */
+size_t cpa_slab_bytes(const CompactSlab *slab);
+
+/* -------------------------
+ * Observers
+ * ------------------------- */
+
+size_t cpa_size(const CompactArray *a);
+size_t cpa_capacity(const CompactArray *a);
+size_t cpa_elem_size(const CompactArray *a);
+size_t cpa_inline_capacity(const CompactArray *a);
+void *cpa_data(CompactArray *a);
+const void *cpa_cdata(const CompactArray *a);
+
+/* -------------------------
+ * Modifiers (same semantics as the da_* counterparts)
+ * ------------------------- */
+
+void cpa_clear(CompactArray *a);
+int cpa_reserve(CompactArray *a, size_t min_capacity);
+int cpa_shrink_to_fit(CompactArray *a);
+int cpa_push_back(CompactArray *a, const void *elem);
+int cpa_pop_back(CompactArray *a, void *out);
+void *cpa_back(CompactArray *a);
+
+#ifdef __cplusplus
+}
+#endif
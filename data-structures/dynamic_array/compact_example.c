@@ -0,0 +1,35 @@
+// compact_example.c
+#include "compact_array.h"
+#include <assert.h>
+#include <stdio.h>
+
+#define ARRAYS 1000000
+
+int main(void) {
+  /* a million small int arrays with room for 4 ints inline */
+  CompactSlab *slab = cpa_slab_create(sizeof(int), 4);
+  assert(slab);
+
+  static CompactArray *arrays[ARRAYS];
+  for (int i = 0; i < ARRAYS; ++i) {
+    arrays[i] = cpa_slab_alloc(slab);
+    assert(arrays[i]);
+    for (int j = 0; j < 3; ++j) {
+      int v = i + j;
+      int st = cpa_push_back(arrays[i], &v);
+      assert(st == DYN_OK);
+    }
+  }
+
+  /* one array outgrows its inline storage and moves to the heap */
+  for (int j = 0; j < 100; ++j)
+    cpa_push_back(arrays[0], &j);
+  assert(cpa_size(arrays[0]) == 103 && cpa_capacity(arrays[0]) >= 103);
+  cpa_slab_free(slab, arrays[0]);
+
+  printf("%d arrays: %zu bytes in slab (%.1f bytes/array)\n", ARRAYS,
+         cpa_slab_bytes(slab), (double)cpa_slab_bytes(slab) / ARRAYS);
+
+  cpa_slab_destroy(slab);
+  return 0;
+}
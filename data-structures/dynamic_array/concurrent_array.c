@@ -0,0 +1,258 @@
+// src/concurrent_array.c
+#include "concurrent_array.h"
+
+#include <limits.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Implementation notes / invariants:
+ *  - Global index i lives in segment k = floor(log2(i + B)) - log2(B), at
+ *    offset (i + B) - 2^floor(log2(i + B)), where B = CDA_FIRST_SEGMENT.
+ *    Segment k therefore holds B << k elements and the table never needs to
+ *    be copied: existing slots never move.
+ *  - A segment is one heap block: [capacity * elem_size data][capacity flags].
+ *    It is allocated lazily by whichever producer first touches it; losers of
+ *    the install race free their block and use the winner's.
+ *  - flag == 1 means the slot has been fully copied. Writers store it with
+ *    release ordering after the memcpy; readers load it with acquire ordering
+ *    before reading the bytes.
+ *  - `next` and `prefix` sit on their own cache lines so that producers
+ *    hammering `next` do not false-share with readers.
+ */
+
+#define CDA_CACHE_LINE 64
+#define CDA_MAX_SEGMENTS (sizeof(size_t) * CHAR_BIT)
+
+#if (CDA_FIRST_SEGMENT & (CDA_FIRST_SEGMENT - 1)) != 0
+#error "CDA_FIRST_SEGMENT must be a power of two"
+#endif
+
+struct ConcurrentArray {
+  alignas(CDA_CACHE_LINE) atomic_size_t next; /* next slot to reserve */
+  alignas(CDA_CACHE_LINE) atomic_size_t prefix; /* published-prefix cache */
+  alignas(CDA_CACHE_LINE) size_t elem_size;
+  unsigned first_shift; /* log2(CDA_FIRST_SEGMENT) */
+  _Atomic(unsigned char *) segments[CDA_MAX_SEGMENTS];
+};
+
+/* Helper: floor(log2(x)) for x > 0. */
+static inline unsigned floor_log2(size_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned)(sizeof(unsigned long long) * CHAR_BIT - 1 -
+                    (unsigned)__builtin_clzll((unsigned long long)x));
+#else
+  unsigned r = 0;
+  while (x >>= 1)
+    ++r;
+  return r;
+#endif
+}
+
+/* Helper: map a global index to (segment, offset). */
+static inline void locate(const ConcurrentArray *ca, size_t index,
+                          unsigned *seg, size_t *offset) {
+  size_t j = index + CDA_FIRST_SEGMENT;
+  unsigned h = floor_log2(j);
+  *seg = h - ca->first_shift;
+  *offset = j - ((size_t)1 << h);
+}
+
+static inline size_t segment_capacity(unsigned seg) {
+  return (size_t)CDA_FIRST_SEGMENT << seg;
+}
+
+static inline _Atomic unsigned char *segment_flags(const ConcurrentArray *ca,
+                                                   unsigned char *block,
+                                                   unsigned seg) {
+  return (_Atomic unsigned char *)(block +
+                                   segment_capacity(seg) * ca->elem_size);
+}
+
+/* Return the segment block, allocating and installing it if needed. */
+static unsigned char *get_or_alloc_segment(ConcurrentArray *ca, unsigned seg) {
+  unsigned char *block =
+      atomic_load_explicit(&ca->segments[seg], memory_order_acquire);
+  if (block)
+    return block;
+
+  size_t cap = segment_capacity(seg);
+  if (cap > SIZE_MAX / (ca->elem_size + 1))
+    return NULL;
+  /* calloc: flags must start at zero (unpublished) */
+  unsigned char *fresh = calloc(cap, ca->elem_size + 1);
+  if (!fresh)
+    return NULL;
+
+  unsigned char *expected = NULL;
+  if (atomic_compare_exchange_strong_explicit(&ca->segments[seg], &expected,
+                                              fresh, memory_order_acq_rel,
+                                              memory_order_acquire))
+    return fresh;
+  free(fresh); /* another producer won the race */
+  return expected;
+}
+
+ConcurrentArray *cda_create(size_t elem_size) {
+  if (elem_size == 0)
+    return NULL;
+
+  /* aligned_alloc requires size to be a multiple of the alignment */
+  size_t bytes = sizeof(ConcurrentArray);
+  bytes = (bytes + CDA_CACHE_LINE - 1) & ~(size_t)(CDA_CACHE_LINE - 1);
+  ConcurrentArray *ca = aligned_alloc(CDA_CACHE_LINE, bytes);
+  if (!ca)
+    return NULL;
+
+  atomic_init(&ca->next, 0);
+  atomic_init(&ca->prefix, 0);
+  ca->elem_size = elem_size;
+  ca->first_shift = floor_log2(CDA_FIRST_SEGMENT);
+  for (size_t k = 0; k < CDA_MAX_SEGMENTS; ++k)
+    atomic_init(&ca->segments[k], NULL);
+  return ca;
+}
+
+void cda_destroy(ConcurrentArray *ca) {
+  if (!ca)
+    return;
+  for (size_t k = 0; k < CDA_MAX_SEGMENTS; ++k)
+    free(atomic_load_explicit(&ca->segments[k], memory_order_relaxed));
+  free(ca);
+}
+
+size_t cda_reserved(const ConcurrentArray *ca) {
+  if (!ca)
+    return 0;
+  return atomic_load_explicit(&((ConcurrentArray *)ca)->next,
+                              memory_order_acquire);
+}
+
+size_t cda_elem_size(const ConcurrentArray *ca) {
+  return ca ? ca->elem_size : 0;
+}
+
+/*
+ * Reserve [first, first + count) with a compare-and-swap on next, which
+ * advances only once the range is known to fit: a rejected reservation
+ * leaves the index space untouched. Fails with DYN_ERR_OVERFLOW if the
+ * index space (index + CDA_FIRST_SEGMENT) would wrap.
+ */
+static int reserve_slots(ConcurrentArray *ca, size_t count, size_t *first) {
+  if (count > SIZE_MAX - CDA_FIRST_SEGMENT)
+    return DYN_ERR_OVERFLOW;
+  size_t start = atomic_load_explicit(&ca->next, memory_order_relaxed);
+  do {
+    if (start > SIZE_MAX - CDA_FIRST_SEGMENT - count)
+      return DYN_ERR_OVERFLOW;
+  } while (!atomic_compare_exchange_weak_explicit(
+      &ca->next, &start, start + count, memory_order_relaxed,
+      memory_order_relaxed));
+  *first = start;
+  return DYN_OK;
+}
+
+int cda_append(ConcurrentArray *ca, const void *elem, size_t *out_index) {
+  return cda_append_n(ca, elem, 1, out_index);
+}
+
+int cda_append_n(ConcurrentArray *ca, const void *elems, size_t count,
+                 size_t *out_first) {
+  if (!ca || (!elems && count))
+    return DYN_ERR_INVAL;
+  if (count == 0) {
+    if (out_first)
+      *out_first = cda_reserved(ca);
+    return DYN_OK;
+  }
+
+  size_t first;
+  int st = reserve_slots(ca, count, &first);
+  if (st != DYN_OK)
+    return st;
+
+  const unsigned char *src = elems;
+  size_t index = first;
+  size_t remaining = count;
+  while (remaining) {
+    unsigned seg;
+    size_t off;
+    locate(ca, index, &seg, &off);
+    unsigned char *block = get_or_alloc_segment(ca, seg);
+    if (!block)
+      return DYN_ERR_OOM;
+
+    /* copy as much as fits in this segment, then publish slot by slot */
+    size_t chunk = segment_capacity(seg) - off;
+    if (chunk > remaining)
+      chunk = remaining;
+    memcpy(block + off * ca->elem_size, src, chunk * ca->elem_size);
+    _Atomic unsigned char *flags = segment_flags(ca, block, seg);
+    for (size_t i = 0; i < chunk; ++i)
+      atomic_store_explicit(&flags[off + i], 1, memory_order_release);
+
+    src += chunk * ca->elem_size;
+    index += chunk;
+    remaining -= chunk;
+  }
+
+  if (out_first)
+    *out_first = first;
+  return DYN_OK;
+}
+
+/* Return the published slot address or NULL. */
+static const unsigned char *published_slot(const ConcurrentArray *ca,
+                                           size_t index) {
+  if (index > SIZE_MAX - CDA_FIRST_SEGMENT)
+    return NULL;
+  unsigned seg;
+  size_t off;
+  locate(ca, index, &seg, &off);
+  unsigned char *block = atomic_load_explicit(
+      &((ConcurrentArray *)ca)->segments[seg], memory_order_acquire);
+  if (!block)
+    return NULL;
+  _Atomic unsigned char *flags = segment_flags(ca, block, seg);
+  if (!atomic_load_explicit(&flags[off], memory_order_acquire))
+    return NULL;
+  return block + off * ca->elem_size;
+}
+
+bool cda_is_published(const ConcurrentArray *ca, size_t index) {
+  return ca && published_slot(ca, index) != NULL;
+}
+
+const void *cda_at(const ConcurrentArray *ca, size_t index) {
+  return ca ? published_slot(ca, index) : NULL;
+}
+
+int cda_get(const ConcurrentArray *ca, size_t index, void *out) {
+  if (!ca || !out)
+    return DYN_ERR_INVAL;
+  const unsigned char *slot = published_slot(ca, index);
+  if (!slot)
+    return DYN_ERR_RANGE;
+  memcpy(out, slot, ca->elem_size);
+  return DYN_OK;
+}
+
+size_t cda_published_prefix(ConcurrentArray *ca) {
+  if (!ca)
+    return 0;
+  size_t start = atomic_load_explicit(&ca->prefix, memory_order_acquire);
+  size_t limit = atomic_load_explicit(&ca->next, memory_order_acquire);
+  size_t n = start;
+  while (n < limit && published_slot(ca, n))
+    ++n;
+
+  /* advance the shared watermark monotonically */
+  size_t cur = start;
+  while (cur < n && !atomic_compare_exchange_weak_explicit(
+                        &ca->prefix, &cur, n, memory_order_release,
+                        memory_order_acquire))
+    ;
+  return n > cur ? n : cur;
+}
@@ -0,0 +1,139 @@
+// include/concurrent_array.h
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dynamic_array.h" /* da_status */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file concurrent_array.h
+ * @brief Lock-free, append-only array for many concurrent producers.
+ *
+ * Key features:
+ *  - Writers reserve slots with an atomic compare-and-swap on the next
+ *    index (retried only under contention) and copy their element in
+ *    without taking a lock.
+ *  - Storage is a table of segments whose sizes double; a segment is never
+ *    moved or reallocated, so pointers to published slots stay valid until
+ *    cda_destroy().
+ *  - Every slot carries a sequence flag. A reader only sees an element once
+ *    its writer has finished copying it (release/acquire publication).
+ *
+ * Thread-safety: cda_append, cda_append_n, cda_get, cda_at, cda_is_published
+ * and the observers may be called concurrently from any number of threads.
+ * cda_create / cda_destroy must not race with any other call.
+ */
+
+/** Capacity (in elements) of the first segment. Must be a power of two.
+ * Segment k holds (CDA_FIRST_SEGMENT << k) elements. */
+#ifndef CDA_FIRST_SEGMENT
+#define CDA_FIRST_SEGMENT 64
+#endif
+
+typedef struct ConcurrentArray ConcurrentArray;
+
+/* -------------------------
+ * Construction / Destruction
+ * ------------------------- */
+
+/**
+ * @brief Create a concurrent append-only array for elements of @p elem_size.
+ *
+ * @param elem_size Size in bytes of a single element (must be > 0).
+ * @return Pointer to a new ConcurrentArray, or NULL on error.
+ */
+ConcurrentArray *cda_create(size_t elem_size);
+
+/**
+ * @brief Destroy the array and every segment it allocated.
+ *
+ * Must only be called once all producers and readers have stopped.
+ * Passing NULL is safe.
+ */
+void cda_destroy(ConcurrentArray *ca);
+
+/* -------------------------
+ * Producers
+ * ------------------------- */
+
+/**
+ * @brief Append one element (copies elem_size bytes from @p elem).
+ *
+ * @param out_index If non-NULL, receives the index of the new element.
+ * @return DYN_OK on success, DYN_ERR_OOM if a segment could not be allocated,
+ *         DYN_ERR_OVERFLOW if the index space is exhausted,
+ *         DYN_ERR_INVAL on invalid arguments.
+ *
+ * Complexity: O(1), one atomic compare-and-swap (retried if another writer
+ * got there first) plus one memcpy. Lock-free.
+ *
+ * If DYN_ERR_OOM is returned the reserved slot stays unpublished forever;
+ * readers will simply never see it.
+ */
+int cda_append(ConcurrentArray *ca, const void *elem, size_t *out_index);
+
+/**
+ * @brief Append @p count contiguous elements with a single reservation.
+ *
+ * Batching amortizes the shared counter across many elements, which is the
+ * way to keep dozens of producers from contending on one cache line.
+ *
+ * @param out_first If non-NULL, receives the index of the first element.
+ * @return Same codes as cda_append().
+ */
+int cda_append_n(ConcurrentArray *ca, const void *elems, size_t count,
+                 size_t *out_first);
+
+/* -------------------------
+ * Readers
+ * ------------------------- */
+
+/**
+ * @brief Number of slots reserved so far (published or not).
+ *
+ * Slots in [0, cda_reserved()) may still be in flight; use
+ * cda_is_published() or cda_get() to test an individual slot.
+ */
+size_t cda_reserved(const ConcurrentArray *ca);
+
+/**
+ * @brief Size of one element in bytes (0 if ca == NULL).
+ */
+size_t cda_elem_size(const ConcurrentArray *ca);
+
+/**
+ * @brief True if slot @p index has been fully written by its producer.
+ */
+bool cda_is_published(const ConcurrentArray *ca, size_t index);
+
+/**
+ * @brief Copy a published element into @p out.
+ *
+ * @return DYN_OK on success, DYN_ERR_RANGE if the slot is not (yet)
+ *         published, DYN_ERR_INVAL on invalid arguments.
+ */
+int cda_get(const ConcurrentArray *ca, size_t index, void *out);
+
+/**
+ * @brief Pointer to a published element, or NULL if it is not published.
+ *
+ * The pointer stays valid until cda_destroy() because segments never move.
+ */
+const void *cda_at(const ConcurrentArray *ca, size_t index);
+
+/**
+ * @brief Length of the longest fully published prefix [0, n).
+ *
+ * Scans forward from a cached watermark, so repeated calls are cheap. Useful
+ * for a consumer that drains the array in order.
+ */
+size_t cda_published_prefix(ConcurrentArray *ca);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,693 @@
+// src/da_serialize.c
+#include "da_serialize.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Implementation notes:
+ *  - Every element is widened to a 64-bit "key" first. Signed elements are
+ *    sign-extended and get their top bit flipped so that key order matches
+ *    integer order; frame-of-reference then works on plain unsigned keys.
+ *  - With DA_SER_DELTA the packed value is zigzag(key - previous key), so a
+ *    sorted run (or a mostly sorted one) turns into small unsigned numbers.
+ *    The first key of each block is its `ref`, so no block depends on the
+ *    one before it.
+ *  - Packed payloads are followed by SER_SLACK readable bytes so that
+ *    pack/unpack can use unaligned 64-bit windows without bounds checks:
+ *    the encoder packs into a zeroed scratch buffer, the stream reader keeps
+ *    SER_SLACK bytes past its buffer, and in a complete stream the index
+ *    and footer (at least 28 bytes) follow every payload. Bits read past
+ *    the last value are masked off, so their contents do not matter.
+ */
+
+#define SER_MAGIC "DAZ1"
+#define SER_FOOTER_MAGIC "DAZI"
+#define SER_VERSION 1
+#define SER_HEADER_BYTES 16
+#define SER_FOOTER_BYTES 20
+#define SER_PACKED_MAX (DA_SER_BLOCK * 8)
+#define SER_SLACK 16
+#define SER_VARINT_MAX 10
+#define SER_BLOCK_HEADER_MAX (2 * SER_VARINT_MAX + 1)
+#define SER_IO_BUF 4096
+
+/* -------------------------
+ * Little-endian helpers
+ * ------------------------- */
+
+static inline uint64_t load_le64(const unsigned char *p) {
+  return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 |
+         (uint64_t)p[3] << 24 | (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 |
+         (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+
+static inline void store_le64(unsigned char *p, uint64_t v) {
+  for (int i = 0; i < 8; ++i)
+    p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static size_t put_varint(unsigned char *p, uint64_t v) {
+  size_t n = 0;
+  while (v >= 0x80) {
+    p[n++] = (unsigned char)(v | 0x80);
+    v >>= 7;
+  }
+  p[n++] = (unsigned char)v;
+  return n;
+}
+
+/* Parse a varint from [p, end). Returns bytes consumed or 0 if malformed. */
+static size_t get_varint(const unsigned char *p, const unsigned char *end,
+                         uint64_t *out) {
+  uint64_t v = 0;
+  for (size_t n = 0; n < SER_VARINT_MAX && p + n < end; ++n) {
+    v |= (uint64_t)(p[n] & 0x7f) << (7 * n);
+    if (!(p[n] & 0x80)) {
+      *out = v;
+      return n + 1;
+    }
+  }
+  return 0;
+}
+
+static inline uint64_t zigzag(uint64_t d) {
+  return (d << 1) ^ (uint64_t)((int64_t)d >> 63);
+}
+
+static inline uint64_t unzigzag(uint64_t z) {
+  return (z >> 1) ^ (uint64_t)(-(int64_t)(z & 1));
+}
+
+static inline unsigned bit_width(uint64_t v) {
+  unsigned w = 0;
+  while (v) {
+    ++w;
+    v >>= 1;
+  }
+  return w;
+}
+
+static inline size_t packed_bytes(size_t n, unsigned width) {
+  return (n * width + 7) / 8;
+}
+
+/* -------------------------
+ * Key mapping
+ * ------------------------- */
+
+static bool valid_elem_size(size_t es) {
+  return es == 1 || es == 2 || es == 4 || es == 8;
+}
+
+/* Widen n elements of size es into order-preserving 64-bit keys. */
+static void load_keys(const unsigned char *src, size_t n, size_t es,
+                      bool is_signed, uint64_t *keys) {
+  const uint64_t flip = is_signed ? (uint64_t)1 << 63 : 0;
+  for (size_t i = 0; i < n; ++i, src += es) {
+    uint64_t k;
+    switch (es) {
+    case 1: {
+      uint8_t v;
+      memcpy(&v, src, 1);
+      k = is_signed ? (uint64_t)(int64_t)(int8_t)v : v;
+      break;
+    }
+    case 2: {
+      uint16_t v;
+      memcpy(&v, src, 2);
+      k = is_signed ? (uint64_t)(int64_t)(int16_t)v : v;
+      break;
+    }
+    case 4: {
+      uint32_t v;
+      memcpy(&v, src, 4);
+      k = is_signed ? (uint64_t)(int64_t)(int32_t)v : v;
+      break;
+    }
+    default:
+      memcpy(&k, src, 8);
+      break;
+    }
+    keys[i] = k ^ flip;
+  }
+}
+
+/* -------------------------
+ * Bit packing
+ * ------------------------- */
+
+/* Pack n values of `width` bits into a zeroed buffer with SER_SLACK slack. */
+static void pack_bits(const uint64_t *v, size_t n, unsigned width,
+                      unsigned char *out) {
+  if (width == 0)
+    return;
+  for (size_t i = 0; i < n; ++i) {
+    size_t bit = i * width;
+    unsigned char *p = out + (bit >> 3);
+    unsigned off = (unsigned)(bit & 7);
+    store_le64(p, load_le64(p) | (v[i] << off));
+    if (off + width > 64)
+      p[8] |= (unsigned char)(v[i] >> (64 - off));
+  }
+}
+
+/*
+ * Unpack n values of `width` bits from a buffer with SER_SLACK slack. The
+ * body is instantiated once per width below so the shifts and masks become
+ * constants. Eight values of `width` bits fill exactly `width` bytes, so
+ * the loop is unrolled by eight: within a group every byte offset and shift
+ * is a compile-time constant as well.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define SER_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define SER_ALWAYS_INLINE inline
+#endif
+
+static SER_ALWAYS_INLINE uint64_t unpack_one(const unsigned char *in,
+                                             const size_t bit,
+                                             const unsigned width) {
+  const uint64_t mask = width == 64 ? ~(uint64_t)0 : ((uint64_t)1 << width) - 1;
+  const unsigned char *p = in + (bit >> 3);
+  const unsigned off = (unsigned)(bit & 7);
+  uint64_t x = load_le64(p) >> off;
+  if (off + width > 64)
+    x |= (uint64_t)p[8] << (64 - off);
+  return x & mask;
+}
+
+static SER_ALWAYS_INLINE void unpack_width(const unsigned char *in, size_t n,
+                                           const unsigned width, uint64_t base,
+                                           uint64_t *v) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8, in += width) {
+    v[i + 0] = base + unpack_one(in, 0 * width, width);
+    v[i + 1] = base + unpack_one(in, 1 * width, width);
+    v[i + 2] = base + unpack_one(in, 2 * width, width);
+    v[i + 3] = base + unpack_one(in, 3 * width, width);
+    v[i + 4] = base + unpack_one(in, 4 * width, width);
+    v[i + 5] = base + unpack_one(in, 5 * width, width);
+    v[i + 6] = base + unpack_one(in, 6 * width, width);
+    v[i + 7] = base + unpack_one(in, 7 * width, width);
+  }
+  for (size_t j = 0; i < n; ++i, ++j) /* short last block */
+    v[i] = base + unpack_one(in, j * width, width);
+}
+
+#define SER_W8(b)                                                              \
+  case b + 1:                                                                  \
+    unpack_width(in, n, b + 1, base, v);                                       \
+    return;                                                                    \
+  case b + 2:                                                                  \
+    unpack_width(in, n, b + 2, base, v);                                       \
+    return;                                                                    \
+  case b + 3:                                                                  \
+    unpack_width(in, n, b + 3, base, v);                                       \
+    return;                                                                    \
+  case b + 4:                                                                  \
+    unpack_width(in, n, b + 4, base, v);                                       \
+    return;                                                                    \
+  case b + 5:                                                                  \
+    unpack_width(in, n, b + 5, base, v);                                       \
+    return;                                                                    \
+  case b + 6:                                                                  \
+    unpack_width(in, n, b + 6, base, v);                                       \
+    return;                                                                    \
+  case b + 7:                                                                  \
+    unpack_width(in, n, b + 7, base, v);                                       \
+    return;                                                                    \
+  case b + 8:                                                                  \
+    unpack_width(in, n, b + 8, base, v);                                       \
+    return;
+
+static void unpack_bits(const unsigned char *in, size_t n, unsigned width,
+                        uint64_t base, uint64_t *v) {
+  switch (width) {
+    SER_W8(0)
+    SER_W8(8)
+    SER_W8(16)
+    SER_W8(24)
+    SER_W8(32)
+    SER_W8(40)
+    SER_W8(48)
+    SER_W8(56)
+  default:
+    for (size_t i = 0; i < n; ++i)
+      v[i] = base; /* width 0: every value equals the frame minimum */
+    return;
+  }
+}
+
+#undef SER_W8
+
+/* -------------------------
+ * Block codec
+ * ------------------------- */
+
+/*
+ * Encode n (1 .. DA_SER_BLOCK) keys. In delta mode the block's first key is
+ * the reference, so its own delta is 0 and the block decodes on its own.
+ * Writes the block header into hdr (length via hdr_len) and the payload into
+ * `packed`; returns the payload length.
+ */
+static size_t encode_block(const uint64_t *keys, size_t n, bool delta,
+                           unsigned char *hdr, size_t *hdr_len,
+                           unsigned char *packed) {
+  uint64_t vals[DA_SER_BLOCK];
+  uint64_t ref = delta ? keys[0] : 0;
+  uint64_t p = ref;
+  for (size_t i = 0; i < n; ++i) {
+    vals[i] = delta ? zigzag(keys[i] - p) : keys[i];
+    p = keys[i];
+  }
+
+  uint64_t lo = UINT64_MAX, hi = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (vals[i] < lo)
+      lo = vals[i];
+    if (vals[i] > hi)
+      hi = vals[i];
+  }
+  unsigned width = bit_width(hi - lo);
+  for (size_t i = 0; i < n; ++i)
+    vals[i] -= lo;
+
+  size_t h = put_varint(hdr, ref);
+  h += put_varint(hdr + h, lo);
+  hdr[h++] = (unsigned char)width;
+  *hdr_len = h;
+
+  size_t bytes = packed_bytes(n, width);
+  memset(packed, 0, bytes + SER_SLACK);
+  pack_bits(vals, n, width, packed);
+  return bytes;
+}
+
+/*
+ * Narrow unpacked values back to elements of size es (inverse of
+ * load_keys), undoing the delta in the same pass. Instantiated per element
+ * size and mode like unpack_width.
+ */
+static SER_ALWAYS_INLINE void store_width(const uint64_t *vals, size_t n,
+                                          const bool delta, uint64_t prev,
+                                          uint64_t flip, const size_t es,
+                                          unsigned char *dst) {
+  for (size_t i = 0; i < n; ++i, dst += es) {
+    uint64_t k = vals[i];
+    if (delta)
+      k = prev += unzigzag(k);
+    k ^= flip;
+    if (es == 1) {
+      *dst = (uint8_t)k;
+    } else if (es == 2) {
+      uint16_t v = (uint16_t)k;
+      memcpy(dst, &v, 2);
+    } else if (es == 4) {
+      uint32_t v = (uint32_t)k;
+      memcpy(dst, &v, 4);
+    } else {
+      memcpy(dst, &k, 8);
+    }
+  }
+}
+
+/*
+ * Decode n elements of size es from a payload (with slack) given the parsed
+ * header, writing them to dst. Values are unpacked into an L1-resident
+ * block of keys, then narrowed straight into place.
+ */
+static void decode_block(const unsigned char *packed, size_t n, bool delta,
+                         uint64_t ref, uint64_t lo, unsigned width, size_t es,
+                         bool is_signed, unsigned char *dst) {
+  uint64_t vals[DA_SER_BLOCK];
+  unpack_bits(packed, n, width, lo, vals);
+  const uint64_t flip = is_signed ? (uint64_t)1 << 63 : 0;
+  switch (es << 1 | delta) {
+  case 2:
+    store_width(vals, n, false, ref, flip, 1, dst);
+    break;
+  case 3:
+    store_width(vals, n, true, ref, flip, 1, dst);
+    break;
+  case 4:
+    store_width(vals, n, false, ref, flip, 2, dst);
+    break;
+  case 5:
+    store_width(vals, n, true, ref, flip, 2, dst);
+    break;
+  case 8:
+    store_width(vals, n, false, ref, flip, 4, dst);
+    break;
+  case 9:
+    store_width(vals, n, true, ref, flip, 4, dst);
+    break;
+  case 16:
+    store_width(vals, n, false, ref, flip, 8, dst);
+    break;
+  default:
+    store_width(vals, n, true, ref, flip, 8, dst);
+    break;
+  }
+}
+
+/* -------------------------
+ * Buffered writer / reader
+ * ------------------------- */
+
+typedef struct {
+  da_write_fn fn;
+  void *ctx;
+  uint64_t offset; /* bytes emitted so far */
+  size_t fill;
+  unsigned char buf[SER_IO_BUF];
+} ser_writer;
+
+static int w_flush(ser_writer *w) {
+  if (w->fill && w->fn(w->ctx, w->buf, w->fill) != w->fill)
+    return DYN_ERR_IO;
+  w->fill = 0;
+  return DYN_OK;
+}
+
+static int w_put(ser_writer *w, const void *data, size_t len) {
+  w->offset += len;
+  if (len > SER_IO_BUF - w->fill) {
+    int st = w_flush(w);
+    if (st != DYN_OK)
+      return st;
+    if (len > SER_IO_BUF)
+      return w->fn(w->ctx, data, len) == len ? DYN_OK : DYN_ERR_IO;
+  }
+  memcpy(w->buf + w->fill, data, len);
+  w->fill += len;
+  return DYN_OK;
+}
+
+typedef struct {
+  da_read_fn fn;
+  void *ctx;
+  size_t pos, len;
+  unsigned char buf[SER_IO_BUF + SER_SLACK]; /* slack for in-place unpack */
+} ser_reader;
+
+/* Read exactly len bytes or fail with DYN_ERR_IO. */
+static int r_get(ser_reader *r, void *data, size_t len) {
+  unsigned char *dst = data;
+  while (len) {
+    if (r->pos == r->len) {
+      r->pos = 0;
+      r->len = r->fn(r->ctx, r->buf, SER_IO_BUF);
+      if (r->len == 0)
+        return DYN_ERR_IO;
+    }
+    size_t take = r->len - r->pos;
+    if (take > len)
+      take = len;
+    memcpy(dst, r->buf + r->pos, take);
+    r->pos += take;
+    dst += take;
+    len -= take;
+  }
+  return DYN_OK;
+}
+
+/*
+ * Make at least need (<= SER_IO_BUF) bytes available at buf + pos without
+ * consuming them, moving the unread tail to the front first if needed.
+ */
+static int r_ensure(ser_reader *r, size_t need) {
+  size_t have = r->len - r->pos;
+  if (have >= need)
+    return DYN_OK;
+  memmove(r->buf, r->buf + r->pos, have);
+  r->pos = 0;
+  r->len = have;
+  while (r->len < need) {
+    size_t got = r->fn(r->ctx, r->buf + r->len, SER_IO_BUF - r->len);
+    if (got == 0)
+      return DYN_ERR_IO;
+    r->len += got;
+  }
+  return DYN_OK;
+}
+
+size_t da_file_write(void *ctx, const void *buf, size_t len) {
+  return fwrite(buf, 1, len, (FILE *)ctx);
+}
+
+size_t da_file_read(void *ctx, void *buf, size_t len) {
+  return fread(buf, 1, len, (FILE *)ctx);
+}
+
+/* -------------------------
+ * Public API
+ * ------------------------- */
+
+static size_t block_count(size_t count) {
+  return count / DA_SER_BLOCK + (count % DA_SER_BLOCK != 0);
+}
+
+int da_serialize(const DynamicArray *da, unsigned flags, da_write_fn write,
+                 void *ctx) {
+  if (!da || !write || (flags & ~(unsigned)(DA_SER_SIGNED | DA_SER_DELTA)))
+    return DYN_ERR_INVAL;
+  size_t es = da_elem_size(da);
+  if (!valid_elem_size(es))
+    return DYN_ERR_INVAL;
+
+  size_t count = da_size(da);
+  size_t nblocks = block_count(count);
+  const bool is_signed = flags & DA_SER_SIGNED;
+  const bool delta = flags & DA_SER_DELTA;
+
+  /* block offsets are collected here and written as the index at the end */
+  DynamicArray *index = da_create(sizeof(uint64_t));
+  ser_writer *w = malloc(sizeof(*w));
+  unsigned char *packed = malloc(SER_PACKED_MAX + SER_SLACK);
+  int st = (index && w && packed) ? da_reserve(index, nblocks) : DYN_ERR_OOM;
+  if (st != DYN_OK)
+    goto done;
+  w->fn = write;
+  w->ctx = ctx;
+  w->offset = 0;
+  w->fill = 0;
+
+  unsigned char header[SER_HEADER_BYTES] = {0};
+  memcpy(header, SER_MAGIC, 4);
+  header[4] = SER_VERSION;
+  header[5] = (unsigned char)es;
+  header[6] = (unsigned char)flags;
+  store_le64(header + 8, (uint64_t)count);
+  if ((st = w_put(w, header, sizeof(header))) != DYN_OK)
+    goto done;
+
+  const unsigned char *src = da_cdata(da);
+  uint64_t keys[DA_SER_BLOCK];
+  for (size_t b = 0; b < nblocks; ++b) {
+    size_t n = count - b * DA_SER_BLOCK;
+    if (n > DA_SER_BLOCK)
+      n = DA_SER_BLOCK;
+    load_keys(src + b * DA_SER_BLOCK * es, n, es, is_signed, keys);
+
+    uint64_t off = w->offset;
+    if ((st = da_push_back(index, &off)) != DYN_OK)
+      goto done;
+
+    unsigned char hdr[SER_BLOCK_HEADER_MAX];
+    size_t hdr_len;
+    size_t bytes = encode_block(keys, n, delta, hdr, &hdr_len, packed);
+    if ((st = w_put(w, hdr, hdr_len)) != DYN_OK ||
+        (st = w_put(w, packed, bytes)) != DYN_OK)
+      goto done;
+  }
+
+  /* index + footer */
+  uint64_t index_offset = w->offset;
+  const uint64_t *offs = da_cdata(index);
+  for (size_t b = 0; b < nblocks; ++b) {
+    unsigned char le[8];
+    store_le64(le, offs[b]);
+    if ((st = w_put(w, le, 8)) != DYN_OK)
+      goto done;
+  }
+  unsigned char footer[SER_FOOTER_BYTES];
+  store_le64(footer, index_offset);
+  store_le64(footer + 8, (uint64_t)nblocks);
+  memcpy(footer + 16, SER_FOOTER_MAGIC, 4);
+  if ((st = w_put(w, footer, sizeof(footer))) != DYN_OK)
+    goto done;
+  st = w_flush(w);
+
+done:
+  free(packed);
+  free(w);
+  da_destroy(index);
+  return st;
+}
+
+/* Parse and validate the fixed header. */
+static int parse_header(const unsigned char *h, size_t *es, unsigned *flags,
+                        uint64_t *count) {
+  if (memcmp(h, SER_MAGIC, 4) != 0 || h[4] != SER_VERSION)
+    return DYN_ERR_IO;
+  *es = h[5];
+  *flags = h[6];
+  *count = load_le64(h + 8);
+  if (!valid_elem_size(*es) ||
+      (*flags & ~(unsigned)(DA_SER_SIGNED | DA_SER_DELTA)))
+    return DYN_ERR_IO;
+  return DYN_OK;
+}
+
+int da_deserialize(DynamicArray *out, da_read_fn read, void *ctx) {
+  if (!out || !read)
+    return DYN_ERR_INVAL;
+
+  ser_reader *r = calloc(1, sizeof(*r));
+  int st = r ? DYN_OK : DYN_ERR_OOM;
+  if (st != DYN_OK)
+    goto done;
+  r->fn = read;
+  r->ctx = ctx;
+
+  unsigned char header[SER_HEADER_BYTES];
+  size_t es;
+  unsigned flags;
+  uint64_t count;
+  if ((st = r_get(r, header, sizeof(header))) != DYN_OK ||
+      (st = parse_header(header, &es, &flags, &count)) != DYN_OK)
+    goto done;
+  if (es != da_elem_size(out)) {
+    st = DYN_ERR_INVAL;
+    goto done;
+  }
+  if (count > SIZE_MAX - da_size(out)) {
+    st = DYN_ERR_OVERFLOW;
+    goto done;
+  }
+  if ((st = da_reserve(out, da_size(out) + (size_t)count)) != DYN_OK)
+    goto done;
+
+  const bool is_signed = flags & DA_SER_SIGNED;
+  const bool delta = flags & DA_SER_DELTA;
+  size_t nblocks = block_count((size_t)count);
+  /* decode into the reserved tail; da_size(out) grows once at the end */
+  unsigned char *dst = (unsigned char *)da_data(out) + da_size(out) * es;
+  for (size_t b = 0; b < nblocks; ++b) {
+    size_t n = (size_t)count - b * DA_SER_BLOCK;
+    if (n > DA_SER_BLOCK)
+      n = DA_SER_BLOCK;
+    /* the index and footer follow, so a full header's worth is readable */
+    if ((st = r_ensure(r, SER_BLOCK_HEADER_MAX)) != DYN_OK)
+      goto done;
+    const unsigned char *p = r->buf + r->pos, *end = r->buf + r->len;
+    uint64_t ref, lo;
+    size_t a = get_varint(p, end, &ref);
+    size_t c = a ? get_varint(p + a, end, &lo) : 0;
+    if (!c || p[a + c] > 64) {
+      st = DYN_ERR_IO;
+      goto done;
+    }
+    unsigned width = p[a + c];
+    r->pos += a + c + 1;
+
+    size_t bytes = packed_bytes(n, width);
+    if ((st = r_ensure(r, bytes)) != DYN_OK)
+      goto done;
+    decode_block(r->buf + r->pos, n, delta, ref, lo, width, es, is_signed,
+                 dst);
+    r->pos += bytes;
+    dst += n * es;
+  }
+
+  /* consume the index and check the footer so the stream is left clean */
+  for (size_t b = 0; b < nblocks; ++b) {
+    unsigned char le[8];
+    if ((st = r_get(r, le, 8)) != DYN_OK)
+      goto done;
+  }
+  unsigned char footer[SER_FOOTER_BYTES];
+  if ((st = r_get(r, footer, sizeof(footer))) != DYN_OK)
+    goto done;
+  if (memcmp(footer + 16, SER_FOOTER_MAGIC, 4) != 0 ||
+      load_le64(footer + 8) != nblocks)
+    st = DYN_ERR_IO;
+  else
+    st = da_append_reserved(out, (size_t)count);
+
+done:
+  free(r);
+  return st;
+}
+
+int da_ser_open(da_ser_view *view, const void *buf, size_t len) {
+  if (!view || !buf)
+    return DYN_ERR_INVAL;
+  const unsigned char *base = buf;
+  if (len < SER_HEADER_BYTES + SER_FOOTER_BYTES)
+    return DYN_ERR_IO;
+
+  uint64_t count;
+  int st = parse_header(base, &view->elem_size, &view->flags, &count);
+  if (st != DYN_OK)
+    return st;
+
+  const unsigned char *footer = base + len - SER_FOOTER_BYTES;
+  if (memcmp(footer + 16, SER_FOOTER_MAGIC, 4) != 0)
+    return DYN_ERR_IO;
+  uint64_t index_offset = load_le64(footer);
+  uint64_t nblocks = load_le64(footer + 8);
+  if (count > SIZE_MAX || nblocks != block_count((size_t)count) ||
+      index_offset > len - SER_FOOTER_BYTES ||
+      nblocks > (len - SER_FOOTER_BYTES - index_offset) / 8)
+    return DYN_ERR_IO;
+
+  view->base = base;
+  view->len = len;
+  view->count = (size_t)count;
+  view->nblocks = (size_t)nblocks;
+  view->index = base + index_offset;
+  return DYN_OK;
+}
+
+int da_ser_decode_block(const da_ser_view *view, size_t block, void *out,
+                        size_t *out_count) {
+  if (!view || !out)
+    return DYN_ERR_INVAL;
+  if (block >= view->nblocks)
+    return DYN_ERR_RANGE;
+
+  size_t n = view->count - block * DA_SER_BLOCK;
+  if (n > DA_SER_BLOCK)
+    n = DA_SER_BLOCK;
+
+  uint64_t off = load_le64(view->index + 8 * block);
+  const unsigned char *end = view->index;
+  if (off >= (uint64_t)(end - view->base))
+    return DYN_ERR_IO;
+  const unsigned char *p = view->base + off;
+
+  uint64_t ref, lo;
+  size_t used = get_varint(p, end, &ref);
+  if (!used)
+    return DYN_ERR_IO;
+  p += used;
+  if (!(used = get_varint(p, end, &lo)))
+    return DYN_ERR_IO;
+  p += used;
+  if (p >= end || *p > 64)
+    return DYN_ERR_IO;
+  unsigned width = *p++;
+
+  size_t bytes = packed_bytes(n, width);
+  if (bytes > (size_t)(end - p))
+    return DYN_ERR_IO;
+  /* the index (>= 8 bytes) and footer follow, so unpack reads in place */
+  decode_block(p, n, view->flags & DA_SER_DELTA, ref, lo, width,
+               view->elem_size, view->flags & DA_SER_SIGNED, out);
+  if (out_count)
+    *out_count = n;
+  return DYN_OK;
+}
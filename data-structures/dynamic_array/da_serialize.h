@@ -0,0 +1,118 @@
+// include/da_serialize.h
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "dynamic_array.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file da_serialize.h
+ * @brief Compressed streaming serialization for integer DynamicArrays.
+ *
+ * Elements (1, 2, 4 or 8 byte integers) are cut into blocks of
+ * DA_SER_BLOCK values. Each block is encoded as:
+ *
+ *   varint ref | varint min | u8 width | DA_SER_BLOCK * width bits
+ *
+ * where every value is optionally delta-coded against its predecessor
+ * (`ref` is the block's first value, so blocks decode independently),
+ * zigzag-mapped, and stored as (value - min) in a fixed bit width
+ * (frame-of-reference bit-packing). A full block's payload is exactly
+ * 16 * width bytes, which keeps the layout friendly to vector unpackers.
+ *
+ * Stream layout:
+ *
+ *   header (16 bytes) | block 0 | ... | block n-1 |
+ *   index: n * u64 block offsets | footer: u64 index offset, u64 n, "DAZI"
+ *
+ * All multi-byte integers are little-endian. The index lets a reader with the
+ * whole buffer in memory (read or mmap'd) decode any single block; a stream
+ * reader ignores it and decodes blocks in order.
+ *
+ * Sorted data with small gaps typically shrinks 3-8x with DA_SER_DELTA.
+ */
+
+/** Values per block. */
+#define DA_SER_BLOCK 128
+
+/** Encoding flags for da_serialize(). */
+enum {
+  DA_SER_SIGNED = 1 << 0, /**< elements are two's-complement signed */
+  DA_SER_DELTA = 1 << 1   /**< delta-code consecutive values (sorted data) */
+};
+
+/**
+ * Writer callback: write @p len bytes, return the number actually written
+ * (anything short of @p len is treated as an error). Same contract as fwrite
+ * with size 1.
+ */
+typedef size_t (*da_write_fn)(void *ctx, const void *buf, size_t len);
+
+/**
+ * Reader callback: read up to @p len bytes, return the number read (0 at end
+ * of stream). Same contract as fread with size 1.
+ */
+typedef size_t (*da_read_fn)(void *ctx, void *buf, size_t len);
+
+/** FILE* adapters: pass the FILE* as ctx. */
+size_t da_file_write(void *ctx, const void *buf, size_t len);
+size_t da_file_read(void *ctx, void *buf, size_t len);
+
+/**
+ * @brief Serialize all elements of @p da through @p write.
+ *
+ * @param flags Combination of DA_SER_SIGNED and DA_SER_DELTA.
+ * @return DYN_OK, DYN_ERR_INVAL if the element size is not 1/2/4/8 or an
+ *         argument is NULL, DYN_ERR_OOM, or DYN_ERR_IO if the writer failed.
+ */
+int da_serialize(const DynamicArray *da, unsigned flags, da_write_fn write,
+                 void *ctx);
+
+/**
+ * @brief Decode a serialized stream and append its elements to @p out.
+ *
+ * Storage is reserved once from the header count, then each block is
+ * decoded straight into the array. da_elem_size(out) must match the stream.
+ * The size grows only once the whole stream has decoded, so on error
+ * da_size(out) is unchanged.
+ *
+ * @return DYN_OK, DYN_ERR_INVAL on element size mismatch, DYN_ERR_IO on a
+ *         truncated or corrupt stream, or an allocation error.
+ */
+int da_deserialize(DynamicArray *out, da_read_fn read, void *ctx);
+
+/** Random-access view over a complete serialized buffer. */
+typedef struct {
+  const unsigned char *base; /**< start of the buffer */
+  size_t len;                /**< buffer length in bytes */
+  size_t count;              /**< total number of elements */
+  size_t elem_size;          /**< element size in bytes */
+  unsigned flags;            /**< DA_SER_* flags used by the writer */
+  size_t nblocks;            /**< number of blocks */
+  const unsigned char *index; /**< nblocks little-endian u64 offsets */
+} da_ser_view;
+
+/**
+ * @brief Validate a buffer and fill @p view from its header and footer.
+ * @return DYN_OK or DYN_ERR_IO if the buffer is not a valid stream.
+ */
+int da_ser_open(da_ser_view *view, const void *buf, size_t len);
+
+/**
+ * @brief Decode block @p block into @p out (room for DA_SER_BLOCK elements).
+ *
+ * @param out_count Receives the number of elements decoded (the last block
+ *        may be partial).
+ * @return DYN_OK, DYN_ERR_RANGE if block >= nblocks, DYN_ERR_IO if corrupt.
+ */
+int da_ser_decode_block(const da_ser_view *view, size_t block, void *out,
+                        size_t *out_count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,470 @@
+// src/da_sort.c
+#include "da_sort.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Implementation notes:
+ *  - Kernels are generated by DA_SORT_KERNELS for each (item type, element
+ *    accessor, key comparison) triple. Item types are uint32_t, uint64_t and
+ *    a 16-byte pair for direct sorting, and size_t indices for the indirect
+ *    path. Every kernel receives a sort_ctx named `c`; the accessor and the
+ *    comparison macros may use it.
+ *  - Keys are loaded with memcpy, which compiles to a plain load and keeps
+ *    the code free of aliasing problems.
+ *  - The dispatch table `kernels[class][key]` is the single place that maps
+ *    a call to an implementation. A NULL entry means the key is wider than
+ *    the element.
+ */
+
+#define SORT_INSERTION_MAX 16 /* introsort cutoff */
+#define SORT_RUN 32           /* merge sort initial run length */
+
+typedef struct {
+  uint64_t lo, hi;
+} item16;
+
+typedef struct {
+  da_cmp_fn cmp;
+  const unsigned char *base; /* indirect path: element storage */
+  size_t es;                 /* indirect path: element size */
+} sort_ctx;
+
+/* -------------------------
+ * Key loads / comparisons
+ * ------------------------- */
+
+#define DA_DEFINE_LOAD(NAME, T)                                                \
+  static inline T NAME(const void *p) {                                        \
+    T v;                                                                       \
+    memcpy(&v, p, sizeof(v));                                                  \
+    return v;                                                                  \
+  }
+DA_DEFINE_LOAD(ld_i32, int32_t)
+DA_DEFINE_LOAD(ld_u32, uint32_t)
+DA_DEFINE_LOAD(ld_f32, float)
+DA_DEFINE_LOAD(ld_i64, int64_t)
+DA_DEFINE_LOAD(ld_u64, uint64_t)
+DA_DEFINE_LOAD(ld_f64, double)
+#undef DA_DEFINE_LOAD
+
+#define KL_CMP(x, y) (c->cmp((x), (y)) < 0)
+#define KL_I32(x, y) (ld_i32(x) < ld_i32(y))
+#define KL_U32(x, y) (ld_u32(x) < ld_u32(y))
+#define KL_F32(x, y) (ld_f32(x) < ld_f32(y))
+#define KL_I64(x, y) (ld_i64(x) < ld_i64(y))
+#define KL_U64(x, y) (ld_u64(x) < ld_u64(y))
+#define KL_F64(x, y) (ld_f64(x) < ld_f64(y))
+
+/* Item pointer -> element bytes. */
+#define EL_DIRECT(p) ((const void *)(p))
+#define EL_INDIRECT(p) ((const void *)(c->base + *(p) * c->es))
+
+/* -------------------------
+ * Kernel templates
+ * ------------------------- */
+
+#define DA_SORT_KERNELS(NAME, T, ELEM, KEYLESS)                                \
+  static inline bool NAME##_less(const T *a, const T *b, const sort_ctx *c) {  \
+    (void)c;                                                                   \
+    return KEYLESS(ELEM(a), ELEM(b));                                          \
+  }                                                                            \
+                                                                               \
+  static void NAME##_insertion(T *a, size_t n, const sort_ctx *c) {            \
+    for (size_t i = 1; i < n; ++i) {                                           \
+      T x = a[i];                                                              \
+      size_t j = i;                                                            \
+      while (j > 0 && NAME##_less(&x, &a[j - 1], c)) {                         \
+        a[j] = a[j - 1];                                                       \
+        --j;                                                                   \
+      }                                                                        \
+      a[j] = x;                                                                \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  static void NAME##_sift(T *a, size_t root, size_t n, const sort_ctx *c) {    \
+    T x = a[root];                                                             \
+    size_t child;                                                              \
+    while ((child = 2 * root + 1) < n) {                                       \
+      if (child + 1 < n && NAME##_less(&a[child], &a[child + 1], c))           \
+        ++child;                                                               \
+      if (!NAME##_less(&x, &a[child], c))                                      \
+        break;                                                                 \
+      a[root] = a[child];                                                      \
+      root = child;                                                            \
+    }                                                                          \
+    a[root] = x;                                                               \
+  }                                                                            \
+                                                                               \
+  static void NAME##_heapsort(T *a, size_t n, const sort_ctx *c) {             \
+    for (size_t i = n / 2; i-- > 0;)                                           \
+      NAME##_sift(a, i, n, c);                                                 \
+    for (size_t end = n; end-- > 1;) {                                         \
+      T tmp = a[0];                                                            \
+      a[0] = a[end];                                                           \
+      a[end] = tmp;                                                            \
+      NAME##_sift(a, 0, end, c);                                               \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  static void NAME##_introsort(T *a, size_t n, unsigned depth,                 \
+                               const sort_ctx *c) {                            \
+    while (n > SORT_INSERTION_MAX) {                                           \
+      if (depth-- == 0) {                                                      \
+        NAME##_heapsort(a, n, c);                                              \
+        return;                                                                \
+      }                                                                        \
+      /* median of three into a[0] <= a[mid] <= a[n-1] */                     \
+      size_t mid = n / 2;                                                      \
+      T tmp;                                                                   \
+      if (NAME##_less(&a[mid], &a[0], c)) {                                    \
+        tmp = a[mid], a[mid] = a[0], a[0] = tmp;                               \
+      }                                                                        \
+      if (NAME##_less(&a[n - 1], &a[mid], c)) {                                \
+        tmp = a[mid], a[mid] = a[n - 1], a[n - 1] = tmp;                       \
+        if (NAME##_less(&a[mid], &a[0], c)) {                                  \
+          tmp = a[mid], a[mid] = a[0], a[0] = tmp;                             \
+        }                                                                      \
+      }                                                                        \
+      const T pivot = a[mid];                                                  \
+      /* Hoare partition: [0, j] <= pivot <= [j + 1, n) */                    \
+      size_t i = 0, j = n - 1;                                                 \
+      for (;;) {                                                               \
+        while (NAME##_less(&a[i], &pivot, c))                                  \
+          ++i;                                                                 \
+        while (NAME##_less(&pivot, &a[j], c))                                  \
+          --j;                                                                 \
+        if (i >= j)                                                            \
+          break;                                                               \
+        tmp = a[i], a[i] = a[j], a[j] = tmp;                                   \
+        ++i;                                                                   \
+        --j;                                                                   \
+      }                                                                        \
+      size_t left = j + 1;                                                     \
+      /* recurse into the smaller side, loop on the larger one */             \
+      if (left < n - left) {                                                   \
+        NAME##_introsort(a, left, depth, c);                                   \
+        a += left;                                                             \
+        n -= left;                                                             \
+      } else {                                                                 \
+        NAME##_introsort(a + left, n - left, depth, c);                        \
+        n = left;                                                              \
+      }                                                                        \
+    }                                                                          \
+    NAME##_insertion(a, n, c);                                                 \
+  }                                                                            \
+                                                                               \
+  static void NAME##_sort(void *base, size_t n, const sort_ctx *c) {           \
+    unsigned depth = 0;                                                        \
+    for (size_t m = n; m > 1; m >>= 1)                                         \
+      depth += 2;                                                              \
+    NAME##_introsort((T *)base, n, depth, c);                                  \
+  }                                                                            \
+                                                                               \
+  static int NAME##_stable(void *base, size_t n, const sort_ctx *c) {          \
+    T *a = (T *)base;                                                          \
+    for (size_t lo = 0; lo < n; lo += SORT_RUN)                                \
+      NAME##_insertion(a + lo, n - lo < SORT_RUN ? n - lo : SORT_RUN, c);      \
+    if (n <= SORT_RUN)                                                         \
+      return DYN_OK;                                                           \
+    T *buf = malloc(n * sizeof(T));                                            \
+    if (!buf)                                                                  \
+      return DYN_ERR_OOM;                                                      \
+    T *src = a, *dst = buf;                                                    \
+    for (size_t w = SORT_RUN; w < n; w *= 2) {                                 \
+      for (size_t lo = 0; lo < n; lo += 2 * w) {                               \
+        size_t mid = lo + w < n ? lo + w : n;                                  \
+        size_t hi = mid + w < n ? mid + w : n;                                 \
+        size_t i = lo, j = mid, k = lo;                                        \
+        while (i < mid && j < hi)                                              \
+          dst[k++] = NAME##_less(&src[j], &src[i], c) ? src[j++] : src[i++];   \
+        while (i < mid)                                                        \
+          dst[k++] = src[i++];                                                 \
+        while (j < hi)                                                         \
+          dst[k++] = src[j++];                                                 \
+      }                                                                        \
+      T *t = src;                                                              \
+      src = dst;                                                               \
+      dst = t;                                                                 \
+    }                                                                          \
+    if (src != a)                                                              \
+      memcpy(a, src, n * sizeof(T));                                           \
+    free(buf);                                                                 \
+    return DYN_OK;                                                             \
+  }
+
+/* Branchless lower bound over items of type T (direct kernels only). */
+#define DA_SEARCH_KERNEL(NAME, T, KEYLESS)                                     \
+  static size_t NAME##_lower_bound(const void *base, size_t n,                 \
+                                   const void *key, const sort_ctx *c) {       \
+    (void)c;                                                                   \
+    const T *a = (const T *)base;                                              \
+    size_t lo = 0;                                                             \
+    while (n > 1) {                                                            \
+      size_t half = n / 2;                                                     \
+      lo = KEYLESS((const void *)&a[lo + half], key) ? lo + half : lo;         \
+      n -= half;                                                               \
+    }                                                                          \
+    return lo + (n == 1 && KEYLESS((const void *)&a[lo], key));                \
+  }
+
+#define DA_DIRECT(NAME, T, KEYLESS)                                            \
+  DA_SORT_KERNELS(NAME, T, EL_DIRECT, KEYLESS)                                 \
+  DA_SEARCH_KERNEL(NAME, T, KEYLESS)
+
+DA_DIRECT(e4_cmp, uint32_t, KL_CMP)
+DA_DIRECT(e4_i32, uint32_t, KL_I32)
+DA_DIRECT(e4_u32, uint32_t, KL_U32)
+DA_DIRECT(e4_f32, uint32_t, KL_F32)
+
+DA_DIRECT(e8_cmp, uint64_t, KL_CMP)
+DA_DIRECT(e8_i32, uint64_t, KL_I32)
+DA_DIRECT(e8_u32, uint64_t, KL_U32)
+DA_DIRECT(e8_f32, uint64_t, KL_F32)
+DA_DIRECT(e8_i64, uint64_t, KL_I64)
+DA_DIRECT(e8_u64, uint64_t, KL_U64)
+DA_DIRECT(e8_f64, uint64_t, KL_F64)
+
+DA_DIRECT(e16_cmp, item16, KL_CMP)
+DA_DIRECT(e16_i32, item16, KL_I32)
+DA_DIRECT(e16_u32, item16, KL_U32)
+DA_DIRECT(e16_f32, item16, KL_F32)
+DA_DIRECT(e16_i64, item16, KL_I64)
+DA_DIRECT(e16_u64, item16, KL_U64)
+DA_DIRECT(e16_f64, item16, KL_F64)
+
+DA_SORT_KERNELS(ix_cmp, size_t, EL_INDIRECT, KL_CMP)
+DA_SORT_KERNELS(ix_i32, size_t, EL_INDIRECT, KL_I32)
+DA_SORT_KERNELS(ix_u32, size_t, EL_INDIRECT, KL_U32)
+DA_SORT_KERNELS(ix_f32, size_t, EL_INDIRECT, KL_F32)
+DA_SORT_KERNELS(ix_i64, size_t, EL_INDIRECT, KL_I64)
+DA_SORT_KERNELS(ix_u64, size_t, EL_INDIRECT, KL_U64)
+DA_SORT_KERNELS(ix_f64, size_t, EL_INDIRECT, KL_F64)
+
+/* -------------------------
+ * Dispatch table
+ * ------------------------- */
+
+typedef struct {
+  void (*sort)(void *base, size_t n, const sort_ctx *c);
+  int (*stable)(void *base, size_t n, const sort_ctx *c);
+  size_t (*lower_bound)(const void *base, size_t n, const void *key,
+                        const sort_ctx *c);
+} kernel_set;
+
+enum { CLASS_E4, CLASS_E8, CLASS_E16, CLASS_INDIRECT, CLASS_COUNT };
+
+#define KS(NAME) {NAME##_sort, NAME##_stable, NAME##_lower_bound}
+#define KS_IX(NAME) {NAME##_sort, NAME##_stable, NULL}
+
+static const kernel_set kernels[CLASS_COUNT][DA_KEY_COUNT_] = {
+    [CLASS_E4] = {KS(e4_cmp), KS(e4_i32), KS(e4_u32), KS(e4_f32)},
+    [CLASS_E8] = {KS(e8_cmp), KS(e8_i32), KS(e8_u32), KS(e8_f32), KS(e8_i64),
+                  KS(e8_u64), KS(e8_f64)},
+    [CLASS_E16] = {KS(e16_cmp), KS(e16_i32), KS(e16_u32), KS(e16_f32),
+                   KS(e16_i64), KS(e16_u64), KS(e16_f64)},
+    [CLASS_INDIRECT] = {KS_IX(ix_cmp), KS_IX(ix_i32), KS_IX(ix_u32),
+                        KS_IX(ix_f32), KS_IX(ix_i64), KS_IX(ix_u64),
+                        KS_IX(ix_f64)},
+};
+
+#undef KS
+#undef KS_IX
+
+static size_t key_width(da_key_type key) {
+  switch (key) {
+  case DA_KEY_I32:
+  case DA_KEY_U32:
+  case DA_KEY_F32:
+    return 4;
+  case DA_KEY_I64:
+  case DA_KEY_U64:
+  case DA_KEY_F64:
+    return 8;
+  default:
+    return 0;
+  }
+}
+
+static int elem_class(size_t es) {
+  switch (es) {
+  case 4:
+    return CLASS_E4;
+  case 8:
+    return CLASS_E8;
+  case 16:
+    return CLASS_E16;
+  default:
+    return CLASS_INDIRECT;
+  }
+}
+
+/* Validate (cmp, key) against the element size. */
+static bool usable(size_t es, da_cmp_fn cmp, da_key_type key) {
+  if ((unsigned)key >= DA_KEY_COUNT_)
+    return false;
+  if (key == DA_KEY_NONE)
+    return cmp != NULL;
+  return key_width(key) <= es;
+}
+
+/* Generic "x < y" for the paths that are not templated. */
+static bool key_less(const sort_ctx *c, da_key_type key, const void *x,
+                     const void *y) {
+  switch (key) {
+  case DA_KEY_I32:
+    return KL_I32(x, y);
+  case DA_KEY_U32:
+    return KL_U32(x, y);
+  case DA_KEY_F32:
+    return KL_F32(x, y);
+  case DA_KEY_I64:
+    return KL_I64(x, y);
+  case DA_KEY_U64:
+    return KL_U64(x, y);
+  case DA_KEY_F64:
+    return KL_F64(x, y);
+  default:
+    return KL_CMP(x, y);
+  }
+}
+
+/*
+ * Indirect path: sort indices, then move every element to its final slot by
+ * following permutation cycles (one temporary element, each element copied
+ * once).
+ */
+static int sort_indirect(DynamicArray *da, da_cmp_fn cmp, da_key_type key,
+                         bool stable) {
+  size_t n = da_size(da), es = da_elem_size(da);
+  unsigned char *base = da_data(da);
+  size_t *idx = malloc(n * sizeof(*idx));
+  unsigned char *tmp = malloc(es);
+  if (!idx || !tmp) {
+    free(idx);
+    free(tmp);
+    return DYN_ERR_OOM;
+  }
+  for (size_t i = 0; i < n; ++i)
+    idx[i] = i;
+
+  sort_ctx c = {cmp, base, es};
+  const kernel_set *k = &kernels[CLASS_INDIRECT][key];
+  int st = DYN_OK;
+  if (stable)
+    st = k->stable(idx, n, &c);
+  else
+    k->sort(idx, n, &c);
+
+  if (st == DYN_OK) {
+    for (size_t i = 0; i < n; ++i) {
+      if (idx[i] == i)
+        continue;
+      memcpy(tmp, base + i * es, es);
+      size_t j = i;
+      while (idx[j] != i) {
+        size_t from = idx[j];
+        memcpy(base + j * es, base + from * es, es);
+        idx[j] = j;
+        j = from;
+      }
+      memcpy(base + j * es, tmp, es);
+      idx[j] = j;
+    }
+  }
+  free(tmp);
+  free(idx);
+  return st;
+}
+
+static int sort_common(DynamicArray *da, da_cmp_fn cmp, da_key_type key,
+                       bool stable) {
+  if (!da)
+    return DYN_ERR_INVAL;
+  size_t es = da_elem_size(da);
+  if (!usable(es, cmp, key))
+    return DYN_ERR_INVAL;
+  size_t n = da_size(da);
+  if (n < 2)
+    return DYN_OK;
+
+  int cls = elem_class(es);
+  if (cls == CLASS_INDIRECT)
+    return sort_indirect(da, cmp, key, stable);
+
+  sort_ctx c = {cmp, NULL, es};
+  const kernel_set *k = &kernels[cls][key];
+  if (stable)
+    return k->stable(da_data(da), n, &c);
+  k->sort(da_data(da), n, &c);
+  return DYN_OK;
+}
+
+/* -------------------------
+ * Public API
+ * ------------------------- */
+
+int da_sort(DynamicArray *da, da_cmp_fn cmp, da_key_type key) {
+  return sort_common(da, cmp, key, false);
+}
+
+int da_stable_sort(DynamicArray *da, da_cmp_fn cmp, da_key_type key) {
+  return sort_common(da, cmp, key, true);
+}
+
+int da_lower_bound(const DynamicArray *da, const void *key, da_cmp_fn cmp,
+                   da_key_type hint, size_t *out_index) {
+  if (!da || !key || !out_index)
+    return DYN_ERR_INVAL;
+  size_t es = da_elem_size(da);
+  if (!usable(es, cmp, hint))
+    return DYN_ERR_INVAL;
+
+  size_t n = da_size(da);
+  sort_ctx c = {cmp, NULL, es};
+  int cls = elem_class(es);
+  if (cls != CLASS_INDIRECT) {
+    *out_index = kernels[cls][hint].lower_bound(da_cdata(da), n, key, &c);
+    return DYN_OK;
+  }
+
+  /* arbitrary element size: same branchless search with a byte stride */
+  const unsigned char *a = da_cdata(da);
+  size_t lo = 0;
+  while (n > 1) {
+    size_t half = n / 2;
+    lo = key_less(&c, hint, a + (lo + half) * es, key) ? lo + half : lo;
+    n -= half;
+  }
+  *out_index = lo + (n == 1 && key_less(&c, hint, a + lo * es, key));
+  return DYN_OK;
+}
+
+int da_unique(DynamicArray *da, da_cmp_fn cmp, da_key_type hint) {
+  if (!da)
+    return DYN_ERR_INVAL;
+  size_t es = da_elem_size(da);
+  if (!usable(es, cmp, hint))
+    return DYN_ERR_INVAL;
+  size_t n = da_size(da);
+  if (n < 2)
+    return DYN_OK;
+
+  sort_ctx c = {cmp, NULL, es};
+  unsigned char *a = da_data(da);
+  size_t out = 1; /* a[out - 1] is the last kept element */
+  for (size_t i = 1; i < n; ++i) {
+    const unsigned char *kept = a + (out - 1) * es, *cur = a + i * es;
+    bool equal =
+        !key_less(&c, hint, kept, cur) && !key_less(&c, hint, cur, kept);
+    if (equal)
+      continue;
+    if (out != i)
+      memcpy(a + out * es, cur, es);
+    ++out;
+  }
+  return da_truncate(da, out);
+}
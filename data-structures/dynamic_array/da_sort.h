@@ -0,0 +1,91 @@
+// include/da_sort.h
+#pragma once
+#include <stddef.h>
+
+#include "dynamic_array.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file da_sort.h
+ * @brief Sorting and searching on a DynamicArray, dispatched on element size.
+ *
+ * Every call picks a kernel from (element size, key type):
+ *  - 4, 8 and 16 byte elements are moved as whole machine words / pairs.
+ *  - Any other size is sorted indirectly: an index array is sorted and the
+ *    permutation is then applied in place, so each element moves once.
+ *  - With a key-type hint the comparison is inlined (the key is the leading
+ *    field of the element, at offset 0); otherwise the comparator is called.
+ *
+ * Faster kernels plug in behind the same entry points, so every caller picks
+ * them up without changes.
+ */
+
+/** Comparator: <0, 0, >0 like qsort. */
+typedef int (*da_cmp_fn)(const void *a, const void *b);
+
+/**
+ * Key-type hint: the element starts with a key of this type. Floating point
+ * keys must not be NaN.
+ */
+typedef enum {
+  DA_KEY_NONE = 0, /**< use the comparator */
+  DA_KEY_I32,
+  DA_KEY_U32,
+  DA_KEY_F32,
+  DA_KEY_I64,
+  DA_KEY_U64,
+  DA_KEY_F64,
+  DA_KEY_COUNT_ /**< number of key types (not a valid hint) */
+} da_key_type;
+
+/**
+ * @brief Sort ascending (not stable). Introsort, O(n log n) worst case.
+ *
+ * @param cmp Comparator, required when @p key is DA_KEY_NONE and ignored
+ *        otherwise.
+ * @param key Key-type hint or DA_KEY_NONE.
+ * @return DYN_OK, DYN_ERR_INVAL if no usable comparison is given or the key
+ *         is wider than the element, DYN_ERR_OOM (indirect path only).
+ */
+int da_sort(DynamicArray *da, da_cmp_fn cmp, da_key_type key);
+
+/**
+ * @brief Sort ascending keeping equal elements in their original order.
+ *
+ * Bottom-up merge sort with an n-element scratch buffer.
+ *
+ * @return Same codes as da_sort(); DYN_ERR_OOM if the buffer can't be
+ *         allocated.
+ */
+int da_stable_sort(DynamicArray *da, da_cmp_fn cmp, da_key_type key);
+
+/**
+ * @brief Index of the first element not less than @p key (binary search).
+ *
+ * With a key-type hint @p key points to a value of that type; otherwise it is
+ * passed as the second argument of @p cmp. The array must be sorted by the
+ * same ordering.
+ *
+ * @param out_index Receives the index, da_size(da) if every element is less.
+ * @return DYN_OK or DYN_ERR_INVAL.
+ */
+int da_lower_bound(const DynamicArray *da, const void *key, da_cmp_fn cmp,
+                   da_key_type hint, size_t *out_index);
+
+/**
+ * @brief Remove consecutive equal elements, keeping the first of each run.
+ *
+ * Equality is "neither orders before the other" under the same cmp / key
+ * rules as da_sort. Sort first to remove all duplicates. The array is
+ * truncated to the unique prefix.
+ *
+ * @return DYN_OK or DYN_ERR_INVAL.
+ */
+int da_unique(DynamicArray *da, da_cmp_fn cmp, da_key_type hint);
+
+#ifdef __cplusplus
+}
+#endif
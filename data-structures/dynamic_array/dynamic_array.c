@@ -24,9 +24,117 @@ struct DynamicArray {
   size_t capacity;  /* capacity in elements */
   size_t elem_size; /* element size in bytes */
   void *data;       /* pointer to storage (either sbo or a heap block) */
+#ifdef DA_STATS
+  da_stats stats;        /* per-array counters */
+  const char *tag;       /* optional label for da_stats_dump */
+  DynamicArray *reg_prev; /* registry links (guarded by registry_lock) */
+  DynamicArray *reg_next;
+#endif
   alignas(max_align_t) unsigned char sbo[DA_INLINE_BYTES];
 };
 
+/*
+ * Instrumentation. With DA_STATS every array registers itself in a global
+ * intrusive list on creation; counters are folded into `retired` on
+ * destruction so totals survive the array. The registry is guarded by a
+ * spinlock (creation/destruction are rare next to push_back). Without
+ * DA_STATS every stat_* hook is an empty inline and vanishes.
+ */
+#ifdef DA_STATS
+#include <stdatomic.h>
+
+static atomic_flag registry_lock = ATOMIC_FLAG_INIT;
+static DynamicArray *registry_head;
+static size_t registry_count;
+static da_stats retired; /* counters of destroyed arrays */
+
+static void registry_acquire(void) {
+  while (atomic_flag_test_and_set_explicit(&registry_lock,
+                                           memory_order_acquire))
+    ;
+}
+
+static void registry_release(void) {
+  atomic_flag_clear_explicit(&registry_lock, memory_order_release);
+}
+
+static inline size_t max_size_t(size_t a, size_t b) { return a > b ? a : b; }
+
+static size_t wasted_bytes(const DynamicArray *da) {
+  if (da->data == da->sbo)
+    return 0; /* inline storage costs nothing extra */
+  return (da->capacity - da->size) * da->elem_size;
+}
+
+static void stat_register(DynamicArray *da) {
+  memset(&da->stats, 0, sizeof(da->stats));
+  da->stats.peak_capacity = da->capacity;
+  da->stats.peak_bytes = da->capacity * da->elem_size;
+  da->tag = NULL;
+  da->reg_prev = NULL;
+  registry_acquire();
+  da->reg_next = registry_head;
+  if (registry_head)
+    registry_head->reg_prev = da;
+  registry_head = da;
+  ++registry_count;
+  registry_release();
+}
+
+static void stat_unregister(DynamicArray *da) {
+  registry_acquire();
+  if (da->reg_prev)
+    da->reg_prev->reg_next = da->reg_next;
+  else
+    registry_head = da->reg_next;
+  if (da->reg_next)
+    da->reg_next->reg_prev = da->reg_prev;
+  --registry_count;
+  retired.growth_events += da->stats.growth_events;
+  retired.shrink_events += da->stats.shrink_events;
+  retired.bytes_copied += da->stats.bytes_copied;
+  retired.sbo_to_heap += da->stats.sbo_to_heap;
+  retired.peak_size = max_size_t(retired.peak_size, da->stats.peak_size);
+  retired.peak_capacity =
+      max_size_t(retired.peak_capacity, da->stats.peak_capacity);
+  retired.peak_bytes = max_size_t(retired.peak_bytes, da->stats.peak_bytes);
+  registry_release();
+}
+
+static inline void stat_grow(DynamicArray *da, size_t copied, bool from_sbo) {
+  ++da->stats.growth_events;
+  da->stats.bytes_copied += copied;
+  if (from_sbo)
+    ++da->stats.sbo_to_heap;
+  da->stats.peak_capacity = max_size_t(da->stats.peak_capacity, da->capacity);
+  da->stats.peak_bytes =
+      max_size_t(da->stats.peak_bytes, da->capacity * da->elem_size);
+}
+
+static inline void stat_shrink(DynamicArray *da, size_t copied) {
+  ++da->stats.shrink_events;
+  da->stats.bytes_copied += copied;
+}
+
+static inline void stat_size(DynamicArray *da) {
+  if (da->size > da->stats.peak_size)
+    da->stats.peak_size = da->size;
+}
+#else
+static inline void stat_register(DynamicArray *da) { (void)da; }
+static inline void stat_unregister(DynamicArray *da) { (void)da; }
+static inline void stat_grow(DynamicArray *da, size_t copied, bool from_sbo) {
+  (void)da;
+  (void)copied;
+  (void)from_sbo;
+}
+static inline void stat_shrink(DynamicArray *da, size_t copied) {
+  (void)da;
+  (void)copied;
+}
+static inline void stat_size(DynamicArray *da) { (void)da; }
+#endif
+
 /* Helper: check multiplication overflow for a * b */
 static inline bool mul_overflow_size_t(size_t a, size_t b) {
   if (a == 0 || b == 0)
@@ -77,6 +185,7 @@ DynamicArray *da_create(size_t elem_size) {
       return NULL;
     }
   }
+  stat_register(da);
   return da;
 }
 
@@ -84,6 +193,7 @@ DynamicArray *da_create(size_t elem_size) {
 void da_destroy(DynamicArray *da) {
   if (!da)
     return;
+  stat_unregister(da);
   if (da->data && da->data != da->sbo)
     free(da->data);
   free(da);
@@ -103,6 +213,30 @@ void da_clear(DynamicArray *da) {
   da->size = 0;
 }
 
+/* Shrink logical size to new_size (<= size). Storage is untouched. */
+int da_truncate(DynamicArray *da, size_t new_size) {
+  if (!da)
+    return DYN_ERR_INVAL;
+  if (new_size > da->size)
+    return DYN_ERR_RANGE;
+  da->size = new_size;
+  return DYN_OK;
+}
+
+/*
+ * Commit count elements that the caller wrote into reserved capacity.
+ * Returns DYN_ERR_RANGE if they do not fit below capacity.
+ */
+int da_append_reserved(DynamicArray *da, size_t count) {
+  if (!da)
+    return DYN_ERR_INVAL;
+  if (count > da->capacity - da->size)
+    return DYN_ERR_RANGE;
+  da->size += count;
+  stat_size(da);
+  return DYN_OK;
+}
+
 /*
  * Ensure capacity >= min_capacity (in elements).
  * May allocate/move storage. Returns DYN_OK, or an error code.
@@ -144,14 +278,19 @@ int da_reserve(DynamicArray *da, size_t min_capacity) {
       memcpy(heap, da->sbo, used_bytes);
     da->data = heap;
     da->capacity = new_cap;
+    stat_grow(da, used_bytes, true);
     return DYN_OK;
   } else {
     /* heap -> realloc (preserve old block if realloc fails) */
+    uintptr_t old_addr = (uintptr_t)da->data;
     void *tmp = realloc(da->data, new_bytes);
     if (!tmp)
       return DYN_ERR_OOM;
     da->data = tmp;
     da->capacity = new_cap;
+    /* realloc only copies when it had to move the block */
+    stat_grow(da, (uintptr_t)tmp != old_addr ? da->size * da->elem_size : 0,
+              false);
     return DYN_OK;
   }
 }
@@ -174,6 +313,7 @@ int da_shrink_to_fit(DynamicArray *da) {
                        : 1;
     if (da->capacity == 0)
       da->capacity = 1;
+    stat_shrink(da, 0);
     return DYN_OK;
   }
 
@@ -189,14 +329,19 @@ int da_shrink_to_fit(DynamicArray *da) {
     da->capacity = (DA_INLINE_BYTES / da->elem_size);
     if (da->capacity == 0)
       da->capacity = 1;
+    stat_shrink(da, need_bytes);
     return DYN_OK;
   } else {
     /* shrink heap block to exactly the needed bytes */
+    if (da->capacity == da->size)
+      return DYN_OK; /* already exact: nothing to shrink */
+    uintptr_t old_addr = (uintptr_t)da->data;
     void *tmp = realloc(da->data, need_bytes);
     if (!tmp)
       return DYN_ERR_OOM;
     da->data = tmp;
     da->capacity = da->size;
+    stat_shrink(da, (uintptr_t)tmp != old_addr ? need_bytes : 0);
     return DYN_OK;
   }
 }
@@ -232,6 +377,33 @@ int da_push_back(DynamicArray *da, const void *elem) {
   unsigned char *base = (unsigned char *)da->data;
   memcpy(base + offset, elem, da->elem_size);
   ++da->size;
+  stat_size(da);
+  return DYN_OK;
+}
+
+/*
+ * Append `count` contiguous elements. One reservation, one memcpy.
+ */
+int da_push_back_n(DynamicArray *da, const void *elems, size_t count) {
+  if (!da || (!elems && count))
+    return DYN_ERR_INVAL;
+  if (count == 0)
+    return DYN_OK;
+  if (count > SIZE_MAX - da->size)
+    return DYN_ERR_OVERFLOW;
+
+  int st = da_reserve(da, da->size + count);
+  if (st != DYN_OK)
+    return st;
+
+  size_t bytes;
+  st = bytes_for_count(count, da->elem_size, &bytes);
+  if (st != DYN_OK)
+    return st;
+  unsigned char *base = (unsigned char *)da->data;
+  memcpy(base + da->size * da->elem_size, elems, bytes);
+  da->size += count;
+  stat_size(da);
   return DYN_OK;
 }
 
@@ -264,3 +436,101 @@ void *da_back(DynamicArray *da) {
   unsigned char *base = (unsigned char *)da->data;
   return base + ((da->size - 1) * da->elem_size);
 }
+
+/* -------------------------
+ * Instrumentation
+ * ------------------------- */
+
+#ifdef DA_STATS
+int da_get_stats(const DynamicArray *da, da_stats *out) {
+  if (!da || !out)
+    return DYN_ERR_INVAL;
+  *out = da->stats;
+  out->wasted_bytes = wasted_bytes(da);
+  out->live_arrays = 0;
+  return DYN_OK;
+}
+
+int da_get_global_stats(da_stats *out) {
+  if (!out)
+    return DYN_ERR_INVAL;
+  registry_acquire();
+  *out = retired;
+  out->wasted_bytes = 0;
+  for (const DynamicArray *da = registry_head; da; da = da->reg_next) {
+    out->growth_events += da->stats.growth_events;
+    out->shrink_events += da->stats.shrink_events;
+    out->bytes_copied += da->stats.bytes_copied;
+    out->sbo_to_heap += da->stats.sbo_to_heap;
+    out->peak_size = max_size_t(out->peak_size, da->stats.peak_size);
+    out->peak_capacity =
+        max_size_t(out->peak_capacity, da->stats.peak_capacity);
+    out->peak_bytes = max_size_t(out->peak_bytes, da->stats.peak_bytes);
+    out->wasted_bytes += wasted_bytes(da);
+  }
+  out->live_arrays = registry_count;
+  registry_release();
+  return DYN_OK;
+}
+
+void da_set_tag(DynamicArray *da, const char *tag) {
+  if (da)
+    da->tag = tag;
+}
+
+void da_stats_dump(FILE *out) {
+  if (!out)
+    return;
+  fprintf(out, "%-20s %6s %10s %10s %8s %12s %6s %10s %12s\n", "array",
+          "elem", "size", "capacity", "growths", "copied", "sbo>h", "reserve",
+          "wasted");
+  registry_acquire();
+  for (const DynamicArray *da = registry_head; da; da = da->reg_next) {
+    char name[21];
+    if (da->tag)
+      snprintf(name, sizeof(name), "%s", da->tag);
+    else
+      snprintf(name, sizeof(name), "%p", (const void *)da);
+    fprintf(out, "%-20s %6zu %10zu %10zu %8llu %12llu %6llu %10zu %12zu\n",
+            name, da->elem_size, da->size, da->capacity,
+            (unsigned long long)da->stats.growth_events,
+            (unsigned long long)da->stats.bytes_copied,
+            (unsigned long long)da->stats.sbo_to_heap, da->stats.peak_size,
+            wasted_bytes(da));
+  }
+  registry_release();
+
+  da_stats g;
+  da_get_global_stats(&g);
+  fprintf(out,
+          "total: %zu live, %llu growths, %llu shrinks, %llu bytes copied, "
+          "%llu sbo->heap, peak %zu bytes, %zu bytes wasted\n",
+          g.live_arrays, (unsigned long long)g.growth_events,
+          (unsigned long long)g.shrink_events,
+          (unsigned long long)g.bytes_copied,
+          (unsigned long long)g.sbo_to_heap, g.peak_bytes, g.wasted_bytes);
+}
+#else
+int da_get_stats(const DynamicArray *da, da_stats *out) {
+  (void)da;
+  if (out)
+    memset(out, 0, sizeof(*out));
+  return DYN_ERR_INVAL;
+}
+
+int da_get_global_stats(da_stats *out) {
+  if (out)
+    memset(out, 0, sizeof(*out));
+  return DYN_ERR_INVAL;
+}
+
+void da_set_tag(DynamicArray *da, const char *tag) {
+  (void)da;
+  (void)tag;
+}
+
+void da_stats_dump(FILE *out) {
+  if (out)
+    fputs("da_stats: library built without DA_STATS\n", out);
+}
+#endif
@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,7 +47,8 @@ typedef enum {
   DYN_ERR_INVAL =
       -3, /**< invalid argument (NULL pointer, zero elem_size, etc.) */
   DYN_ERR_RANGE =
-      -4 /**< index out of range (used by e.g. da_pop_back on empty) */
+      -4, /**< index out of range (used by e.g. da_pop_back on empty) */
+  DYN_ERR_IO = -5 /**< I/O callback failed or stream truncated/corrupt */
 } da_status;
 
 /* -------------------------
@@ -103,6 +105,28 @@ size_t da_elem_size(const DynamicArray *da);
  */
 void da_clear(DynamicArray *da);
 
+/**
+ * @brief Drop trailing elements so that size becomes @p new_size.
+ *
+ * O(1); capacity and the bytes of the dropped elements are left untouched.
+ *
+ * @return DYN_OK, DYN_ERR_RANGE if new_size > da_size(da),
+ *         DYN_ERR_INVAL if da == NULL.
+ */
+int da_truncate(DynamicArray *da, size_t new_size);
+
+/**
+ * @brief Grow size by @p count elements already written past the end.
+ *
+ * For filling reserved capacity in place: write into
+ * `(char *)da_data(da) + da_size(da) * da_elem_size(da)`, then commit the
+ * elements here instead of copying them in with da_push_back_n. O(1).
+ *
+ * @return DYN_OK, DYN_ERR_RANGE if size + count would exceed capacity,
+ *         DYN_ERR_INVAL if da == NULL.
+ */
+int da_append_reserved(DynamicArray *da, size_t count);
+
 /* -------------------------
  * Capacity management
  * ------------------------- */
@@ -157,6 +181,16 @@ int da_shrink_to_fit(DynamicArray *da);
  */
 int da_push_back(DynamicArray *da, const void *elem);
 
+/**
+ * @brief Append @p count elements stored contiguously at @p elems.
+ *
+ * Equivalent to @p count calls to da_push_back() but grows the storage at
+ * most once and copies with a single memcpy.
+ *
+ * @return Same codes as da_push_back(). @p elems may be NULL if count == 0.
+ */
+int da_push_back_n(DynamicArray *da, const void *elems, size_t count);
+
 /**
  * @brief Remove the last element.
  *
@@ -192,6 +226,60 @@ void *da_data(DynamicArray *da);
  */
 const void *da_cdata(const DynamicArray *da);
 
+/* -------------------------
+ * Instrumentation (optional)
+ * ------------------------- */
+
+/**
+ * Allocation / copy counters. Only collected when the library is compiled
+ * with -DDA_STATS; otherwise the hooks compile to nothing and the functions
+ * below report DYN_ERR_INVAL with zeroed output.
+ *
+ * For a single array every field describes that array. For the global view
+ * the event counters (growth_events .. sbo_to_heap) include arrays that have
+ * already been destroyed, the peaks are maxima over all arrays ever created
+ * and wasted_bytes is summed over the arrays that are still alive.
+ */
+typedef struct {
+  uint64_t growth_events; /**< capacity increases (da_reserve / push) */
+  uint64_t shrink_events; /**< da_shrink_to_fit calls that shrank the heap */
+  uint64_t bytes_copied;  /**< bytes moved by growth or shrink */
+  uint64_t sbo_to_heap;   /**< inline -> heap transitions */
+  size_t peak_size;       /**< largest size reached (elements) */
+  size_t peak_capacity;   /**< largest capacity reached (elements) */
+  size_t peak_bytes;      /**< largest capacity reached (bytes) */
+  size_t wasted_bytes;    /**< (capacity - size) * elem_size on the heap */
+  size_t live_arrays;     /**< global only: arrays currently registered */
+} da_stats;
+
+/**
+ * @brief Read the counters of one array.
+ * @return DYN_OK, or DYN_ERR_INVAL if an argument is NULL or DA_STATS is off.
+ */
+int da_get_stats(const DynamicArray *da, da_stats *out);
+
+/**
+ * @brief Read the process-wide counters (see da_stats for semantics).
+ * @return DYN_OK, or DYN_ERR_INVAL if out is NULL or DA_STATS is off.
+ */
+int da_get_global_stats(da_stats *out);
+
+/**
+ * @brief Attach a label shown by da_stats_dump (e.g. "log-lines").
+ *
+ * The string is not copied and must outlive the array. No-op without
+ * DA_STATS.
+ */
+void da_set_tag(DynamicArray *da, const char *tag);
+
+/**
+ * @brief Print every live array and the global totals to @p out.
+ *
+ * The "reserve" column is the peak size reached: passing it to da_reserve
+ * right after da_create would have avoided every growth event.
+ */
+void da_stats_dump(FILE *out);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,559 @@
+// src/lsm_array.c
+#include "lsm_array.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Implementation notes:
+ *  - A run is a pair of DynamicArrays: the elements, sorted with strictly
+ *    increasing keys, and one tombstone byte per element. Searching the
+ *    elements array directly lets da_lower_bound use its fast kernels.
+ *  - Runs are ordered by age: the buffer is the newest, then level 0,
+ *    level 1, ... For a key, the first run holding it decides.
+ *  - Merges build new arrays and only replace the old runs once every
+ *    step has succeeded, so an allocation failure leaves the container as
+ *    it was.
+ */
+
+typedef struct {
+  DynamicArray *elems; /* NULL: empty level */
+  DynamicArray *tombs; /* uint8_t, 1 = tombstone */
+} Run;
+
+struct LsmArray {
+  size_t es;
+  da_cmp_fn cmp;
+  da_key_type hint;
+  Run buffer; /* always allocated, capacity LSM_BUFFER */
+  Run level[LSM_MAX_LEVELS];
+};
+
+/* -------------------------
+ * Runs
+ * ------------------------- */
+
+static size_t run_size(const Run *r) {
+  return r->elems ? da_size(r->elems) : 0;
+}
+
+static const unsigned char *run_elem(const LsmArray *t, const Run *r,
+                                     size_t i) {
+  return (const unsigned char *)da_cdata(r->elems) + i * t->es;
+}
+
+static bool run_tomb(const Run *r, size_t i) {
+  return ((const uint8_t *)da_cdata(r->tombs))[i] != 0;
+}
+
+static void run_free(Run *r) {
+  da_destroy(r->elems);
+  da_destroy(r->tombs);
+  r->elems = r->tombs = NULL;
+}
+
+static int run_alloc(const LsmArray *t, Run *r, size_t capacity) {
+  r->elems = da_create(t->es);
+  r->tombs = da_create(1);
+  if (!r->elems || !r->tombs || da_reserve(r->elems, capacity) != DYN_OK ||
+      da_reserve(r->tombs, capacity) != DYN_OK) {
+    run_free(r);
+    return DYN_ERR_OOM;
+  }
+  return DYN_OK;
+}
+
+/* -------------------------
+ * Comparison
+ * ------------------------- */
+
+#define LSM_CMP_KEY(T)                                                         \
+  do {                                                                         \
+    T x, y;                                                                    \
+    memcpy(&x, a, sizeof x);                                                   \
+    memcpy(&y, b, sizeof y);                                                   \
+    return (x > y) - (x < y);                                                  \
+  } while (0)
+
+static int compare(const LsmArray *t, const void *a, const void *b) {
+  switch (t->hint) {
+  case DA_KEY_I32:
+    LSM_CMP_KEY(int32_t);
+  case DA_KEY_U32:
+    LSM_CMP_KEY(uint32_t);
+  case DA_KEY_F32:
+    LSM_CMP_KEY(float);
+  case DA_KEY_I64:
+    LSM_CMP_KEY(int64_t);
+  case DA_KEY_U64:
+    LSM_CMP_KEY(uint64_t);
+  case DA_KEY_F64:
+    LSM_CMP_KEY(double);
+  default:
+    return t->cmp(a, b);
+  }
+}
+
+#undef LSM_CMP_KEY
+
+static size_t key_width(da_key_type key) {
+  switch (key) {
+  case DA_KEY_I32:
+  case DA_KEY_U32:
+  case DA_KEY_F32:
+    return 4;
+  case DA_KEY_NONE:
+    return 0;
+  default:
+    return 8;
+  }
+}
+
+static size_t lower_bound(const LsmArray *t, const Run *r, const void *key) {
+  size_t at = 0;
+  da_lower_bound(r->elems, key, t->cmp, t->hint, &at); /* args validated */
+  return at;
+}
+
+/* -------------------------
+ * Merging
+ * ------------------------- */
+
+/* True if no level below @p level holds data, so tombstones merged into
+ * @p level have nothing left to hide. */
+static bool oldest_from(const LsmArray *t, size_t level) {
+  for (size_t j = level + 1; j < LSM_MAX_LEVELS; ++j)
+    if (run_size(&t->level[j]) > 0)
+      return false;
+  return true;
+}
+
+/* Merge two runs into a new one. On equal keys the newer entry is kept.
+ * @p older may be empty. */
+static int merge_runs(const LsmArray *t, const Run *older, const Run *newer,
+                      bool drop_tombs, Run *out) {
+  size_t no = run_size(older), nn = run_size(newer);
+  int rc = run_alloc(t, out, no + nn);
+  if (rc != DYN_OK)
+    return rc;
+
+  size_t i = 0, j = 0;
+  while (i < no || j < nn) {
+    const Run *from;
+    size_t at;
+    if (j == nn) {
+      from = older, at = i++;
+    } else if (i == no) {
+      from = newer, at = j++;
+    } else {
+      int c = compare(t, run_elem(t, older, i), run_elem(t, newer, j));
+      if (c < 0) {
+        from = older, at = i++;
+      } else {
+        from = newer, at = j++;
+        i += c == 0; /* shadowed */
+      }
+    }
+    uint8_t tomb = run_tomb(from, at);
+    if (tomb && drop_tombs)
+      continue;
+    /* reserved above: cannot fail */
+    da_push_back(out->elems, run_elem(t, from, at));
+    da_push_back(out->tombs, &tomb);
+  }
+  return DYN_OK;
+}
+
+/*
+ * Carry @p in down the levels: merge it with each occupied level until it
+ * fits an emptied one. On success the levels it passed are freed and *in
+ * is consumed (installed, or freed after merging); on failure nothing
+ * changes.
+ */
+static int push_run(LsmArray *t, Run *in) {
+  Run r = *in;
+  bool temp = false; /* r was built here, not *in */
+  size_t i = 0;
+  for (;; ++i) {
+    if (i == LSM_MAX_LEVELS) {
+      if (temp)
+        run_free(&r);
+      return DYN_ERR_OVERFLOW;
+    }
+    if (run_size(&t->level[i]) > 0) {
+      Run m;
+      int rc = merge_runs(t, &t->level[i], &r, oldest_from(t, i), &m);
+      if (temp)
+        run_free(&r);
+      if (rc != DYN_OK)
+        return rc;
+      r = m;
+      temp = true;
+    }
+    if (run_size(&r) <= (size_t)LSM_BUFFER << i)
+      break;
+  }
+
+  for (size_t j = 0; j <= i; ++j)
+    run_free(&t->level[j]);
+  t->level[i] = r;
+  if (temp)
+    run_free(in);
+  in->elems = in->tombs = NULL;
+  return DYN_OK;
+}
+
+static int flush(LsmArray *t) {
+  if (run_size(&t->buffer) == 0)
+    return DYN_OK;
+  Run fresh;
+  int rc = run_alloc(t, &fresh, LSM_BUFFER);
+  if (rc != DYN_OK)
+    return rc;
+  rc = push_run(t, &t->buffer);
+  if (rc != DYN_OK) {
+    run_free(&fresh);
+    return rc;
+  }
+  t->buffer = fresh;
+  return DYN_OK;
+}
+
+/* -------------------------
+ * Buffer
+ * ------------------------- */
+
+static bool levels_empty(const LsmArray *t) {
+  return run_size(&t->level[0]) == 0 && oldest_from(t, 0);
+}
+
+static int buffer_put(LsmArray *t, const void *elem, uint8_t tomb) {
+  Run *b = &t->buffer;
+  size_t n = run_size(b), at = lower_bound(t, b, elem);
+  unsigned char *elems = da_data(b->elems);
+  uint8_t *tombs = da_data(b->tombs);
+  if (at < n && compare(t, elems + at * t->es, elem) == 0) {
+    memcpy(elems + at * t->es, elem, t->es);
+    tombs[at] = tomb;
+    return DYN_OK;
+  }
+
+  if (n == LSM_BUFFER) {
+    int rc = flush(t);
+    if (rc != DYN_OK)
+      return rc;
+    n = at = 0;
+  }
+  /* capacity reserved by run_alloc: no reallocation */
+  da_push_back(b->elems, elem);
+  da_push_back(b->tombs, &tomb);
+  elems = da_data(b->elems);
+  tombs = da_data(b->tombs);
+  memmove(elems + (at + 1) * t->es, elems + at * t->es, (n - at) * t->es);
+  memmove(tombs + at + 1, tombs + at, n - at);
+  memcpy(elems + at * t->es, elem, t->es);
+  tombs[at] = tomb;
+  return DYN_OK;
+}
+
+/* Stable sort, then keep the last element of each run of equal keys. */
+static int batch_run(const LsmArray *t, const void *elems, size_t count,
+                     Run *out) {
+  int rc = run_alloc(t, out, count);
+  if (rc == DYN_OK)
+    rc = da_push_back_n(out->elems, elems, count);
+  if (rc == DYN_OK)
+    rc = da_stable_sort(out->elems, t->cmp, t->hint);
+  if (rc != DYN_OK) {
+    run_free(out);
+    return rc;
+  }
+
+  unsigned char *a = da_data(out->elems);
+  size_t kept = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (i + 1 < count && compare(t, a + i * t->es, a + (i + 1) * t->es) == 0)
+      continue;
+    if (kept != i)
+      memcpy(a + kept * t->es, a + i * t->es, t->es);
+    ++kept;
+  }
+  da_truncate(out->elems, kept);
+  uint8_t live = 0;
+  for (size_t i = 0; i < kept; ++i)
+    da_push_back(out->tombs, &live);
+  return DYN_OK;
+}
+
+/* -------------------------
+ * Public API
+ * ------------------------- */
+
+LsmArray *lsm_create(size_t elem_size, da_cmp_fn cmp, da_key_type key) {
+  if (elem_size == 0 || (unsigned)key >= DA_KEY_COUNT_ ||
+      (key == DA_KEY_NONE && !cmp) || key_width(key) > elem_size)
+    return NULL;
+
+  LsmArray *t = calloc(1, sizeof *t);
+  if (!t)
+    return NULL;
+  t->es = elem_size;
+  t->cmp = cmp;
+  t->hint = key;
+  if (run_alloc(t, &t->buffer, LSM_BUFFER) != DYN_OK) {
+    free(t);
+    return NULL;
+  }
+  return t;
+}
+
+void lsm_destroy(LsmArray *t) {
+  if (!t)
+    return;
+  run_free(&t->buffer);
+  for (size_t i = 0; i < LSM_MAX_LEVELS; ++i)
+    run_free(&t->level[i]);
+  free(t);
+}
+
+int lsm_insert(LsmArray *t, const void *elem) {
+  if (!t || !elem)
+    return DYN_ERR_INVAL;
+  return buffer_put(t, elem, 0);
+}
+
+int lsm_insert_n(LsmArray *t, const void *elems, size_t count) {
+  if (!t || (!elems && count > 0))
+    return DYN_ERR_INVAL;
+  if (count < LSM_BUFFER) {
+    const unsigned char *p = elems;
+    for (size_t i = 0; i < count; ++i) {
+      int rc = buffer_put(t, p + i * t->es, 0);
+      if (rc != DYN_OK)
+        return rc;
+    }
+    return DYN_OK;
+  }
+
+  Run b;
+  int rc = batch_run(t, elems, count, &b);
+  if (rc != DYN_OK)
+    return rc;
+  bool merged = run_size(&t->buffer) > 0;
+  if (merged) { /* the buffer is older than the batch */
+    Run m;
+    rc = merge_runs(t, &t->buffer, &b, levels_empty(t), &m);
+    run_free(&b);
+    if (rc != DYN_OK)
+      return rc;
+    b = m;
+  }
+  rc = push_run(t, &b);
+  if (rc != DYN_OK) {
+    run_free(&b);
+    return rc;
+  }
+  if (merged) {
+    da_clear(t->buffer.elems);
+    da_clear(t->buffer.tombs);
+  }
+  return DYN_OK;
+}
+
+int lsm_erase(LsmArray *t, const void *key) {
+  if (!t || !key)
+    return DYN_ERR_INVAL;
+  if (!levels_empty(t))
+    return buffer_put(t, key, 1);
+
+  /* nothing older to hide: remove from the buffer outright */
+  Run *b = &t->buffer;
+  size_t n = run_size(b), at = lower_bound(t, b, key);
+  unsigned char *elems = da_data(b->elems);
+  uint8_t *tombs = da_data(b->tombs);
+  if (at == n || compare(t, elems + at * t->es, key) != 0)
+    return DYN_OK;
+  memmove(elems + at * t->es, elems + (at + 1) * t->es, (n - at - 1) * t->es);
+  memmove(tombs + at, tombs + at + 1, n - at - 1);
+  da_truncate(b->elems, n - 1);
+  da_truncate(b->tombs, n - 1);
+  return DYN_OK;
+}
+
+int lsm_compact(LsmArray *t) {
+  if (!t)
+    return DYN_ERR_INVAL;
+  int rc = flush(t);
+  if (rc != DYN_OK)
+    return rc;
+
+  /* fold the levels from newest to oldest into acc */
+  Run acc = {NULL, NULL}, empty = {NULL, NULL};
+  size_t runs = 0;
+  for (size_t i = 0; i < LSM_MAX_LEVELS; ++i) {
+    if (run_size(&t->level[i]) == 0)
+      continue;
+    Run m;
+    rc = runs == 0 ? merge_runs(t, &empty, &t->level[i], oldest_from(t, i), &m)
+                   : merge_runs(t, &t->level[i], &acc, oldest_from(t, i), &m);
+    run_free(&acc);
+    if (rc != DYN_OK)
+      return rc;
+    acc = m;
+    ++runs;
+  }
+  if (runs == 0)
+    return DYN_OK;
+
+  for (size_t i = 0; i < LSM_MAX_LEVELS; ++i)
+    run_free(&t->level[i]);
+  size_t i = 0;
+  while (i + 1 < LSM_MAX_LEVELS && run_size(&acc) > (size_t)LSM_BUFFER << i)
+    ++i;
+  t->level[i] = acc;
+  return DYN_OK;
+}
+
+/* -------------------------
+ * Queries
+ * ------------------------- */
+
+/* Runs newest first; returns how many are non-empty. */
+static size_t gather_runs(const LsmArray *t, const Run **runs) {
+  size_t k = 0;
+  if (run_size(&t->buffer) > 0)
+    runs[k++] = &t->buffer;
+  for (size_t i = 0; i < LSM_MAX_LEVELS; ++i)
+    if (run_size(&t->level[i]) > 0)
+      runs[k++] = &t->level[i];
+  return k;
+}
+
+/*
+ * Lower bound of @p key in every run at once. The searches advance in
+ * lockstep, so the cache misses of different runs overlap instead of
+ * queueing up one binary search after another.
+ */
+static void seek_all(const LsmArray *t, const Run **runs, size_t k,
+                     const void *key, size_t *pos) {
+  if (k == 1) { /* compacted: da_lower_bound's kernels are faster */
+    pos[0] = lower_bound(t, runs[0], key);
+    return;
+  }
+  size_t len[LSM_MAX_LEVELS + 1];
+  bool active = false;
+  for (size_t r = 0; r < k; ++r) {
+    pos[r] = 0;
+    len[r] = run_size(runs[r]);
+    active |= len[r] > 1;
+  }
+  while (active) {
+    active = false;
+    for (size_t r = 0; r < k; ++r) {
+      if (len[r] <= 1)
+        continue;
+      size_t half = len[r] / 2;
+      bool less = compare(t, run_elem(t, runs[r], pos[r] + half), key) < 0;
+      pos[r] += less ? half : 0;
+      len[r] -= half;
+      active |= len[r] > 1;
+    }
+  }
+  for (size_t r = 0; r < k; ++r)
+    pos[r] += len[r] == 1 && compare(t, run_elem(t, runs[r], pos[r]), key) < 0;
+}
+
+int lsm_find(const LsmArray *t, const void *key, void *out) {
+  if (!t || !key || !out)
+    return DYN_ERR_INVAL;
+  const Run *runs[LSM_MAX_LEVELS + 1];
+  size_t pos[LSM_MAX_LEVELS + 1];
+  size_t k = gather_runs(t, runs);
+  seek_all(t, runs, k, key, pos);
+  for (size_t r = 0; r < k; ++r) {
+    if (pos[r] == run_size(runs[r]) ||
+        compare(t, run_elem(t, runs[r], pos[r]), key) != 0)
+      continue;
+    if (run_tomb(runs[r], pos[r]))
+      return DYN_ERR_RANGE;
+    memcpy(out, run_elem(t, runs[r], pos[r]), t->es);
+    return DYN_OK;
+  }
+  return DYN_ERR_RANGE;
+}
+
+int lsm_range(const LsmArray *t, const void *lo, const void *hi,
+              lsm_visit_fn visit, void *ctx) {
+  if (!t || !visit)
+    return DYN_ERR_INVAL;
+  const Run *runs[LSM_MAX_LEVELS + 1];
+  size_t pos[LSM_MAX_LEVELS + 1];
+  size_t k = gather_runs(t, runs);
+  if (lo)
+    seek_all(t, runs, k, lo, pos);
+  else
+    memset(pos, 0, k * sizeof *pos);
+
+  for (;;) {
+    /* smallest head; on ties the newest run, which comes first */
+    size_t best = k;
+    for (size_t r = 0; r < k; ++r)
+      if (pos[r] < run_size(runs[r]) &&
+          (best == k || compare(t, run_elem(t, runs[r], pos[r]),
+                                run_elem(t, runs[best], pos[best])) < 0))
+        best = r;
+    if (best == k)
+      break;
+
+    const unsigned char *e = run_elem(t, runs[best], pos[best]);
+    if (hi && compare(t, e, hi) >= 0)
+      break;
+    bool erased = run_tomb(runs[best], pos[best]);
+    for (size_t r = 0; r < k; ++r)
+      if (pos[r] < run_size(runs[r]) &&
+          (r == best || compare(t, run_elem(t, runs[r], pos[r]), e) == 0))
+        ++pos[r];
+    if (!erased && visit(e, ctx))
+      break;
+  }
+  return DYN_OK;
+}
+
+typedef struct {
+  void *out;
+  size_t es;
+  bool found;
+} first_ctx;
+
+static int copy_first(const void *elem, void *ctx) {
+  first_ctx *f = ctx;
+  memcpy(f->out, elem, f->es);
+  f->found = true;
+  return 1;
+}
+
+int lsm_lower_bound(const LsmArray *t, const void *key, void *out) {
+  if (!t || !key || !out)
+    return DYN_ERR_INVAL;
+  first_ctx f = {out, t->es, false};
+  lsm_range(t, key, NULL, copy_first, &f);
+  return f.found ? DYN_OK : DYN_ERR_RANGE;
+}
+
+size_t lsm_entries(const LsmArray *t) {
+  if (!t)
+    return 0;
+  size_t n = run_size(&t->buffer);
+  for (size_t i = 0; i < LSM_MAX_LEVELS; ++i)
+    n += run_size(&t->level[i]);
+  return n;
+}
+
+size_t lsm_run_count(const LsmArray *t) {
+  if (!t)
+    return 0;
+  const Run *runs[LSM_MAX_LEVELS + 1];
+  return gather_runs(t, runs);
+}
@@ -0,0 +1,154 @@
+// include/lsm_array.h
+#pragma once
+#include <stddef.h>
+
+#include "da_sort.h" /* da_cmp_fn, da_key_type */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file lsm_array.h
+ * @brief Sorted container for interleaved inserts and queries, built from
+ * DynamicArrays as a log-structured merge (LSM) hierarchy.
+ *
+ * Layout:
+ *  - an insert buffer of LSM_BUFFER elements, kept sorted by binary
+ *    insertion (the memmoves stay within the small buffer);
+ *  - levels 0, 1, 2, ... each empty or holding one sorted run of at most
+ *    LSM_BUFFER << level elements. A full buffer becomes a run that is
+ *    merged down like a carry in a binary counter: into level 0 if empty,
+ *    otherwise merged with it and carried to level 1, and so on.
+ *
+ * Every element is merged O(log(n / LSM_BUFFER)) times, so inserts cost
+ * amortized O(log n) moves. Queries binary-search the buffer and every
+ * level (at most log2(n / LSM_BUFFER) + 1 runs) in lockstep, so the cache
+ * misses of the runs overlap; after lsm_compact() there is one run.
+ *
+ * Elements form a set ordered by key: inserting an element whose key is
+ * already present replaces the stored one. lsm_erase() records a tombstone
+ * that hides older versions until a merge reaches the oldest level or
+ * lsm_compact() runs, where both are dropped.
+ *
+ * Keys: every `key` argument points to an element whose key is set (other
+ * fields are ignored), with the same cmp / key-type rules as da_sort.h.
+ *
+ * Thread-safety: not thread-safe. Merges run inside the insert that fills
+ * the buffer, not on a background thread.
+ */
+
+/** Insert buffer capacity in elements; level k holds LSM_BUFFER << k. */
+#ifndef LSM_BUFFER
+#define LSM_BUFFER 256
+#endif
+
+/** Number of levels; with the default buffer, room for 2^56 elements. */
+#define LSM_MAX_LEVELS 48
+
+typedef struct LsmArray LsmArray;
+
+/** Range visitor: return nonzero to stop the scan. */
+typedef int (*lsm_visit_fn)(const void *elem, void *ctx);
+
+/* -------------------------
+ * Construction / Destruction
+ * ------------------------- */
+
+/**
+ * @brief Create an empty container.
+ *
+ * @param cmp Comparator, required when @p key is DA_KEY_NONE.
+ * @param key Key-type hint (the element starts with a key of that type) or
+ *        DA_KEY_NONE.
+ * @return New container, or NULL on invalid arguments or allocation failure.
+ */
+LsmArray *lsm_create(size_t elem_size, da_cmp_fn cmp, da_key_type key);
+
+/** @brief Destroy the container and every run. Passing NULL is safe. */
+void lsm_destroy(LsmArray *t);
+
+/* -------------------------
+ * Modifiers
+ * ------------------------- */
+
+/**
+ * @brief Insert (or replace) one element.
+ *
+ * O(log LSM_BUFFER) compares and an O(LSM_BUFFER) memmove; a full buffer
+ * is merged down first.
+ *
+ * @return DYN_OK, DYN_ERR_INVAL, DYN_ERR_OOM or DYN_ERR_OVERFLOW. On error
+ *         the stored elements are unchanged.
+ */
+int lsm_insert(LsmArray *t, const void *elem);
+
+/**
+ * @brief Insert @p count elements at once.
+ *
+ * Batches of LSM_BUFFER or more are stable-sorted into one run (the last
+ * of equal keys wins) and merged down directly instead of going through
+ * the buffer; smaller ones are inserted one by one.
+ *
+ * @return Same codes as lsm_insert().
+ */
+int lsm_insert_n(LsmArray *t, const void *elems, size_t count);
+
+/**
+ * @brief Remove the element with the key of @p key, if any.
+ *
+ * @p key must point to a whole element: its bytes are stored as the
+ * tombstone.
+ *
+ * @return Same codes as lsm_insert().
+ */
+int lsm_erase(LsmArray *t, const void *key);
+
+/**
+ * @brief Merge the buffer and every level into one run, dropping
+ * tombstones and replaced versions. Queries then search a single array.
+ *
+ * @return DYN_OK, DYN_ERR_INVAL or DYN_ERR_OOM (nothing changed).
+ */
+int lsm_compact(LsmArray *t);
+
+/* -------------------------
+ * Queries
+ * ------------------------- */
+
+/**
+ * @brief Copy the element with the key of @p key into @p out.
+ * @return DYN_OK, DYN_ERR_RANGE if absent, DYN_ERR_INVAL.
+ */
+int lsm_find(const LsmArray *t, const void *key, void *out);
+
+/**
+ * @brief Copy the smallest element whose key is not less than @p key.
+ * @return DYN_OK, DYN_ERR_RANGE if there is none, DYN_ERR_INVAL.
+ */
+int lsm_lower_bound(const LsmArray *t, const void *key, void *out);
+
+/**
+ * @brief Visit, in key order, every element with lo <= key < hi.
+ *
+ * The runs are merged on the fly; only the newest version of each key is
+ * visited, and erased keys are skipped.
+ *
+ * @param lo,hi Bounds (elements, as for `key`); NULL means unbounded.
+ * @return DYN_OK or DYN_ERR_INVAL.
+ */
+int lsm_range(const LsmArray *t, const void *lo, const void *hi,
+              lsm_visit_fn visit, void *ctx);
+
+/**
+ * @brief Stored entries, counting tombstones and versions not yet merged
+ * away. Equals the number of elements right after lsm_compact().
+ */
+size_t lsm_entries(const LsmArray *t);
+
+/** @brief Non-empty sorted runs a query searches, the buffer included. */
+size_t lsm_run_count(const LsmArray *t);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,96 @@
+// lsm_example.c
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include "lsm_array.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Interleaved workload: every insert of a random key is followed by one
+ * lower_bound query. Compared with keeping a single sorted DynamicArray and
+ * opening a slot with memmove on each insert.
+ *
+ * Build: gcc -std=c11 -O2 lsm_example.c lsm_array.c da_sort.c dynamic_array.c
+ */
+
+#define COUNT 1000000
+#define BASELINE_COUNT 200000 /* the memmove baseline is quadratic */
+
+typedef struct {
+  uint64_t key;
+  uint64_t value;
+} Entry;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t next_key(uint64_t *s) {
+  *s ^= *s << 13;
+  *s ^= *s >> 7;
+  *s ^= *s << 17;
+  return *s;
+}
+
+static double run_lsm(size_t n, uint64_t *checksum) {
+  LsmArray *t = lsm_create(sizeof(Entry), NULL, DA_KEY_U64);
+  assert(t);
+  uint64_t s = 88172645463325252ull, sum = 0;
+  double start = now();
+  for (size_t i = 0; i < n; ++i) {
+    Entry e = {next_key(&s), i}, probe = {next_key(&s), 0}, hit;
+    assert(lsm_insert(t, &e) == DYN_OK);
+    if (lsm_lower_bound(t, &probe, &hit) == DYN_OK)
+      sum += hit.key;
+  }
+  double elapsed = now() - start;
+  printf("  %zu runs before compaction, ", lsm_run_count(t));
+  assert(lsm_compact(t) == DYN_OK);
+  printf("%zu entries after\n", lsm_entries(t));
+  lsm_destroy(t);
+  *checksum = sum;
+  return elapsed;
+}
+
+static double run_sorted_array(size_t n, uint64_t *checksum) {
+  DynamicArray *a = da_create(sizeof(Entry));
+  assert(a && da_reserve(a, n) == DYN_OK);
+  uint64_t s = 88172645463325252ull, sum = 0;
+  double start = now();
+  for (size_t i = 0; i < n; ++i) {
+    Entry e = {next_key(&s), i}, probe = {next_key(&s), 0};
+    size_t at, size = da_size(a);
+    da_lower_bound(a, &e, NULL, DA_KEY_U64, &at);
+    da_push_back(a, &e);
+    Entry *d = da_data(a);
+    memmove(d + at + 1, d + at, (size - at) * sizeof *d);
+    d[at] = e;
+    da_lower_bound(a, &probe, NULL, DA_KEY_U64, &at);
+    if (at < da_size(a))
+      sum += d[at].key;
+  }
+  double elapsed = now() - start;
+  da_destroy(a);
+  *checksum = sum;
+  return elapsed;
+}
+
+int main(void) {
+  uint64_t c1, c2;
+  printf("LsmArray, %d inserts + %d lower_bounds:\n", BASELINE_COUNT,
+         BASELINE_COUNT);
+  double lsm = run_lsm(BASELINE_COUNT, &c1);
+  double arr = run_sorted_array(BASELINE_COUNT, &c2);
+  printf("  %.3f s vs sorted array with memmove %.3f s (%.1fx)%s\n", lsm, arr,
+         arr / lsm, c1 == c2 ? "" : "  CHECKSUM MISMATCH");
+
+  printf("LsmArray, %d inserts + %d lower_bounds:\n", COUNT, COUNT);
+  lsm = run_lsm(COUNT, &c1);
+  printf("  %.3f s, %.0f ns per insert+query\n", lsm, lsm / COUNT * 1e9);
+  return 0;
+}
@@ -0,0 +1,81 @@
+// serialize_example.c
+#include "da_serialize.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define COUNT 10000000
+
+/* In-memory sink/source built on a byte DynamicArray. */
+static size_t mem_write(void *ctx, const void *buf, size_t len) {
+  return da_push_back_n(ctx, buf, len) == DYN_OK ? len : 0;
+}
+
+typedef struct {
+  const unsigned char *p;
+  size_t left;
+} mem_source;
+
+static size_t mem_read(void *ctx, void *buf, size_t len) {
+  mem_source *src = ctx;
+  if (len > src->left)
+    len = src->left;
+  memcpy(buf, src->p, len);
+  src->p += len;
+  src->left -= len;
+  return len;
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void) {
+  /* sorted 32-bit ids with small random gaps */
+  DynamicArray *ids = da_create(sizeof(int32_t));
+  assert(ids && da_reserve(ids, COUNT) == DYN_OK);
+  int32_t v = -1000000;
+  for (int i = 0; i < COUNT; ++i) {
+    v += rand() % 16;
+    da_push_back(ids, &v);
+  }
+
+  DynamicArray *wire = da_create(1);
+  double t0 = now();
+  int st = da_serialize(ids, DA_SER_SIGNED | DA_SER_DELTA, mem_write, wire);
+  double t1 = now();
+  assert(st == DYN_OK);
+
+  DynamicArray *back = da_create(sizeof(int32_t));
+  mem_source src = {da_cdata(wire), da_size(wire)};
+  double t2 = now();
+  st = da_deserialize(back, mem_read, &src);
+  double t3 = now();
+  assert(st == DYN_OK && da_size(back) == COUNT);
+  const int32_t *a = da_cdata(ids), *b = da_cdata(back);
+  for (size_t i = 0; i < COUNT; ++i)
+    assert(a[i] == b[i]);
+
+  /* random access through the block index */
+  da_ser_view view;
+  assert(da_ser_open(&view, da_cdata(wire), da_size(wire)) == DYN_OK);
+  int32_t block[DA_SER_BLOCK];
+  size_t n;
+  assert(da_ser_decode_block(&view, 1234, block, &n) == DYN_OK);
+  assert(n == DA_SER_BLOCK && block[0] == a[1234 * DA_SER_BLOCK]);
+
+  size_t raw = (size_t)COUNT * sizeof(int32_t);
+  printf("raw %zu bytes -> %zu bytes (%.2fx)\n", raw, da_size(wire),
+         (double)raw / da_size(wire));
+  printf("encode %.2f GB/s, decode %.2f GB/s (raw bytes)\n",
+         raw / (t1 - t0) / 1e9, raw / (t3 - t2) / 1e9);
+
+  da_destroy(back);
+  da_destroy(wire);
+  da_destroy(ids);
+  return 0;
+}
@@ -0,0 +1,66 @@
+// sort_example.c
+#include "da_sort.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define COUNT 5000000
+
+static int cmp_int(const void *a, const void *b) {
+  int x = *(const int *)a, y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Fill a fresh array with the same pseudo-random ints every time. */
+static DynamicArray *random_ints(void) {
+  DynamicArray *a = da_create(sizeof(int));
+  assert(a && da_reserve(a, COUNT) == DYN_OK);
+  srand(42);
+  for (int i = 0; i < COUNT; ++i) {
+    int v = rand() % 1000000;
+    da_push_back(a, &v);
+  }
+  return a;
+}
+
+int main(void) {
+  DynamicArray *a = random_ints();
+  double t0 = now();
+  qsort(da_data(a), da_size(a), da_elem_size(a), cmp_int);
+  double t1 = now();
+  da_destroy(a);
+
+  a = random_ints();
+  double t2 = now();
+  da_sort(a, cmp_int, DA_KEY_NONE); /* comparator, 4-byte kernel */
+  double t3 = now();
+  da_destroy(a);
+
+  a = random_ints();
+  double t4 = now();
+  da_sort(a, NULL, DA_KEY_I32); /* inlined int32 comparison */
+  double t5 = now();
+
+  printf("qsort              %.3f s\n", t1 - t0);
+  printf("da_sort cmp        %.3f s\n", t3 - t2);
+  printf("da_sort DA_KEY_I32 %.3f s\n", t5 - t4);
+
+  int key = 500000;
+  size_t pos;
+  da_lower_bound(a, &key, NULL, DA_KEY_I32, &pos);
+  printf("first element >= %d is at index %zu\n", key, pos);
+
+  da_unique(a, NULL, DA_KEY_I32);
+  printf("%zu distinct values\n", da_size(a));
+
+  da_destroy(a);
+  return 0;
+}
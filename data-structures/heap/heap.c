@@ -0,0 +1,365 @@
+#include "heap.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct heap {
+  DynamicArray *items; // heap order
+  unsigned arity;
+  int (*cmp)(const void *, const void *);
+  void *tmp; // the element travelling through a sift
+  // Indexed heaps only (NULL otherwise):
+  DynamicArray *handle_at;    // handle of the element in each slot
+  DynamicArray *slot_of;      // slot of each handle, HEAP_NO_HANDLE if free
+  DynamicArray *free_handles; // handles to hand out again
+};
+
+/*
+ * Sifts. A Sift captures the array and, for indexed heaps, the two handle
+ * maps, which every element move keeps in step. The travelling element
+ * waits in tmp (with its handle) while the hole moves.
+ */
+
+typedef struct {
+  char *base;
+  size_t size;
+  unsigned arity;
+  int (*cmp)(const void *, const void *);
+  char *tmp;
+  size_t *handle_at, *slot_of; // NULL when not indexed
+  size_t tmp_handle;
+} Sift;
+
+static inline char *slot(const Sift *s, size_t i) {
+  return s->base + i * s->size;
+}
+
+static inline void move(const Sift *s, size_t to, size_t from) {
+  memcpy(slot(s, to), slot(s, from), s->size);
+  sort_stat_move(s->size);
+  if (s->handle_at) {
+    s->handle_at[to] = s->handle_at[from];
+    s->slot_of[s->handle_at[to]] = to;
+  }
+}
+
+static inline void place(const Sift *s, size_t i) {
+  memcpy(slot(s, i), s->tmp, s->size);
+  sort_stat_move(s->size);
+  if (s->handle_at) {
+    s->handle_at[i] = s->tmp_handle;
+    s->slot_of[s->tmp_handle] = i;
+  }
+}
+
+static inline void lift(Sift *s, size_t i) {
+  memcpy(s->tmp, slot(s, i), s->size);
+  if (s->handle_at)
+    s->tmp_handle = s->handle_at[i];
+}
+
+// Hole at i; move it up while tmp ranks before the parent.
+static void sift_up_hole(const Sift *s, size_t i) {
+  while (i > 0) {
+    size_t p = (i - 1) / s->arity;
+    if (SORT_COMPARED(s->cmp(s->tmp, slot(s, p))) >= 0)
+      break;
+    move(s, i, p);
+    i = p;
+  }
+  place(s, i);
+}
+
+// Hole at i in a heap of n; move it down while a child ranks before tmp.
+static void sift_down_hole(const Sift *s, size_t n, size_t i) {
+  for (;;) {
+    size_t c = s->arity * i + 1;
+    if (c >= n)
+      break;
+    size_t end = n - c < s->arity ? n : c + s->arity, best = c;
+    for (size_t j = c + 1; j < end; ++j)
+      if (SORT_COMPARED(s->cmp(slot(s, j), slot(s, best))) < 0)
+        best = j;
+    if (SORT_COMPARED(s->cmp(slot(s, best), s->tmp)) >= 0)
+      break;
+    move(s, i, best);
+    i = best;
+  }
+  place(s, i);
+}
+
+static void heapify(Sift *s, size_t n) {
+  for (size_t i = n > 1 ? (n - 2) / s->arity + 1 : 0; i-- > 0;) {
+    lift(s, i);
+    sift_down_hole(s, n, i);
+  }
+}
+
+static Sift sift_of(Heap *h) {
+  Sift s = {.base = da_data(h->items),
+            .size = da_elem_size(h->items),
+            .arity = h->arity,
+            .cmp = h->cmp,
+            .tmp = h->tmp};
+  if (h->handle_at) {
+    s.handle_at = da_data(h->handle_at);
+    s.slot_of = da_data(h->slot_of);
+  }
+  return s;
+}
+
+/*
+ * Handles
+ */
+
+static int new_handle(Heap *h, size_t *out) {
+  if (da_pop_back(h->free_handles, out) == DYN_OK)
+    return 0;
+  size_t fresh = da_size(h->slot_of), none = HEAP_NO_HANDLE;
+  if (da_push_back(h->slot_of, &none) != DYN_OK)
+    return -1;
+  *out = fresh;
+  return 0;
+}
+
+// Reserve room so the pushes of one operation cannot fail halfway.
+static int reserve_handles(Heap *h, size_t count) {
+  size_t n = da_size(h->items), spare = da_size(h->free_handles);
+  size_t fresh = count > spare ? count - spare : 0;
+  if (da_reserve(h->handle_at, n + count) != DYN_OK ||
+      da_reserve(h->slot_of, da_size(h->slot_of) + fresh) != DYN_OK)
+    return -1;
+  return 0;
+}
+
+static int slot_of_handle(const Heap *h, HeapHandle handle, size_t *out) {
+  if (!h || !h->handle_at || handle >= da_size(h->slot_of))
+    return -1;
+  size_t i = ((const size_t *)da_cdata(h->slot_of))[handle];
+  if (i == HEAP_NO_HANDLE)
+    return -1;
+  *out = i;
+  return 0;
+}
+
+static void release_handle(Heap *h, size_t handle) {
+  ((size_t *)da_data(h->slot_of))[handle] = HEAP_NO_HANDLE;
+  da_push_back(h->free_handles, &handle); // reserved by the caller
+}
+
+/*
+ * Public API
+ */
+
+static Heap *create(size_t elem_size, unsigned arity,
+                    int (*cmp)(const void *, const void *), int indexed) {
+  if (arity == 0)
+    arity = HEAP_DEFAULT_ARITY;
+  if (elem_size == 0 || cmp == NULL || arity < 2 || arity > HEAP_MAX_ARITY)
+    return NULL;
+  Heap *h = calloc(1, sizeof *h);
+  if (!h)
+    return NULL;
+  h->arity = arity;
+  h->cmp = cmp;
+  h->items = da_create(elem_size);
+  h->tmp = malloc(elem_size);
+  int ok = h->items && h->tmp;
+  if (indexed) {
+    h->handle_at = da_create(sizeof(size_t));
+    h->slot_of = da_create(sizeof(size_t));
+    h->free_handles = da_create(sizeof(size_t));
+    ok = ok && h->handle_at && h->slot_of && h->free_handles;
+  }
+  if (!ok) {
+    free_heap(h);
+    return NULL;
+  }
+  return h;
+}
+
+Heap *create_heap(size_t elem_size, unsigned arity,
+                  int (*cmp)(const void *, const void *)) {
+  return create(elem_size, arity, cmp, 0);
+}
+
+Heap *create_indexed_heap(size_t elem_size, unsigned arity,
+                          int (*cmp)(const void *, const void *)) {
+  return create(elem_size, arity, cmp, 1);
+}
+
+void free_heap(Heap *h) {
+  if (!h)
+    return;
+  da_destroy(h->items);
+  da_destroy(h->handle_at);
+  da_destroy(h->slot_of);
+  da_destroy(h->free_handles);
+  free(h->tmp);
+  free(h);
+}
+
+int heap_push(Heap *h, const void *elem, HeapHandle *handle) {
+  if (!h || !elem)
+    return -1;
+  size_t n = da_size(h->items), hd = HEAP_NO_HANDLE;
+  if (da_reserve(h->items, n + 1) != DYN_OK)
+    return -1;
+  if (h->handle_at) {
+    if (reserve_handles(h, 1) != 0 || new_handle(h, &hd) != 0)
+      return -1;
+    da_push_back(h->handle_at, &hd);
+  }
+  da_push_back(h->items, elem);
+
+  Sift s = sift_of(h);
+  memcpy(s.tmp, elem, s.size);
+  s.tmp_handle = hd;
+  sift_up_hole(&s, n);
+  if (handle)
+    *handle = hd;
+  return 0;
+}
+
+int heap_pop(Heap *h, void *out) {
+  if (!h || da_size(h->items) == 0)
+    return -1;
+  if (h->handle_at &&
+      da_reserve(h->free_handles, da_size(h->free_handles) + 1) != DYN_OK)
+    return -1;
+  size_t n = da_size(h->items) - 1; // size after the pop
+  Sift s = sift_of(h);
+  if (out)
+    memcpy(out, slot(&s, 0), s.size);
+  if (s.handle_at)
+    release_handle(h, s.handle_at[0]);
+  if (n > 0) {
+    lift(&s, n);
+    sift_down_hole(&s, n, 0);
+  }
+  da_truncate(h->items, n);
+  if (h->handle_at)
+    da_truncate(h->handle_at, n);
+  return 0;
+}
+
+const void *heap_top(const Heap *h) {
+  return h && da_size(h->items) > 0 ? da_cdata(h->items) : NULL;
+}
+
+int heap_pushpop(Heap *h, const void *elem, void *out, HeapHandle *handle) {
+  if (!h || !elem || !out)
+    return -1;
+  size_t n = da_size(h->items);
+  if (handle)
+    *handle = HEAP_NO_HANDLE;
+  if (n == 0 || h->cmp(elem, da_cdata(h->items)) <= 0) {
+    memmove(out, elem, da_elem_size(h->items));
+    return 0;
+  }
+
+  Sift s = sift_of(h);
+  memcpy(s.tmp, elem, s.size); // before out is written: they may alias
+  memcpy(out, slot(&s, 0), s.size);
+  if (s.handle_at) {
+    s.tmp_handle = s.handle_at[0]; // the popped element's handle
+    if (handle)
+      *handle = s.tmp_handle;
+  }
+  sift_down_hole(&s, n, 0);
+  return 0;
+}
+
+int heap_build(Heap *h, const void *elems, size_t count, HeapHandle *handles) {
+  if (!h || (!elems && count > 0))
+    return -1;
+  size_t n = da_size(h->items);
+  if (da_reserve(h->items, n + count) != DYN_OK)
+    return -1;
+  if (h->handle_at) {
+    if (reserve_handles(h, count) != 0)
+      return -1;
+    for (size_t i = 0; i < count; ++i) {
+      size_t hd;
+      new_handle(h, &hd); // reserved: cannot fail
+      da_push_back(h->handle_at, &hd);
+      ((size_t *)da_data(h->slot_of))[hd] = n + i;
+      if (handles)
+        handles[i] = hd;
+    }
+  }
+  da_push_back_n(h->items, elems, count);
+
+  Sift s = sift_of(h);
+  if (count > n) {
+    heapify(&s, n + count);
+    return 0;
+  }
+  for (size_t i = n; i < n + count; ++i) { // few: sift each up
+    lift(&s, i);
+    sift_up_hole(&s, i);
+  }
+  return 0;
+}
+
+int heap_update(Heap *h, HeapHandle handle, const void *elem) {
+  size_t i;
+  if (!elem || slot_of_handle(h, handle, &i) != 0)
+    return -1;
+  Sift s = sift_of(h);
+  int c = h->cmp(elem, slot(&s, i));
+  memcpy(s.tmp, elem, s.size);
+  s.tmp_handle = handle;
+  if (c < 0)
+    sift_up_hole(&s, i);
+  else
+    sift_down_hole(&s, da_size(h->items), i);
+  return 0;
+}
+
+int heap_remove(Heap *h, HeapHandle handle, void *out) {
+  size_t i;
+  if (slot_of_handle(h, handle, &i) != 0 ||
+      da_reserve(h->free_handles, da_size(h->free_handles) + 1) != DYN_OK)
+    return -1;
+  size_t n = da_size(h->items) - 1; // size after the removal
+  Sift s = sift_of(h);
+  if (out)
+    memcpy(out, slot(&s, i), s.size);
+  release_handle(h, handle);
+  if (i < n) { // the last element fills the gap, moving up or down
+    lift(&s, n);
+    if (i > 0 && h->cmp(s.tmp, slot(&s, (i - 1) / s.arity)) < 0)
+      sift_up_hole(&s, i);
+    else
+      sift_down_hole(&s, n, i);
+  }
+  da_truncate(h->items, n);
+  da_truncate(h->handle_at, n);
+  return 0;
+}
+
+const void *heap_get(const Heap *h, HeapHandle handle) {
+  size_t i;
+  if (slot_of_handle(h, handle, &i) != 0)
+    return NULL;
+  return (const char *)da_cdata(h->items) + i * da_elem_size(h->items);
+}
+
+size_t heap_size(const Heap *h) { return h ? da_size(h->items) : 0; }
+
+void heap_make(void *base, size_t len, size_t size, unsigned arity,
+               int (*cmp)(const void *, const void *), void *tmp) {
+  Sift s = {.base = base, .size = size, .arity = arity, .cmp = cmp, .tmp = tmp};
+  heapify(&s, len);
+}
+
+void heap_pop_array(void *base, size_t len, size_t size, unsigned arity,
+                    int (*cmp)(const void *, const void *), void *tmp) {
+  if (len < 2)
+    return;
+  Sift s = {.base = base, .size = size, .arity = arity, .cmp = cmp, .tmp = tmp};
+  lift(&s, len - 1);
+  memcpy(slot(&s, len - 1), slot(&s, 0), size);
+  sort_stat_move(size);
+  sift_down_hole(&s, len - 1, 0);
+}
@@ -0,0 +1,208 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include "../../sorting/sort_stats.h"
+#include "../dynamic_array/dynamic_array.h"
+#include <stddef.h>
+
+/*
+ * d-ary min-heap priority queue of fixed-size elements, stored in a
+ * DynamicArray.
+ *
+ * The top is the element cmp ranks first (pass a reversed comparator for a
+ * max-heap). Node i has children d*i + 1 .. d*i + d, so a wider node makes
+ * the tree shallower: a pop touches log_d(n) levels, comparing d children
+ * that share one or two cache lines. d = 4 is usually the sweet spot.
+ *
+ * An indexed heap also hands out a HeapHandle per element, valid until the
+ * element leaves the heap, so a scheduler can change an element's priority
+ * (decrease-key) or cancel it in O(log n) without searching.
+ *
+ * Sifts move a hole instead of swapping: one element copy per level.
+ * Built with -DSORT_STATS, sifts add their element copies (and heap.c its
+ * cmp calls) to the sorting/sort_stats.h counters, which is how heap_sort
+ * reports bytes_moved; HEAP_DEFINE users count comparisons in LESS.
+ *
+ * Return values follow deque: 0 on success, -1 on failure.
+ */
+
+#define HEAP_DEFAULT_ARITY 4
+#define HEAP_MAX_ARITY 64
+
+typedef struct heap Heap;
+typedef size_t HeapHandle;
+
+#define HEAP_NO_HANDLE ((HeapHandle)-1)
+
+// arity 0 means HEAP_DEFAULT_ARITY; otherwise 2 .. HEAP_MAX_ARITY.
+// NULL on failure.
+Heap *create_heap(size_t elem_size, unsigned arity,
+                  int (*cmp)(const void *, const void *));
+
+// Same, with handles for heap_update / heap_remove / heap_get.
+Heap *create_indexed_heap(size_t elem_size, unsigned arity,
+                          int (*cmp)(const void *, const void *));
+
+void free_heap(Heap *h);
+
+// Copy elem in. On an indexed heap *handle receives its handle (handle may
+// be NULL if the caller does not need it).
+int heap_push(Heap *h, const void *elem, HeapHandle *handle);
+
+// Remove the top, copying it to out when out is not NULL. -1 when empty.
+int heap_pop(Heap *h, void *out);
+
+// The top element, or NULL when empty.
+const void *heap_top(const Heap *h);
+
+// Push elem and pop the top in one sift; out receives whichever ranks
+// first (elem itself if it beats the top, which then never enters the
+// heap). On an indexed heap the new element takes over the popped
+// element's handle; *handle is HEAP_NO_HANDLE if elem came straight back.
+int heap_pushpop(Heap *h, const void *elem, void *out, HeapHandle *handle);
+
+// Append count elements and restore the heap order in O(size + count)
+// (Floyd's bottom-up heapify) instead of count sifts. handles, if not
+// NULL, receives count handles on an indexed heap.
+int heap_build(Heap *h, const void *elems, size_t count, HeapHandle *handles);
+
+// Indexed heaps only. Replace the element of handle and move it up (lower
+// priority value, i.e. decrease-key) or down as needed.
+int heap_update(Heap *h, HeapHandle handle, const void *elem);
+
+// Indexed heaps only. Remove the element of handle, copying it to out
+// when out is not NULL. The handle becomes free for reuse.
+int heap_remove(Heap *h, HeapHandle handle, void *out);
+
+// Indexed heaps only. The element of handle, or NULL if it is not in the
+// heap. Valid until the next modification.
+const void *heap_get(const Heap *h, HeapHandle handle);
+
+size_t heap_size(const Heap *h);
+
+/*
+ * Array primitives, for heaps kept in the caller's own memory (heap_sort
+ * uses these). Same ordering and layout as Heap; tmp is scratch space for
+ * one element.
+ */
+
+// Rearrange base[0..len) into a heap in O(len).
+void heap_make(void *base, size_t len, size_t size, unsigned arity,
+               int (*cmp)(const void *, const void *), void *tmp);
+
+// base[0..len) is a heap: move its top to base[len - 1] and restore
+// base[0..len - 1) to a heap.
+void heap_pop_array(void *base, size_t len, size_t size, unsigned arity,
+                    int (*cmp)(const void *, const void *), void *tmp);
+
+/*
+ * Typed heaps. HEAP_DEFINE(name, T, ARITY, LESS) defines static inline
+ * functions for a heap of T with compile-time arity, where LESS(a, b) is
+ * an expression (or function-like macro) true when a ranks before b:
+ *
+ *   #define EARLIER(a, b) ((a).deadline < (b).deadline)
+ *   HEAP_DEFINE(timers, Timer, 4, EARLIER)
+ *
+ * On raw arrays:
+ *   name_sift_up(T *a, size_t i)           name_make(T *a, size_t n)
+ *   name_sift_down(T *a, size_t n, size_t i)
+ *   name_pop_array(T *a, size_t n)
+ * On a DynamicArray of T (0 on success, -1 on failure):
+ *   name_push(da, T x)   name_pop(da, T *out)   name_pushpop(da, T x, T *out)
+ *   name_top(da): T * or NULL
+ *
+ * Comparisons are inlined and the child loop is unrolled, which is what
+ * the generic Heap's function-pointer cmp cannot do. No handles.
+ */
+
+#define HEAP_DEFINE(name, T, ARITY, LESS)                                      \
+  static inline void name##_sift_up(T *a, size_t i) {                          \
+    T x = a[i];                                                                \
+    while (i > 0) {                                                            \
+      size_t p = (i - 1) / (ARITY);                                            \
+      if (!(LESS(x, a[p])))                                                    \
+        break;                                                                 \
+      a[i] = a[p];                                                             \
+      sort_stat_move(sizeof(T));                                               \
+      i = p;                                                                   \
+    }                                                                          \
+    a[i] = x;                                                                  \
+    sort_stat_move(sizeof(T));                                                 \
+  }                                                                            \
+                                                                               \
+  /* hole at i, x to be placed */                                              \
+  static inline void name##_sift_hole(T *a, size_t n, size_t i, T x) {         \
+    for (;;) {                                                                 \
+      size_t c = (ARITY) * i + 1, best = c;                                    \
+      if (c + (ARITY) <= n) {                                                  \
+        for (size_t j = 1; j < (ARITY); ++j)                                   \
+          best = LESS(a[c + j], a[best]) ? c + j : best;                       \
+      } else if (c < n) {                                                      \
+        for (size_t j = c + 1; j < n; ++j)                                     \
+          best = LESS(a[j], a[best]) ? j : best;                               \
+      } else {                                                                 \
+        break;                                                                 \
+      }                                                                        \
+      if (!(LESS(a[best], x)))                                                 \
+        break;                                                                 \
+      a[i] = a[best];                                                          \
+      sort_stat_move(sizeof(T));                                               \
+      i = best;                                                                \
+    }                                                                          \
+    a[i] = x;                                                                  \
+    sort_stat_move(sizeof(T));                                                 \
+  }                                                                            \
+                                                                               \
+  static inline void name##_sift_down(T *a, size_t n, size_t i) {              \
+    name##_sift_hole(a, n, i, a[i]);                                           \
+  }                                                                            \
+                                                                               \
+  static inline void name##_make(T *a, size_t n) {                             \
+    for (size_t i = n > 1 ? (n - 2) / (ARITY) + 1 : 0; i-- > 0;)               \
+      name##_sift_down(a, n, i);                                               \
+  }                                                                            \
+                                                                               \
+  static inline void name##_pop_array(T *a, size_t n) {                        \
+    T x = a[n - 1];                                                            \
+    a[n - 1] = a[0];                                                           \
+    sort_stat_move(sizeof(T));                                                 \
+    name##_sift_hole(a, n - 1, 0, x);                                          \
+  }                                                                            \
+                                                                               \
+  static inline int name##_push(DynamicArray *da, T x) {                       \
+    if (da_push_back(da, &x) != DYN_OK)                                        \
+      return -1;                                                               \
+    name##_sift_up((T *)da_data(da), da_size(da) - 1);                         \
+    return 0;                                                                  \
+  }                                                                            \
+                                                                               \
+  static inline T *name##_top(DynamicArray *da) {                              \
+    return da_size(da) > 0 ? (T *)da_data(da) : NULL;                          \
+  }                                                                            \
+                                                                               \
+  static inline int name##_pop(DynamicArray *da, T *out) {                     \
+    size_t n = da_size(da);                                                    \
+    if (n == 0)                                                                \
+      return -1;                                                               \
+    T *a = da_data(da);                                                        \
+    if (out)                                                                   \
+      *out = a[0];                                                             \
+    if (n > 1)                                                                 \
+      name##_sift_hole(a, n - 1, 0, a[n - 1]);                                 \
+    da_truncate(da, n - 1);                                                    \
+    return 0;                                                                  \
+  }                                                                            \
+                                                                               \
+  static inline int name##_pushpop(DynamicArray *da, T x, T *out) {            \
+    size_t n = da_size(da);                                                    \
+    T *a = da_data(da);                                                        \
+    if (n == 0 || !(LESS(a[0], x))) {                                          \
+      *out = x;                                                                \
+      return 0;                                                                \
+    }                                                                          \
+    *out = a[0];                                                               \
+    name##_sift_hole(a, n, 0, x);                                              \
+    return 0;                                                                  \
+  }
+
+#endif // HEAP_H
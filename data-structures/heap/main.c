@@ -0,0 +1,97 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include "heap.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Heap demo and timer-wheel style workload:
+ *   - a few timers scheduled, one rescheduled earlier (decrease-key) and
+ *     one cancelled through their handles;
+ *   - N live timers, then OPS rounds that fire the earliest timer,
+ *     re-arm it, and reschedule one random live timer, for arity 2, 4, 8.
+ *
+ * Build: gcc -O2 main.c heap.c ../dynamic_array/dynamic_array.c
+ */
+
+#define N (1 << 16)
+#define OPS (1 << 21)
+
+typedef struct {
+  uint64_t deadline;
+  uint32_t id;
+} Timer;
+
+static int earlier(const void *a, const void *b) {
+  uint64_t x = ((const Timer *)a)->deadline, y = ((const Timer *)b)->deadline;
+  return (x > y) - (x < y);
+}
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t splitmix(uint64_t *s) {
+  uint64_t z = (*s += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+static void demo(void) {
+  Heap *h = create_indexed_heap(sizeof(Timer), 0, earlier);
+  assert(h);
+  HeapHandle handles[5];
+  for (uint32_t i = 0; i < 5; ++i) {
+    Timer t = {.deadline = 100 * (i + 1), .id = i};
+    heap_push(h, &t, &handles[i]);
+  }
+  Timer sooner = {.deadline = 50, .id = 3};
+  heap_update(h, handles[3], &sooner);
+  heap_remove(h, handles[1], NULL);
+
+  printf("fire order:");
+  Timer t;
+  while (heap_pop(h, &t) == 0)
+    printf(" #%u@%llu", t.id, (unsigned long long)t.deadline);
+  printf("\n"); // #3@50 #0@100 #2@300 #4@500
+  free_heap(h);
+}
+
+static void bench(unsigned arity) {
+  Heap *h = create_indexed_heap(sizeof(Timer), arity, earlier);
+  static HeapHandle handles[N];
+  static Timer timers[N];
+  assert(h);
+  uint64_t seed = 7;
+  for (uint32_t i = 0; i < N; ++i)
+    timers[i] = (Timer){.deadline = splitmix(&seed) % 1000000, .id = i};
+  heap_build(h, timers, N, handles);
+
+  double t0 = now();
+  uint64_t clock = 0;
+  for (size_t i = 0; i < OPS; ++i) {
+    Timer fired = *(const Timer *)heap_top(h);
+    clock = fired.deadline;
+    fired.deadline = clock + 1 + splitmix(&seed) % 1000;
+    heap_update(h, handles[fired.id], &fired); // re-arm
+
+    uint32_t id = (uint32_t)(splitmix(&seed) % N);
+    Timer moved = {.deadline = clock + splitmix(&seed) % 1000, .id = id};
+    heap_update(h, handles[id], &moved); // reschedule
+  }
+  double t1 = now();
+  printf("arity %u: %.3f s for %d fire + reschedule rounds (clock %llu)\n",
+         arity, t1 - t0, OPS, (unsigned long long)clock);
+  free_heap(h);
+}
+
+int main() {
+  demo();
+  for (unsigned d = 2; d <= 8; d *= 2)
+    bench(d);
+  return 0;
+}
@@ -0,0 +1,153 @@
+#ifndef INTRUSIVE_LIST_H
+#define INTRUSIVE_LIST_H
+
+#include <stddef.h>
+
+/*
+ * Intrusive doubly linked list.
+ *
+ * Objects carry their own ListLink field, so linking never allocates: the
+ * list only rewires pointers inside memory the caller already owns (a pool,
+ * an array, the stack). container_of gets back from a link to its object:
+ *
+ *   typedef struct { int id; ListLink link; } Job;
+ *   Job *job = list_container_of(ilist_pop_front(&queue), Job, link);
+ *
+ * The list is circular around a sentinel, so every operation is O(1) and
+ * branch-free on the empty/non-empty boundary. A link belongs to at most
+ * one list at a time; removed links are reset to NULL pointers so
+ * ilist_is_linked can tell.
+ */
+
+typedef struct list_link {
+  struct list_link *next;
+  struct list_link *prev;
+} ListLink;
+
+typedef struct {
+  ListLink head; // sentinel
+  size_t size;
+} IntrusiveList;
+
+// Pointer to the struct of the given type whose field `member` is at ptr.
+#define list_container_of(ptr, type, member)                                   \
+  ((type *)((char *)(ptr) - offsetof(type, member)))
+
+// for (ListLink *it = first; it != sentinel; it = it->next). Do not remove
+// `it` inside the loop; use ilist_next before removing instead.
+#define ilist_for_each(list, it)                                               \
+  for (ListLink *it = (list)->head.next; it != &(list)->head; it = it->next)
+
+static inline void ilist_init(IntrusiveList *list) {
+  list->head.next = &list->head;
+  list->head.prev = &list->head;
+  list->size = 0;
+}
+
+static inline void ilist_link_init(ListLink *link) {
+  link->next = NULL;
+  link->prev = NULL;
+}
+
+static inline int ilist_is_linked(const ListLink *link) {
+  return link->next != NULL;
+}
+
+static inline int ilist_empty(const IntrusiveList *list) {
+  return list->head.next == &list->head;
+}
+
+static inline size_t ilist_size(const IntrusiveList *list) {
+  return list->size;
+}
+
+// First/last link, or NULL when empty.
+static inline ListLink *ilist_first(IntrusiveList *list) {
+  return ilist_empty(list) ? NULL : list->head.next;
+}
+
+static inline ListLink *ilist_last(IntrusiveList *list) {
+  return ilist_empty(list) ? NULL : list->head.prev;
+}
+
+// Link after `link`, or NULL at the end.
+static inline ListLink *ilist_next(IntrusiveList *list, ListLink *link) {
+  return link->next == &list->head ? NULL : link->next;
+}
+
+static inline void ilist_insert_between(ListLink *link, ListLink *prev,
+                                        ListLink *next) {
+  link->prev = prev;
+  link->next = next;
+  prev->next = link;
+  next->prev = link;
+}
+
+static inline void ilist_push_front(IntrusiveList *list, ListLink *link) {
+  ilist_insert_between(link, &list->head, list->head.next);
+  list->size++;
+}
+
+static inline void ilist_push_back(IntrusiveList *list, ListLink *link) {
+  ilist_insert_between(link, list->head.prev, &list->head);
+  list->size++;
+}
+
+// Inserts link right after pos (pos must be in list).
+static inline void ilist_insert_after(IntrusiveList *list, ListLink *pos,
+                                      ListLink *link) {
+  ilist_insert_between(link, pos, pos->next);
+  list->size++;
+}
+
+// Unlinks link from list (it must be in that list).
+static inline void ilist_remove(IntrusiveList *list, ListLink *link) {
+  link->prev->next = link->next;
+  link->next->prev = link->prev;
+  ilist_link_init(link);
+  list->size--;
+}
+
+static inline ListLink *ilist_pop_front(IntrusiveList *list) {
+  if (ilist_empty(list))
+    return NULL;
+  ListLink *link = list->head.next;
+  ilist_remove(list, link);
+  return link;
+}
+
+static inline ListLink *ilist_pop_back(IntrusiveList *list) {
+  if (ilist_empty(list))
+    return NULL;
+  ListLink *link = list->head.prev;
+  ilist_remove(list, link);
+  return link;
+}
+
+// Moves every link of src to the end of dst; src is left empty.
+static inline void ilist_splice_back(IntrusiveList *dst, IntrusiveList *src) {
+  if (dst == src || ilist_empty(src))
+    return;
+  ListLink *first = src->head.next, *last = src->head.prev;
+  first->prev = dst->head.prev;
+  dst->head.prev->next = first;
+  last->next = &dst->head;
+  dst->head.prev = last;
+  dst->size += src->size;
+  ilist_init(src);
+}
+
+// Moves every link of src to the front of dst; src is left empty.
+static inline void ilist_splice_front(IntrusiveList *dst, IntrusiveList *src) {
+  if (dst == src || ilist_empty(src))
+    return;
+  ListLink *first = src->head.next, *last = src->head.prev;
+  last->next = dst->head.next;
+  dst->head.next->prev = last;
+  first->prev = &dst->head;
+  dst->head.next = first;
+  dst->size += src->size;
+  ilist_init(src);
+}
+
+#endif // INTRUSIVE_LIST_H
@@ -1,59 +1,237 @@
 #include "linked_list.h"
+#include "../node_pool/node_pool.h"
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+/*
+ * Node memory:
+ *  - A copied payload lives in the same allocation as its node (flexible
+ *    array member), so one node costs one allocation instead of two.
+ *  - Nodes appended to a list come from that list's NodePool (see
+ *    node_pool.h); free_list releases the chunks in bulk and only walks the
+ *    list when some node was too big for a size class.
+ *  - A node is `next` plus a payload whose layout is fixed per list:
+ *      typed, fixed size, copy       the elem_size bytes
+ *      typed, fixed size, reference  the pointer
+ *      typed, variable, copy         the length, then the bytes
+ *      typed, variable, reference    pointer and length
+ *      untyped (create_list)         CompatMeta, then the bytes of a copy
+ *    Typed lists keep the callbacks and the ownership mode in their ListType,
+ *    once per list. Whether a node is pooled follows from its size, so that
+ *    is not stored per node either.
+ */
+
+enum {
+  LAYOUT_COMPAT = 0, // create_list: per-node metadata
+  LAYOUT_FIXED,
+  LAYOUT_FIXED_REF,
+  LAYOUT_VAR,
+  LAYOUT_VAR_REF
+};
+
 struct node {
-  void *data;
-  int data_reference;
-  int data_len;
   struct node *next;
-  PrintFunc print_pointer;
+  unsigned char payload[];
 };
 
+// Per-node metadata of untyped lists (what every node used to carry).
+typedef struct {
+  void *data;
+  size_t data_len;
+  PrintFunc print_pointer;
+  int data_reference;
+} CompatMeta;
+
+typedef struct {
+  void *data;
+  size_t len;
+} RefSlot;
+
+// Copied bytes start NODE_POOL_ALIGN aligned in both layouts that have them.
+#define COMPAT_BYTES_OFFSET NODE_POOL_ROUND(sizeof(Node) + sizeof(CompatMeta))
+#define VAR_BYTES_OFFSET (sizeof(Node) + sizeof(size_t))
+
 struct linkedlist {
   Node *head;
   Node *tail;
-  int size;
+  size_t size;
+  size_t total_bytes; // running sum of payload lengths, for O(1) metrics
+  NodePool pool;
+  int layout;    // LAYOUT_*, fixed at creation
+  ListType type; // all zero for untyped lists
 };
 
-Node *create_node(void *dt, int len, PrintFunc print_func) {
+/*
+ * Node layout
+ */
 
-  Node *node = (Node *)malloc(sizeof(Node));
-  if (node == NULL) {
-    printf("node aloccation fail");
-    return NULL;
+// Bytes of a node for a len-byte payload, or 0 on overflow.
+static size_t node_size(int layout, size_t len, int reference) {
+  if (len > SIZE_MAX / 2)
+    return 0;
+  switch (layout) {
+  case LAYOUT_FIXED:
+    return NODE_POOL_ROUND(sizeof(Node) + len);
+  case LAYOUT_FIXED_REF:
+    return NODE_POOL_ROUND(sizeof(Node) + sizeof(void *));
+  case LAYOUT_VAR:
+    return NODE_POOL_ROUND(VAR_BYTES_OFFSET + len);
+  case LAYOUT_VAR_REF:
+    return NODE_POOL_ROUND(sizeof(Node) + sizeof(RefSlot));
+  default:
+    return NODE_POOL_ROUND(COMPAT_BYTES_OFFSET + (reference ? 0 : len));
   }
+}
 
-  node->data = malloc(len);
-  if (node->data == NULL) {
-    printf("data node aloccation fail");
-    free(node);
-    return NULL;
+static CompatMeta *compat_meta(Node *node) {
+  return (CompatMeta *)node->payload;
+}
+
+static void *node_data(const LinkedList *list, Node *node) {
+  switch (list->layout) {
+  case LAYOUT_FIXED:
+    return node->payload;
+  case LAYOUT_FIXED_REF:
+    return *(void **)node->payload;
+  case LAYOUT_VAR:
+    return node->payload + sizeof(size_t);
+  case LAYOUT_VAR_REF:
+    return ((RefSlot *)node->payload)->data;
+  default:
+    return compat_meta(node)->data;
   }
+}
 
-  memcpy(node->data, dt, len);
-  node->data_len = len;
-  node->data_reference = 0;
-  node->next = NULL;
-  node->print_pointer = print_func;
-  return node;
+static size_t node_len(const LinkedList *list, Node *node) {
+  switch (list->layout) {
+  case LAYOUT_FIXED:
+  case LAYOUT_FIXED_REF:
+    return list->type.elem_size;
+  case LAYOUT_VAR:
+    return *(size_t *)node->payload;
+  case LAYOUT_VAR_REF:
+    return ((RefSlot *)node->payload)->len;
+  default:
+    return compat_meta(node)->data_len;
+  }
 }
 
-static Node *create_reference_node(void *dt, size_t len, PrintFunc print_func) {
-  Node *node = malloc(sizeof(Node));
-  if (node == NULL) {
-    printf("node aloccation fail");
-    return NULL;
+static int node_is_reference(const LinkedList *list, Node *node) {
+  switch (list->layout) {
+  case LAYOUT_FIXED:
+  case LAYOUT_VAR:
+    return 0;
+  case LAYOUT_FIXED_REF:
+  case LAYOUT_VAR_REF:
+    return 1;
+  default:
+    return compat_meta(node)->data_reference;
   }
-  node->data = dt;
-  node->data_len = len;
+}
+
+static size_t node_size_of(const LinkedList *list, Node *node) {
+  return node_size(list->layout, node_len(list, node),
+                   node_is_reference(list, node));
+}
+
+/*
+ * Nodes
+ */
+
+// From the list's pool; standalone nodes (list == NULL) are malloc'd.
+static Node *alloc_node(LinkedList *list, size_t bytes) {
+  if (list != NULL)
+    return node_pool_alloc(&list->pool, bytes);
+  return malloc(bytes);
+}
+
+static void release_node(LinkedList *list, Node *node) {
+  node_pool_free(&list->pool, node, node_size_of(list, node));
+}
+
+static void copy_payload(const LinkedList *list, void *dst, void *dt,
+                         size_t len) {
+  if (len == 0)
+    return;
+  if (list != NULL && list->type.copy != NULL)
+    list->type.copy(dst, dt, len);
+  else
+    memcpy(dst, dt, len);
+}
+
+// Builds a node in the list's layout (untyped when list is NULL).
+static Node *new_node(LinkedList *list, void *dt, size_t len, int reference,
+                      PrintFunc print_func) {
+  int layout = list == NULL ? LAYOUT_COMPAT : list->layout;
+  size_t bytes = node_size(layout, len, reference);
+  if (bytes == 0)
+    return NULL;
+  Node *node = alloc_node(list, bytes);
+  if (node == NULL)
+    return NULL;
   node->next = NULL;
-  node->print_pointer = print_func;
-  node->data_reference = 1;
+
+  switch (layout) {
+  case LAYOUT_FIXED:
+    copy_payload(list, node->payload, dt, len);
+    break;
+  case LAYOUT_FIXED_REF:
+    *(void **)node->payload = dt;
+    break;
+  case LAYOUT_VAR:
+    *(size_t *)node->payload = len;
+    copy_payload(list, node->payload + sizeof(size_t), dt, len);
+    break;
+  case LAYOUT_VAR_REF:
+    ((RefSlot *)node->payload)->data = dt;
+    ((RefSlot *)node->payload)->len = len;
+    break;
+  default: {
+    CompatMeta *meta = compat_meta(node);
+    meta->data_len = len;
+    meta->print_pointer = print_func;
+    meta->data_reference = reference;
+    if (reference) {
+      meta->data = dt;
+    } else {
+      meta->data = (unsigned char *)node + COMPAT_BYTES_OFFSET;
+      copy_payload(list, meta->data, dt, len);
+    }
+  }
+  }
   return node;
 }
-static void append(LinkedList *list, Node *node) {
+
+// Checks an add against the list's type and picks the node's ownership.
+// Typed lists ignore the per-call PrintFunc; their ownership mode decides.
+static int check_add(const LinkedList *list, size_t len, int want_reference,
+                     int *reference) {
+  if (list->layout == LAYOUT_COMPAT) {
+    *reference = want_reference;
+    return 0;
+  }
+  int ref_list = list->type.ownership == LIST_OWN_REFERENCE;
+  if (want_reference && !ref_list)
+    return -1;
+  if (list->type.elem_size != 0 && len != list->type.elem_size)
+    return -1;
+  *reference = ref_list;
+  return 0;
+}
+
+static void destroy_payload(LinkedList *list, Node *node) {
+  if (list->type.destroy != NULL)
+    list->type.destroy(node_data(list, node), node_len(list, node));
+}
+
+Node *create_node(void *dt, size_t len, PrintFunc print_func) {
+  return new_node(NULL, dt, len, 0, print_func);
+}
+
+static void append(LinkedList *list, Node *node, size_t len) {
   if (list->size == 0) {
     list->head = node;
     list->tail = node;
@@ -62,37 +240,88 @@ static void append(LinkedList *list, Node *node) {
     list->tail = node;
   }
   list->size++;
+  list->total_bytes += len;
 }
 LinkedList *create_list() {
-  LinkedList *list = (LinkedList *)malloc(sizeof(LinkedList));
-  if (list == NULL) {
-    printf("list aloccation fail");
+  LinkedList *list = (LinkedList *)calloc(1, sizeof(LinkedList));
+  if (list == NULL)
     return NULL;
-  }
-  list->head = NULL;
-  list->tail = NULL;
-  list->size = 0;
   return list;
 }
 
-int list_append(LinkedList *list, void *dt, int len, PrintFunc print_func) {
-  Node *node = create_node(dt, len, print_func);
+LinkedList *create_typed_list(const ListType *type) {
+  if (type == NULL || (type->ownership != LIST_OWN_COPY &&
+                       type->ownership != LIST_OWN_REFERENCE))
+    return NULL;
+  LinkedList *list = create_list();
+  if (list == NULL)
+    return NULL;
+  int ref = type->ownership == LIST_OWN_REFERENCE;
+  if (type->elem_size != 0)
+    list->layout = ref ? LAYOUT_FIXED_REF : LAYOUT_FIXED;
+  else
+    list->layout = ref ? LAYOUT_VAR_REF : LAYOUT_VAR;
+  list->type = *type;
+  return list;
+}
+
+const ListType *list_get_type(const LinkedList *list) {
+  if (list == NULL || list->layout == LAYOUT_COMPAT)
+    return NULL;
+  return &list->type;
+}
+
+int list_append(LinkedList *list, void *dt, size_t len, PrintFunc print_func) {
+  int reference;
+  if (list == NULL || check_add(list, len, 0, &reference) != 0)
+    return -1;
+  Node *node = new_node(list, dt, len, reference, print_func);
   if (node == NULL)
     return -1;
-  append(list, node);
+  append(list, node, len);
   return 0;
 }
 
-int list_append_reference(LinkedList *list, void *dt, int len,
+int list_insert_at(LinkedList *list, size_t index, void *dt, size_t len,
+                   PrintFunc print_func) {
+  int reference;
+  if (list == NULL || index > list->size ||
+      check_add(list, len, 0, &reference) != 0)
+    return -1;
+  if (index == list->size)
+    return list_append(list, dt, len, print_func);
+
+  Node *node = new_node(list, dt, len, reference, print_func);
+  if (node == NULL)
+    return -1;
+  if (index == 0) {
+    node->next = list->head;
+    list->head = node;
+  } else {
+    Node *prev = list->head;
+    for (size_t i = 1; i < index; ++i)
+      prev = prev->next;
+    node->next = prev->next;
+    prev->next = node;
+  }
+  list->size++;
+  list->total_bytes += len;
+  return 0;
+}
+
+int list_append_reference(LinkedList *list, void *dt, size_t len,
                           PrintFunc print_func) {
-  Node *node = create_reference_node(dt, len, print_func);
+  int reference;
+  if (list == NULL || check_add(list, len, 1, &reference) != 0)
+    return -1;
+  Node *node = new_node(list, dt, len, 1, print_func);
   if (node == NULL)
     return 91;
-  append(list, node);
+  append(list, node, len);
   return 0;
 }
 
-void list_print(void *lista, int len) {
+void list_print(void *lista, size_t len) {
   LinkedList *list = (LinkedList *)lista;
   if (list->head == NULL) {
     printf("List is empty");
@@ -101,7 +330,11 @@ void list_print(void *lista, int len) {
   putchar('|');
   Node *current = list->head;
   while (current != NULL) {
-    current->print_pointer(current->data, current->data_len);
+    PrintFunc print = list->layout == LAYOUT_COMPAT
+                          ? compat_meta(current)->print_pointer
+                          : list->type.print;
+    if (print != NULL)
+      print(node_data(list, current), node_len(list, current));
     if (current->next != NULL) {
       printf("  -->");
     }
@@ -124,7 +357,10 @@ void list_print(void *lista, int len) {
   // putchar('\n');
 };
 
+// Reverses the links; size and total_bytes are unaffected.
 void list_inverter(LinkedList *list) {
+  if (list == NULL || list->head == NULL)
+    return;
   Node *prev = list->head;
   Node *current = list->head->next;
   list->head->next = NULL;
@@ -141,60 +377,259 @@ void list_inverter(LinkedList *list) {
   list->tail = temp;
 }
 
-void free_list(LinkedList *list) {
-  if (list == NULL)
-    return;
+int list_remove_head(LinkedList *list) {
+  if (list == NULL || list->head == NULL)
+    return -1;
+  Node *node = list->head;
+  list->head = node->next;
+  if (list->head == NULL)
+    list->tail = NULL;
+  list->size--;
+  list->total_bytes -= node_len(list, node);
+  destroy_payload(list, node);
+  release_node(list, node);
+  return 0;
+}
 
-  Node *current = list->head;
-  Node *next_node;
+int list_truncate_shallow(LinkedList *list, size_t count) {
+  if (list == NULL || count > list->size)
+    return -1;
+  if (count == list->size)
+    return 0;
+  Node *keep = NULL, *node = list->head;
+  for (size_t i = 0; i < count; ++i) {
+    keep = node;
+    node = node->next;
+  }
+  if (keep == NULL)
+    list->head = NULL;
+  else
+    keep->next = NULL;
+  list->tail = keep;
+  while (node != NULL) {
+    Node *next_node = node->next;
+    list->total_bytes -= node_len(list, node);
+    release_node(list, node);
+    node = next_node;
+  }
+  list->size = count;
+  return 0;
+}
 
-  while (current != NULL) {
-    next_node = current->next;
-    if (current->data_reference == 0) {
-      // Só libera 'data' se NÃO for uma referência
-      free(current->data);
-    }
+/*
+ * Iteration
+ */
 
-    free(current);
-    current = next_node;
-  }
-  free(list);
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(p) __builtin_prefetch(p)
+#else
+#define PREFETCH(p) ((void)(p))
+#endif
+
+// Moves the lookahead one node forward. The node it leaves has been touched
+// by now, so its referenced payload (if any) can be requested as well.
+static Node *advance_ahead(const LinkedList *list, Node *ahead) {
+  if (ahead == NULL)
+    return NULL;
+  if (node_is_reference(list, ahead))
+    PREFETCH(node_data(list, ahead));
+  ahead = ahead->next;
+  if (ahead != NULL)
+    PREFETCH(ahead);
+  return ahead;
 }
 
-void free_list_shallow(LinkedList *list) {
-  if (list == NULL)
+void list_cursor_init(ListCursor *cursor, LinkedList *list) {
+  cursor->list = list;
+  cursor->node = list == NULL ? NULL : list->head;
+  cursor->ahead = cursor->node;
+  if (cursor->node != NULL)
+    PREFETCH(cursor->node);
+  for (int i = 0; i < LIST_PREFETCH_DISTANCE && cursor->ahead != NULL; ++i)
+    cursor->ahead = advance_ahead(list, cursor->ahead);
+}
+
+int list_cursor_next(ListCursor *cursor, void **data, size_t *len) {
+  Node *node = cursor->node;
+  if (node == NULL)
+    return 0;
+  if (data != NULL)
+    *data = node_data(cursor->list, node);
+  if (len != NULL)
+    *len = node_len(cursor->list, node);
+  cursor->node = node->next;
+  cursor->ahead = advance_ahead(cursor->list, cursor->ahead);
+  return 1;
+}
+
+void list_for_each(LinkedList *list, ListVisitor visit, void *ctx) {
+  if (list == NULL || visit == NULL)
     return;
+  ListCursor cursor;
+  void *data;
+  size_t len;
+  list_cursor_init(&cursor, list);
+  while (list_cursor_next(&cursor, &data, &len))
+    visit(data, len, ctx);
+}
 
-  Node *current = list->head;
-  Node *next_node;
+void list_for_each_batch(LinkedList *list, ListBatchVisitor visit, void *ctx) {
+  if (list == NULL || visit == NULL)
+    return;
+  void *data[LIST_VISIT_BATCH];
+  size_t lens[LIST_VISIT_BATCH];
+  size_t n = 0;
+  ListCursor cursor;
+  list_cursor_init(&cursor, list);
+  while (list_cursor_next(&cursor, &data[n], &lens[n])) {
+    if (++n == LIST_VISIT_BATCH) {
+      visit(data, lens, n, ctx);
+      n = 0;
+    }
+  }
+  if (n > 0)
+    visit(data, lens, n, ctx);
+}
 
-  while (current != NULL) {
-    next_node = current->next;
-    // not free the data
+/*
+ * Ordering
+ */
 
-    free(current);
-    current = next_node;
+// Stable merge of two NULL-terminated runs; a's nodes win ties.
+static Node *merge_runs(const LinkedList *list, Node *a, Node *b,
+                        ListCompare cmp) {
+  Node *out = NULL;
+  Node **link = &out;
+  while (a != NULL && b != NULL) {
+    if (cmp(node_data(list, b), node_data(list, a)) < 0) {
+      *link = b;
+      b = b->next;
+    } else {
+      *link = a;
+      a = a->next;
+    }
+    link = &(*link)->next;
   }
-  free(list);
+  *link = a != NULL ? a : b;
+  return out;
+}
+
+static void fix_tail(LinkedList *list) {
+  Node *node = list->head;
+  while (node != NULL && node->next != NULL)
+    node = node->next;
+  list->tail = node;
 }
 
-int list_get_node_count(LinkedList *list) {
+int list_sort(LinkedList *list, ListCompare cmp) {
   if (list == NULL)
     return -1;
-  return list->size;
+  if (cmp == NULL)
+    cmp = list->type.compare;
+  if (cmp == NULL)
+    return -1;
+  // bins[i] is NULL or a sorted run of 2^i nodes, all older than bins[i - 1]
+  Node *bins[sizeof(size_t) * 8] = {0};
+  size_t fill = 0;
+  Node *node = list->head;
+  while (node != NULL) {
+    Node *carry = node;
+    node = node->next;
+    carry->next = NULL;
+    size_t i = 0;
+    for (; i < fill && bins[i] != NULL; ++i) {
+      carry = merge_runs(list, bins[i], carry, cmp);
+      bins[i] = NULL;
+    }
+    bins[i] = carry;
+    if (i == fill)
+      fill++;
+  }
+  Node *sorted = NULL;
+  for (size_t i = 0; i < fill; ++i)
+    if (bins[i] != NULL)
+      sorted =
+          sorted == NULL ? bins[i] : merge_runs(list, bins[i], sorted, cmp);
+  list->head = sorted;
+  fix_tail(list);
+  return 0;
 }
 
-int list_get_total_bytes(LinkedList *list) {
-  if (list == NULL)
+int list_merge(LinkedList *dst, LinkedList *src, ListCompare cmp) {
+  if (dst == NULL || src == NULL || dst == src)
+    return -1;
+  // nodes can only move between lists that lay them out the same way
+  if (dst->layout != src->layout ||
+      dst->type.elem_size != src->type.elem_size)
     return -1;
+  if (cmp == NULL)
+    cmp = dst->type.compare;
+  if (cmp == NULL || node_pool_absorb(&dst->pool, &src->pool) != 0)
+    return -1;
+  dst->head = merge_runs(dst, dst->head, src->head, cmp);
+  fix_tail(dst);
+  dst->size += src->size;
+  dst->total_bytes += src->total_bytes;
+  src->head = src->tail = NULL;
+  src->size = 0;
+  src->total_bytes = 0;
+  return 0;
+}
 
-  Node *current = list->head;
-  int total = 0;
+int list_reserve(LinkedList *list, size_t count, size_t payload_len) {
+  if (list == NULL)
+    return -1;
+  int reference = list->type.ownership == LIST_OWN_REFERENCE;
+  size_t bytes = node_size(list->layout, payload_len, reference);
+  if (bytes == 0 || bytes > NODE_POOL_MAX_NODE)
+    return 0; // these nodes are malloc'd one by one anyway
+  if (count > SIZE_MAX / bytes)
+    return -1;
+  return node_pool_reserve(&list->pool, count * bytes);
+}
 
-  while (current != NULL) {
-    total += current->data_len;
-    current = current->next;
+// Free every node (pooled nodes go away with their chunks) and the list.
+static void release_nodes(LinkedList *list) {
+  if (list->pool.heap_nodes > 0) {
+    Node *current = list->head;
+    while (current != NULL) {
+      Node *next_node = current->next;
+      if (node_size_of(list, current) > NODE_POOL_MAX_NODE)
+        release_node(list, current);
+      current = next_node;
+    }
   }
+  node_pool_destroy(&list->pool);
+  free(list);
+}
+
+void free_list(LinkedList *list) {
+  if (list == NULL)
+    return;
+  // copied payloads live inside their nodes; only a destroy callback has more
+  // to release
+  if (list->type.destroy != NULL)
+    for (Node *node = list->head; node != NULL; node = node->next)
+      destroy_payload(list, node);
+  release_nodes(list);
+}
 
-  return total;
+void free_list_shallow(LinkedList *list) {
+  if (list == NULL)
+    return;
+  // not free the data
+  release_nodes(list);
+}
+
+size_t list_get_node_count(LinkedList *list) {
+  if (list == NULL)
+    return 0;
+  return list->size;
+}
+
+// O(1): the total is maintained by every operation that adds or drops nodes.
+size_t list_get_total_bytes(LinkedList *list) {
+  if (list == NULL)
+    return 0;
+  return list->total_bytes;
 }
@@ -5,28 +5,143 @@
 #include <stdlib.h>
 #include <string.h>
 
-typedef void (*PrintFunc)(void *data, int len);
+typedef void (*PrintFunc)(void *data, size_t len);
 
 typedef struct node Node;
 
 typedef struct linkedlist LinkedList;
 
-Node *create_node(void *dt, int len, PrintFunc print_func);
+// Called once per node with its payload; ctx is passed through unchanged.
+typedef void (*ListVisitor)(void *data, size_t len, void *ctx);
 
-static Node *create_reference_node(void *dt, size_t len, PrintFunc print_func);
+// Called with up to LIST_VISIT_BATCH payload pointers/lengths at a time.
+typedef void (*ListBatchVisitor)(void **data, const size_t *lens, size_t n,
+                                 void *ctx);
+
+#ifndef LIST_PREFETCH_DISTANCE
+#define LIST_PREFETCH_DISTANCE 4 // nodes fetched ahead of the visitor
+#endif
+
+#ifndef LIST_VISIT_BATCH
+#define LIST_VISIT_BATCH 64
+#endif
+
+// qsort-style comparison of two payloads.
+typedef int (*ListCompare)(const void *a, const void *b);
+
+typedef enum {
+  LIST_OWN_COPY = 0,     // nodes hold a copy of the payload
+  LIST_OWN_REFERENCE = 1 // nodes hold the caller's pointer
+} ListOwnership;
+
+typedef void (*ListDestroyFunc)(void *data, size_t len);
+typedef void (*ListCopyFunc)(void *dst, const void *src, size_t len);
+
+/*
+ * Per-list type descriptor: what every node of a typed list shares, stored
+ * once in the list instead of in each node. Typed nodes are just a next
+ * pointer plus the payload (16 bytes for an int instead of 64).
+ *
+ *   elem_size  payload size; 0 lets each node record its own length
+ *   ownership  copy into the node or keep the caller's pointer
+ *   print      used by list_print (may be NULL)
+ *   destroy    called on each payload by free_list and list_remove_head
+ *              (not by free_list_shallow); may be NULL
+ *   copy       fills a copied payload; NULL means memcpy
+ *   compare    default for list_sort / list_merge when cmp is NULL
+ */
+typedef struct {
+  size_t elem_size;
+  ListOwnership ownership;
+  PrintFunc print;
+  ListDestroyFunc destroy;
+  ListCopyFunc copy;
+  ListCompare compare;
+} ListType;
+
+// Forward cursor. Fields are private; use list_cursor_init/list_cursor_next.
+typedef struct {
+  LinkedList *list;
+  Node *node;  // next node to hand out
+  Node *ahead; // LIST_PREFETCH_DISTANCE nodes past node (or NULL)
+} ListCursor;
+
+// Standalone node (one allocation: the payload is copied inline).
+Node *create_node(void *dt, size_t len, PrintFunc print_func);
+
+// Untyped list: every node carries its own PrintFunc, length and ownership
+// flag, as before ListType existed.
 LinkedList *create_list();
-int list_append(LinkedList *list, void *dt, int len, PrintFunc print_func);
 
-int list_append_reference(LinkedList *list, void *dt, int len,
+// Typed list; the descriptor is copied. NULL on failure.
+LinkedList *create_typed_list(const ListType *type);
+
+// The list's descriptor, or NULL for untyped lists.
+const ListType *list_get_type(const LinkedList *list);
+
+// On typed lists print_func is ignored, len must equal elem_size when that
+// is set, and the list's ownership mode decides between copy and reference.
+int list_append(LinkedList *list, void *dt, size_t len, PrintFunc print_func);
+
+// Inserts a copy before position index (index == count appends).
+int list_insert_at(LinkedList *list, size_t index, void *dt, size_t len,
+                   PrintFunc print_func);
+
+// Typed lists accept this only with LIST_OWN_REFERENCE.
+int list_append_reference(LinkedList *list, void *dt, size_t len,
                           PrintFunc print_func);
-void list_print(void *lista, int len);
+void list_print(void *lista, size_t len);
 
 void list_inverter(LinkedList *list);
+
+// Unlinks the first node and recycles it (a copied payload goes with it;
+// a typed list's destroy callback runs first).
+int list_remove_head(LinkedList *list);
+
+// Unlinks and recycles every node after the first count, without calling
+// destroy (as free_list_shallow). O(count) to find the new tail.
+int list_truncate_shallow(LinkedList *list, size_t count);
+
+/*
+ * Iteration. All three walk head to tail and keep a second pointer
+ * LIST_PREFETCH_DISTANCE nodes in front of the current one, prefetching
+ * that node (and a referenced payload) before the visitor needs it. The
+ * list must not be modified during the walk.
+ */
+void list_cursor_init(ListCursor *cursor, LinkedList *list);
+
+// Stores the next payload in *data / *len and returns 1, or returns 0 at the
+// end. Either output may be NULL.
+int list_cursor_next(ListCursor *cursor, void **data, size_t *len);
+
+void list_for_each(LinkedList *list, ListVisitor visit, void *ctx);
+
+void list_for_each_batch(LinkedList *list, ListBatchVisitor visit, void *ctx);
+
+/*
+ * Ordering. Both relink nodes in place and allocate nothing; on ties the
+ * node that came first stays first.
+ */
+
+// Bottom-up merge sort: O(n log n), O(log n) stack. A NULL cmp uses the
+// list type's compare.
+int list_sort(LinkedList *list, ListCompare cmp);
+
+// Merges sorted src into sorted dst (dst's nodes win ties). src is left
+// empty but must still be freed; its node memory moves over to dst. Both
+// lists must share a layout (untyped, or the same elem_size/ownership).
+int list_merge(LinkedList *dst, LinkedList *src, ListCompare cmp);
+
+// Pre-allocates pool memory so the next count appends of payload_len bytes
+// each take no further allocation.
+int list_reserve(LinkedList *list, size_t count, size_t payload_len);
+
 void free_list(LinkedList *list);
 
 void free_list_shallow(LinkedList *list);
-int list_get_node_count(LinkedList *list);
+// Counts are size_t and O(1); a NULL list reports 0.
+size_t list_get_node_count(LinkedList *list);
 
-int list_get_total_bytes(LinkedList *list);
+size_t list_get_total_bytes(LinkedList *list);
 
 #endif // LINKEDLIST_H
@@ -0,0 +1,42 @@
+#include "list_array.h"
+#include <stdint.h>
+
+int list_to_dynamic_array(LinkedList *list, DynamicArray *da) {
+  if (list == NULL || da == NULL)
+    return -1;
+  size_t old = da_size(da);
+  size_t count = list_get_node_count(list);
+  if (count > SIZE_MAX - old || da_reserve(da, old + count) != DYN_OK)
+    return -1;
+
+  size_t es = da_elem_size(da);
+  ListCursor cursor;
+  void *data;
+  size_t len;
+  list_cursor_init(&cursor, list);
+  while (list_cursor_next(&cursor, &data, &len)) {
+    if (len != es) {
+      da_truncate(da, old);
+      return -1;
+    }
+    da_push_back(da, data); // capacity is reserved: cannot fail
+  }
+  return 0;
+}
+
+int list_from_dynamic_array(LinkedList *list, const DynamicArray *da,
+                            PrintFunc print_func) {
+  if (list == NULL || da == NULL)
+    return -1;
+  size_t old = list_get_node_count(list);
+  size_t n = da_size(da), es = da_elem_size(da);
+  if (list_reserve(list, n, es) != 0)
+    return -1;
+  const unsigned char *elem = da_cdata(da);
+  for (size_t i = 0; i < n; ++i, elem += es)
+    if (list_append(list, (void *)elem, es, print_func) != 0) {
+      list_truncate_shallow(list, old); // copies of da's bytes: no destroy
+      return -1;
+    }
+  return 0;
+}
@@ -0,0 +1,27 @@
+#ifndef LIST_ARRAY_H
+#define LIST_ARRAY_H
+
+#include "../dynamic_array/dynamic_array.h"
+#include "linked_list.h"
+
+/*
+ * Bulk conversion between LinkedList and DynamicArray. Kept out of
+ * linked_list.c so the list itself does not depend on dynamic_array.
+ *
+ * Both reserve the destination once and copy each payload exactly once.
+ * Return values follow linked_list: 0 on success, -1 on failure.
+ */
+
+// Appends every payload to da as one element, in list order. Each payload
+// must be exactly da_elem_size(da) bytes; otherwise da is restored to its
+// previous size and -1 is returned.
+int list_to_dynamic_array(LinkedList *list, DynamicArray *da);
+
+// Appends a copied node for every element of da, in index order. If an
+// append fails (e.g. a typed list whose elem_size differs from
+// da_elem_size(da)), the nodes appended so far are removed again without
+// calling destroy, and -1 is returned.
+int list_from_dynamic_array(LinkedList *list, const DynamicArray *da,
+                            PrintFunc print_func);
+
+#endif // LIST_ARRAY_H
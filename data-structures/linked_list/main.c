@@ -1,25 +1,155 @@
+#include "intrusive_list.h"
 #include "linked_list.h" // Inclui nossa nova biblioteca
+#include "list_array.h"
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-void print_int(void *data, int len) {
+void print_int(void *data, size_t len) {
   printf("       %d       ", *(int *)data);
 }
-void print_float(void *data, int len) { printf("     %f    ", *(float *)data); }
-void print_string(void *data, int len) { printf("    %s   ", (char *)data); }
+void print_float(void *data, size_t len) {
+  printf("     %f    ", *(float *)data);
+}
+void print_string(void *data, size_t len) {
+  printf("    %s   ", (char *)data);
+}
 
-void print_int_arr(void *data, int len) {
+void print_int_arr(void *data, size_t len) {
 
-  int count = len / sizeof(int);
+  size_t count = len / sizeof(int);
   printf("    [");
-  for (int i = 0; i < count; ++i) {
+  for (size_t i = 0; i < count; ++i) {
     printf(" %d ", ((int *)data)[i]);
   }
   printf("]     ");
 }
 
+/*
+ * Checks for list_sort, list_merge and the DynamicArray conversions, on a
+ * typed list of (key, seq) pairs: seq records insertion order, so ties show
+ * whether an operation is stable. They run before the printing demo.
+ *
+ * Build: gcc -O2 main.c linked_list.c list_array.c ../node_pool/node_pool.c \
+ *        ../dynamic_array/dynamic_array.c
+ */
+
+typedef struct {
+  int key;
+  int seq;
+} Pair;
+
+static int by_key(const void *a, const void *b) {
+  int x = ((const Pair *)a)->key, y = ((const Pair *)b)->key;
+  return (x > y) - (x < y);
+}
+
+static const ListType pair_type = {.elem_size = sizeof(Pair),
+                                   .compare = by_key};
+
+static LinkedList *pairs_of(const int *keys, int n, int first_seq) {
+  LinkedList *list = create_typed_list(&pair_type);
+  assert(list);
+  for (int i = 0; i < n; ++i) {
+    Pair p = {keys[i], first_seq + i};
+    int st = list_append(list, &p, sizeof(p), NULL);
+    assert(st == 0);
+  }
+  return list;
+}
+
+// Copies the list out through a DynamicArray (itself under test).
+static DynamicArray *array_of(LinkedList *list) {
+  DynamicArray *da = da_create(sizeof(Pair));
+  assert(da);
+  int st = list_to_dynamic_array(list, da);
+  assert(st == 0 && da_size(da) == list_get_node_count(list));
+  return da;
+}
+
+static void check_sort(void) {
+  int keys[] = {3, 1, 3, 2, 1, 3, 2, 1};
+  LinkedList *list = pairs_of(keys, 8, 0);
+  int st = list_sort(list, NULL);
+  assert(st == 0 && list_get_node_count(list) == 8);
+  DynamicArray *da = array_of(list);
+  const Pair *p = da_cdata(da);
+  for (size_t i = 1; i < da_size(da); ++i)
+    assert(p[i - 1].key < p[i].key ||
+           (p[i - 1].key == p[i].key && p[i - 1].seq < p[i].seq));
+  da_destroy(da);
+  free_list(list);
+  printf("list_sort: stable on duplicate keys\n");
+}
+
+static void check_merge(void) {
+  int a_keys[] = {1, 4, 7}, b_keys[] = {2, 4, 8};
+  LinkedList *a = pairs_of(a_keys, 3, 0), *b = pairs_of(b_keys, 3, 10);
+  int st = list_merge(a, b, NULL);
+  assert(st == 0 && list_get_node_count(a) == 6);
+  assert(list_get_node_count(b) == 0 && list_get_total_bytes(b) == 0);
+  DynamicArray *da = array_of(a);
+  const Pair *p = da_cdata(da);
+  const Pair want[] = {{1, 0}, {2, 10}, {4, 1}, {4, 11}, {7, 2}, {8, 12}};
+  for (size_t i = 0; i < 6; ++i)
+    assert(p[i].key == want[i].key && p[i].seq == want[i].seq);
+  da_destroy(da);
+  free_list(b);
+  free_list(a);
+  printf("list_merge: sorted, dst wins ties, src left empty\n");
+}
+
+static void check_array_round_trip(void) {
+  int keys[] = {5, 9, 2, 7};
+  LinkedList *list = pairs_of(keys, 4, 0);
+  DynamicArray *da = array_of(list);
+  LinkedList *back = create_typed_list(&pair_type);
+  assert(back);
+  int st = list_from_dynamic_array(back, da, NULL);
+  assert(st == 0 && list_get_node_count(back) == 4);
+  DynamicArray *again = array_of(back);
+  assert(memcmp(da_cdata(da), da_cdata(again), 4 * sizeof(Pair)) == 0);
+
+  // the rollback helper: keep a prefix, and the tail still takes appends
+  st = list_truncate_shallow(back, 2);
+  assert(st == 0 && list_get_node_count(back) == 2);
+  assert(list_get_total_bytes(back) == 2 * sizeof(Pair));
+  Pair last = {1, 99};
+  st = list_append(back, &last, sizeof(last), NULL);
+  assert(st == 0 && list_get_node_count(back) == 3);
+
+  // payload size mismatch: both directions fail and restore the destination
+  int x = 42;
+  LinkedList *ints = create_list();
+  assert(ints);
+  st = list_append(ints, &x, sizeof(x), NULL);
+  assert(st == 0);
+  st = list_to_dynamic_array(ints, da);
+  assert(st == -1 && da_size(da) == 4);
+  ListType int_type = {.elem_size = sizeof(int)};
+  LinkedList *narrow = create_typed_list(&int_type);
+  assert(narrow);
+  st = list_append(narrow, &x, sizeof(x), NULL);
+  assert(st == 0);
+  st = list_from_dynamic_array(narrow, da, NULL);
+  assert(st == -1 && list_get_node_count(narrow) == 1);
+  assert(list_get_total_bytes(narrow) == sizeof(int));
+
+  free_list(narrow);
+  free_list(ints);
+  da_destroy(again);
+  da_destroy(da);
+  free_list(back);
+  free_list(list);
+  printf("list <-> DynamicArray: round trip equal, mismatch rolled back\n");
+}
+
 int main() {
+  check_sort();
+  check_merge();
+  check_array_round_trip();
+
   int value1 = 12;
   float value2 = 12.123;
   char str1[] = "star wars";
@@ -48,4 +178,20 @@ int main() {
   //  list_print(list, 2);
   free_list(list);
   free_list(list2);
+
+  // intrusive list: the links live inside the objects, nothing is allocated
+  typedef struct {
+    int id;
+    ListLink link;
+  } Job;
+  Job jobs[4] = {{.id = 1}, {.id = 2}, {.id = 3}, {.id = 4}};
+  IntrusiveList queue;
+  ilist_init(&queue);
+  for (int i = 0; i < 4; ++i)
+    ilist_push_back(&queue, &jobs[i].link);
+  ilist_remove(&queue, &jobs[1].link);
+  ilist_for_each(&queue, it) {
+    printf(" job %d", list_container_of(it, Job, link)->id);
+  }
+  putchar('\n');
 }
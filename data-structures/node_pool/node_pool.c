@@ -0,0 +1,115 @@
+#include "node_pool.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void *backing_alloc(NodePool *pool, size_t bytes) {
+  if (pool->hooks.alloc != NULL)
+    return pool->hooks.alloc(bytes, pool->hooks.ctx);
+  return malloc(bytes);
+}
+
+static void backing_free(NodePool *pool, void *ptr) {
+  if (pool->hooks.free != NULL)
+    pool->hooks.free(ptr, pool->hooks.ctx);
+  else
+    free(ptr);
+}
+
+void node_pool_init(NodePool *pool, const NodeAllocator *hooks) {
+  memset(pool, 0, sizeof(*pool));
+  if (hooks != NULL)
+    pool->hooks = *hooks;
+}
+
+int node_pool_reserve(NodePool *pool, size_t bytes) {
+  if ((size_t)(pool->end - pool->bump) >= bytes)
+    return 0;
+  size_t size = bytes > NODE_POOL_CHUNK ? bytes : NODE_POOL_CHUNK;
+  if (size > SIZE_MAX - sizeof(PoolChunk))
+    return -1;
+  PoolChunk *chunk = backing_alloc(pool, sizeof(PoolChunk) + size);
+  if (chunk == NULL)
+    return -1;
+  if (pool->chunks == NULL)
+    pool->last_chunk = chunk;
+  chunk->next = pool->chunks;
+  pool->chunks = chunk;
+  pool->bump = chunk->mem;
+  pool->end = chunk->mem + size;
+  return 0;
+}
+
+void *node_pool_alloc(NodePool *pool, size_t bytes) {
+  if (bytes > NODE_POOL_MAX_NODE) {
+    void *node = backing_alloc(pool, bytes);
+    if (node != NULL)
+      pool->heap_nodes++;
+    return node;
+  }
+  size_t cls = bytes / NODE_POOL_ALIGN - 1;
+  FreeSlot *slot = pool->free_slots[cls];
+  if (slot != NULL) {
+    pool->free_slots[cls] = slot->next;
+    return slot;
+  }
+  if (node_pool_reserve(pool, bytes) != 0)
+    return NULL;
+  void *mem = pool->bump;
+  pool->bump += bytes;
+  return mem;
+}
+
+void node_pool_free(NodePool *pool, void *node, size_t bytes) {
+  if (bytes > NODE_POOL_MAX_NODE) {
+    pool->heap_nodes--;
+    backing_free(pool, node);
+    return;
+  }
+  size_t cls = bytes / NODE_POOL_ALIGN - 1;
+  FreeSlot *slot = node;
+  if (pool->free_slots[cls] == NULL)
+    pool->free_tails[cls] = slot;
+  slot->next = pool->free_slots[cls];
+  pool->free_slots[cls] = slot;
+}
+
+// The larger remaining bump region is kept.
+int node_pool_absorb(NodePool *dst, NodePool *src) {
+  if (dst->hooks.alloc != src->hooks.alloc ||
+      dst->hooks.free != src->hooks.free || dst->hooks.ctx != src->hooks.ctx)
+    return -1;
+  if (src->chunks != NULL) {
+    if (dst->chunks == NULL)
+      dst->last_chunk = src->last_chunk;
+    src->last_chunk->next = dst->chunks;
+    dst->chunks = src->chunks;
+  }
+  if (src->end - src->bump > dst->end - dst->bump) {
+    dst->bump = src->bump;
+    dst->end = src->end;
+  }
+  for (size_t cls = 0; cls < NODE_POOL_CLASSES; ++cls) {
+    if (src->free_slots[cls] == NULL)
+      continue;
+    if (dst->free_slots[cls] == NULL)
+      dst->free_tails[cls] = src->free_tails[cls];
+    src->free_tails[cls]->next = dst->free_slots[cls];
+    dst->free_slots[cls] = src->free_slots[cls];
+  }
+  dst->heap_nodes += src->heap_nodes;
+  NodeAllocator hooks = src->hooks;
+  node_pool_init(src, &hooks);
+  return 0;
+}
+
+void node_pool_destroy(NodePool *pool) {
+  PoolChunk *chunk = pool->chunks;
+  while (chunk != NULL) {
+    PoolChunk *next = chunk->next;
+    backing_free(pool, chunk);
+    chunk = next;
+  }
+  NodeAllocator hooks = pool->hooks;
+  node_pool_init(pool, &hooks);
+}
@@ -0,0 +1,80 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <stdalign.h>
+#include <stddef.h>
+
+/*
+ * Size-class node allocator shared by the linked structures (linked_list,
+ * deque, ...).
+ *
+ * Nodes up to NODE_POOL_MAX_NODE bytes are bump-allocated from
+ * NODE_POOL_CHUNK byte chunks and recycled through one free list per
+ * NODE_POOL_ALIGN size class; larger nodes go straight to the backing
+ * allocator and are counted in heap_nodes. Destroying the pool releases all
+ * chunks at once, so owners only have to walk their nodes when heap_nodes is
+ * non-zero.
+ *
+ * The backing allocator is malloc/free unless NodeAllocator hooks are given;
+ * a zero-initialised NodePool is a valid, empty malloc-backed pool.
+ *
+ * Return values follow linked_list: 0 on success, -1 on failure.
+ */
+
+#define NODE_POOL_CHUNK (64 * 1024)
+#define NODE_POOL_ALIGN 16
+#define NODE_POOL_MAX_NODE 512
+#define NODE_POOL_CLASSES (NODE_POOL_MAX_NODE / NODE_POOL_ALIGN)
+
+// Node sizes handed to the pool must be rounded with this.
+#define NODE_POOL_ROUND(bytes)                                                 \
+  (((bytes) + NODE_POOL_ALIGN - 1) & ~(size_t)(NODE_POOL_ALIGN - 1))
+
+typedef struct {
+  void *(*alloc)(size_t bytes, void *ctx);
+  void (*free)(void *ptr, void *ctx);
+  void *ctx;
+} NodeAllocator;
+
+typedef struct pool_chunk {
+  struct pool_chunk *next;
+  alignas(max_align_t) unsigned char mem[];
+} PoolChunk;
+
+typedef struct free_slot {
+  struct free_slot *next;
+} FreeSlot;
+
+typedef struct node_pool {
+  PoolChunk *chunks;
+  PoolChunk *last_chunk; // oldest chunk, valid while chunks != NULL
+  unsigned char *bump;   // next free byte in the newest chunk
+  unsigned char *end;    // end of the newest chunk
+  FreeSlot *free_slots[NODE_POOL_CLASSES];
+  FreeSlot *free_tails[NODE_POOL_CLASSES]; // valid while the list is non-empty
+  size_t heap_nodes; // nodes larger than NODE_POOL_MAX_NODE
+  NodeAllocator hooks;
+} NodePool;
+
+// hooks may be NULL (malloc/free).
+void node_pool_init(NodePool *pool, const NodeAllocator *hooks);
+
+// bytes must be NODE_POOL_ROUND'ed. NULL on failure.
+void *node_pool_alloc(NodePool *pool, size_t bytes);
+
+// Gives back a node obtained with the same byte count.
+void node_pool_free(NodePool *pool, void *node, size_t bytes);
+
+// Makes sure the next `bytes` bytes of small nodes come from one chunk.
+int node_pool_reserve(NodePool *pool, size_t bytes);
+
+// Moves all of src's memory (chunks, free slots, heap node count) into dst
+// and leaves src empty, in O(NODE_POOL_CLASSES): chunk and free lists are
+// spliced through their tails, not walked. Fails if the pools use
+// different hooks.
+int node_pool_absorb(NodePool *dst, NodePool *src);
+
+// Releases every chunk. Heap nodes must have been freed by the owner.
+void node_pool_destroy(NodePool *pool);
+
+#endif // NODE_POOL_H
@@ -0,0 +1,138 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include "skip_list.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Skip list demo and throughput:
+ *   - single-threaded insert / lookup of N random keys;
+ *   - concurrent mix: T threads doing 90% lookups, 5% inserts and 5%
+ *     removals against a prefilled list.
+ *
+ * Build: gcc -O2 -pthread main.c skip_list.c
+ */
+
+#define N (1 << 18)
+#define MIX_OPS 500000 // per thread
+#define MAX_THREADS 8
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t splitmix(uint64_t *s) {
+  uint64_t z = (*s += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+static int cmp_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+static void print_u64(void *elem, void *ctx) {
+  (void)ctx;
+  printf(" %llu", (unsigned long long)*(uint64_t *)elem);
+}
+
+static void bench_single(void) {
+  SkipList *sl = skl_create(sizeof(uint64_t), cmp_u64, 0);
+  assert(sl);
+  uint64_t seed = 1;
+  double t0 = now();
+  for (int i = 0; i < N; ++i) {
+    uint64_t k = splitmix(&seed);
+    skl_insert(sl, &k);
+  }
+  double t1 = now();
+  seed = 1;
+  size_t hits = 0;
+  for (int i = 0; i < N; ++i) {
+    uint64_t k = splitmix(&seed);
+    hits += skl_contains(sl, &k);
+  }
+  double t2 = now();
+  assert(hits == skl_size(sl));
+  printf("single thread (%d keys): insert %.2f Mops/s, lookup %.2f Mops/s\n",
+         N, N / (t1 - t0) / 1e6, N / (t2 - t1) / 1e6);
+  skl_destroy(sl);
+}
+
+typedef struct {
+  SkipList *sl;
+  uint64_t seed;
+} Worker;
+
+static void *mix_worker(void *arg) {
+  Worker *w = arg;
+  for (int i = 0; i < MIX_OPS; ++i) {
+    uint64_t r = splitmix(&w->seed);
+    uint64_t key = r % (2 * N); // about half the key space is present
+    unsigned op = (unsigned)(r >> 56) % 100;
+    if (op < 90)
+      skl_contains(w->sl, &key);
+    else if (op < 95)
+      skl_insert(w->sl, &key);
+    else
+      skl_remove(w->sl, &key, NULL);
+  }
+  return NULL;
+}
+
+static void bench_concurrent(int threads) {
+  SkipList *sl = skl_create(sizeof(uint64_t), cmp_u64, SKIP_CONCURRENT);
+  assert(sl);
+  for (uint64_t k = 0; k < 2 * N; k += 2)
+    skl_insert(sl, &k);
+
+  Worker w[MAX_THREADS];
+  pthread_t th[MAX_THREADS];
+  double t0 = now();
+  for (int i = 0; i < threads; ++i) {
+    w[i] = (Worker){.sl = sl, .seed = (uint64_t)i + 100};
+    pthread_create(&th[i], NULL, mix_worker, &w[i]);
+  }
+  for (int i = 0; i < threads; ++i)
+    pthread_join(th[i], NULL);
+  double dt = now() - t0;
+
+  // the list must still be ordered and its count must match
+  size_t n = 0;
+  uint64_t prev = 0;
+  for (uint64_t *e = skl_lower_bound(sl, NULL); e != NULL; n++) {
+    assert(n == 0 || *e > prev);
+    prev = *e;
+    uint64_t next = prev + 1;
+    e = skl_lower_bound(sl, &next);
+  }
+  assert(n == skl_size(sl));
+  printf("concurrent 90/5/5 mix, %d thread(s): %.2f Mops/s\n", threads,
+         threads * (double)MIX_OPS / dt / 1e6);
+  skl_destroy(sl);
+}
+
+int main() {
+  // small demo: ordered inserts, range scan, removal
+  SkipList *sl = skl_create(sizeof(uint64_t), cmp_u64, 0);
+  for (uint64_t k = 20; k > 0; --k)
+    skl_insert(sl, &(uint64_t){k * 5});
+  uint64_t lo = 23, hi = 60, gone = 40;
+  skl_remove(sl, &gone, NULL);
+  printf("[%llu, %llu):", (unsigned long long)lo, (unsigned long long)hi);
+  skl_range(sl, &lo, &hi, print_u64, NULL);
+  printf("  lower_bound(%llu) = %llu\n", (unsigned long long)gone,
+         (unsigned long long)*(uint64_t *)skl_lower_bound(sl, &gone));
+  skl_destroy(sl);
+
+  bench_single();
+  for (int t = 1; t <= 4; t *= 2)
+    bench_concurrent(t);
+  return 0;
+}
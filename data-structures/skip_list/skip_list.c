@@ -0,0 +1,404 @@
+#include "skip_list.h"
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Node: header, tower of `height` next pointers, then the element at a
+ * 16-byte aligned offset. One allocation per node.
+ *
+ * Concurrent protocol (Herlihy, Lev, Luchangco, Shavit, "A Simple Optimistic
+ * Skiplist Algorithm"):
+ *   - a node is in the set once fully_linked is set and until marked is set;
+ *   - writers search without locks, lock the predecessors, validate that
+ *     they are unmarked and still point at the expected successors, and
+ *     retry from scratch otherwise;
+ *   - removal marks the victim first (logical delete), then unlinks it top
+ *     down; its own next pointers are left intact so readers standing on it
+ *     can keep going.
+ */
+
+#define PAYLOAD_ALIGN 16
+
+struct skl_node {
+  struct skl_node *retired; // chain of removed nodes awaiting reclaim
+  atomic_int lock;
+  atomic_int marked;
+  atomic_int fully_linked;
+  int height;
+  _Atomic(struct skl_node *) next[];
+};
+
+typedef struct skl_node SkipNode;
+
+struct skip_list {
+  SkipNode *head; // sentinel of height SKIP_MAX_LEVEL
+  SkipCompare cmp;
+  size_t elem_size;
+  int concurrent;
+  atomic_int level; // highest level in use
+  atomic_size_t size;
+  atomic_int retired_lock;
+  SkipNode *retired;
+};
+
+/* --- helpers --- */
+
+static size_t payload_offset(int height) {
+  size_t bytes = sizeof(SkipNode) + (size_t)height * sizeof(SkipNode *);
+  return (bytes + PAYLOAD_ALIGN - 1) & ~(size_t)(PAYLOAD_ALIGN - 1);
+}
+
+static void *payload(SkipNode *node) {
+  return (unsigned char *)node + payload_offset(node->height);
+}
+
+static SkipNode *next_of(SkipNode *node, int level) {
+  return atomic_load_explicit(&node->next[level], memory_order_acquire);
+}
+
+static void set_next(SkipNode *node, int level, SkipNode *next) {
+  atomic_store_explicit(&node->next[level], next, memory_order_release);
+}
+
+static void spin_lock(atomic_int *lock) {
+  int expected = 0;
+  while (!atomic_compare_exchange_weak_explicit(
+      lock, &expected, 1, memory_order_acquire, memory_order_relaxed))
+    expected = 0;
+}
+
+static void spin_unlock(atomic_int *lock) {
+  atomic_store_explicit(lock, 0, memory_order_release);
+}
+
+static void lock_node(const SkipList *list, SkipNode *node) {
+  if (list->concurrent)
+    spin_lock(&node->lock);
+}
+
+static void unlock_node(const SkipList *list, SkipNode *node) {
+  if (list->concurrent)
+    spin_unlock(&node->lock);
+}
+
+// Geometric level from a thread-local xorshift generator.
+static int random_level(void) {
+  static _Thread_local uint64_t state = 0;
+  if (state == 0)
+    state = (uint64_t)(uintptr_t)&state * 0x9E3779B97F4A7C15ull | 1;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  uint64_t bits = state;
+  int level = 1;
+  while (level < SKIP_MAX_LEVEL &&
+         (bits & ((1u << SKIP_P_SHIFT) - 1)) == 0) {
+    level++;
+    bits >>= SKIP_P_SHIFT;
+  }
+  return level;
+}
+
+static SkipNode *new_node(size_t elem_size, int height, const void *elem) {
+  SkipNode *node = malloc(payload_offset(height) + elem_size);
+  if (node == NULL)
+    return NULL;
+  node->retired = NULL;
+  atomic_init(&node->lock, 0);
+  atomic_init(&node->marked, 0);
+  atomic_init(&node->fully_linked, 0);
+  node->height = height;
+  for (int i = 0; i < height; ++i)
+    atomic_init(&node->next[i], NULL);
+  if (elem != NULL)
+    memcpy(payload(node), elem, elem_size);
+  return node;
+}
+
+/*
+ * Fills preds/succs for every level below SKIP_MAX_LEVEL and returns the
+ * highest level at which a node equal to key was seen, or -1.
+ */
+static int find(SkipList *list, const void *key, SkipNode **preds,
+                SkipNode **succs) {
+  int found = -1;
+  int top = atomic_load_explicit(&list->level, memory_order_acquire);
+  SkipNode *pred = list->head;
+  for (int level = SKIP_MAX_LEVEL - 1; level >= top; --level) {
+    preds[level] = pred;
+    succs[level] = next_of(pred, level);
+  }
+  SkipNode *bound = NULL; // already compared one level up: not less than key
+  for (int level = top - 1; level >= 0; --level) {
+    SkipNode *curr = next_of(pred, level);
+    int c = 1;
+    while (curr != NULL && curr != bound) {
+      c = list->cmp(payload(curr), key);
+      if (c >= 0)
+        break;
+      pred = curr;
+      curr = next_of(pred, level);
+    }
+    if (found == -1 && curr != NULL && curr != bound && c == 0)
+      found = level;
+    bound = curr;
+    preds[level] = pred;
+    succs[level] = curr;
+  }
+  return found;
+}
+
+static void raise_level(SkipList *list, int height) {
+  int top = atomic_load_explicit(&list->level, memory_order_relaxed);
+  while (top < height &&
+         !atomic_compare_exchange_weak(&list->level, &top, height))
+    ;
+}
+
+static int is_live(SkipNode *node) {
+  return atomic_load_explicit(&node->fully_linked, memory_order_acquire) &&
+         !atomic_load_explicit(&node->marked, memory_order_acquire);
+}
+
+/* --- API --- */
+
+SkipList *skl_create(size_t elem_size, SkipCompare cmp, int flags) {
+  if (elem_size == 0 || cmp == NULL)
+    return NULL;
+  SkipList *list = calloc(1, sizeof(SkipList));
+  if (list == NULL)
+    return NULL;
+  list->head = new_node(0, SKIP_MAX_LEVEL, NULL);
+  if (list->head == NULL) {
+    free(list);
+    return NULL;
+  }
+  list->cmp = cmp;
+  list->elem_size = elem_size;
+  list->concurrent = (flags & SKIP_CONCURRENT) != 0;
+  atomic_init(&list->level, 1);
+  atomic_init(&list->size, 0);
+  atomic_init(&list->retired_lock, 0);
+  return list;
+}
+
+// Unlocks the distinct predecessors preds[0..highest].
+static void unlock_preds(SkipList *list, SkipNode **preds, int highest) {
+  SkipNode *prev = NULL;
+  for (int level = 0; level <= highest; ++level) {
+    if (preds[level] != prev)
+      unlock_node(list, preds[level]);
+    prev = preds[level];
+  }
+}
+
+int skl_insert(SkipList *list, const void *elem) {
+  if (list == NULL || elem == NULL)
+    return -1;
+  int height = random_level();
+  SkipNode *preds[SKIP_MAX_LEVEL], *succs[SKIP_MAX_LEVEL];
+  for (;;) {
+    int found = find(list, elem, preds, succs);
+    if (found != -1) {
+      SkipNode *node = succs[found];
+      if (!atomic_load_explicit(&node->marked, memory_order_acquire)) {
+        // present (possibly still being linked by its inserter)
+        while (!atomic_load_explicit(&node->fully_linked, memory_order_acquire))
+          ;
+        return 1;
+      }
+      continue; // being removed: retry once it is gone
+    }
+
+    int highest = -1, valid = 1;
+    SkipNode *prev = NULL;
+    for (int level = 0; valid && level < height; ++level) {
+      SkipNode *pred = preds[level], *succ = succs[level];
+      if (pred != prev) {
+        lock_node(list, pred);
+        prev = pred;
+      }
+      highest = level;
+      valid = !atomic_load_explicit(&pred->marked, memory_order_acquire) &&
+              (succ == NULL ||
+               !atomic_load_explicit(&succ->marked, memory_order_acquire)) &&
+              next_of(pred, level) == succ;
+    }
+    if (!valid) {
+      unlock_preds(list, preds, highest);
+      continue;
+    }
+
+    SkipNode *node = new_node(list->elem_size, height, elem);
+    if (node == NULL) {
+      unlock_preds(list, preds, highest);
+      return -1;
+    }
+    for (int level = 0; level < height; ++level)
+      atomic_init(&node->next[level], succs[level]);
+    for (int level = 0; level < height; ++level)
+      set_next(preds[level], level, node);
+    atomic_store_explicit(&node->fully_linked, 1, memory_order_release);
+    unlock_preds(list, preds, highest);
+    raise_level(list, height);
+    atomic_fetch_add_explicit(&list->size, 1, memory_order_relaxed);
+    return 0;
+  }
+}
+
+static void retire(SkipList *list, SkipNode *node) {
+  if (!list->concurrent) {
+    free(node);
+    return;
+  }
+  spin_lock(&list->retired_lock);
+  node->retired = list->retired;
+  list->retired = node;
+  spin_unlock(&list->retired_lock);
+}
+
+int skl_remove(SkipList *list, const void *key, void *out) {
+  if (list == NULL || key == NULL)
+    return -1;
+  SkipNode *preds[SKIP_MAX_LEVEL], *succs[SKIP_MAX_LEVEL];
+  SkipNode *victim = NULL;
+  int marked = 0, height = 0;
+  for (;;) {
+    int found = find(list, key, preds, succs);
+    if (!marked) {
+      if (found == -1)
+        return -1;
+      victim = succs[found];
+      // only the inserter's complete, unmarked node, found at its top level
+      if (!atomic_load_explicit(&victim->fully_linked, memory_order_acquire) ||
+          victim->height - 1 != found ||
+          atomic_load_explicit(&victim->marked, memory_order_acquire))
+        return -1;
+      height = victim->height;
+      lock_node(list, victim);
+      if (atomic_load_explicit(&victim->marked, memory_order_relaxed)) {
+        unlock_node(list, victim);
+        return -1; // another remover won
+      }
+      atomic_store_explicit(&victim->marked, 1, memory_order_release);
+      marked = 1;
+    }
+
+    int highest = -1, valid = 1;
+    SkipNode *prev = NULL;
+    for (int level = 0; valid && level < height; ++level) {
+      SkipNode *pred = preds[level];
+      if (pred != prev) {
+        lock_node(list, pred);
+        prev = pred;
+      }
+      highest = level;
+      valid = !atomic_load_explicit(&pred->marked, memory_order_acquire) &&
+              next_of(pred, level) == victim;
+    }
+    if (!valid) {
+      unlock_preds(list, preds, highest);
+      continue;
+    }
+
+    for (int level = height - 1; level >= 0; --level)
+      set_next(preds[level], level, next_of(victim, level));
+    if (out != NULL)
+      memcpy(out, payload(victim), list->elem_size);
+    unlock_node(list, victim);
+    unlock_preds(list, preds, highest);
+    atomic_fetch_sub_explicit(&list->size, 1, memory_order_relaxed);
+    retire(list, victim);
+    return 0;
+  }
+}
+
+// Lock-free descent to the first node not less than key (NULL: first node).
+static SkipNode *seek(SkipList *list, const void *key) {
+  SkipNode *pred = list->head, *curr = NULL;
+  int top = atomic_load_explicit(&list->level, memory_order_acquire);
+  SkipNode *bound = NULL;
+  for (int level = top - 1; level >= 0; --level) {
+    curr = next_of(pred, level);
+    while (key != NULL && curr != NULL && curr != bound &&
+           list->cmp(payload(curr), key) < 0) {
+      pred = curr;
+      curr = next_of(pred, level);
+    }
+    bound = curr;
+  }
+  while (curr != NULL && !is_live(curr))
+    curr = next_of(curr, 0);
+  return curr;
+}
+
+void *skl_lower_bound(SkipList *list, const void *key) {
+  if (list == NULL)
+    return NULL;
+  SkipNode *node = seek(list, key);
+  return node == NULL ? NULL : payload(node);
+}
+
+void *skl_find(SkipList *list, const void *key) {
+  if (list == NULL || key == NULL)
+    return NULL;
+  SkipNode *node = seek(list, key);
+  if (node == NULL || list->cmp(payload(node), key) != 0)
+    return NULL;
+  return payload(node);
+}
+
+int skl_contains(SkipList *list, const void *key) {
+  return skl_find(list, key) != NULL;
+}
+
+size_t skl_range(SkipList *list, const void *lo, const void *hi,
+                 SkipVisit visit, void *ctx) {
+  if (list == NULL || visit == NULL)
+    return 0;
+  size_t n = 0;
+  for (SkipNode *node = seek(list, lo); node != NULL; node = next_of(node, 0)) {
+    if (!is_live(node))
+      continue;
+    void *elem = payload(node);
+    if (hi != NULL && list->cmp(elem, hi) >= 0)
+      break;
+    visit(elem, ctx);
+    n++;
+  }
+  return n;
+}
+
+size_t skl_size(const SkipList *list) {
+  if (list == NULL)
+    return 0;
+  return atomic_load_explicit(&((SkipList *)list)->size, memory_order_relaxed);
+}
+
+void skl_reclaim(SkipList *list) {
+  if (list == NULL)
+    return;
+  SkipNode *node = list->retired;
+  while (node != NULL) {
+    SkipNode *next = node->retired;
+    free(node);
+    node = next;
+  }
+  list->retired = NULL;
+}
+
+void skl_destroy(SkipList *list) {
+  if (list == NULL)
+    return;
+  skl_reclaim(list);
+  SkipNode *node = list->head;
+  while (node != NULL) {
+    SkipNode *next = next_of(node, 0);
+    free(node);
+    node = next;
+  }
+  free(list);
+}
@@ -0,0 +1,76 @@
+#ifndef SKIP_LIST_H
+#define SKIP_LIST_H
+
+#include <stddef.h>
+
+/*
+ * Ordered skip list
+ *
+ * Stores unique fixed-size elements ordered by a comparator; lookups,
+ * inserts and removals are O(log n) expected. Each node's level is drawn
+ * from a geometric distribution (P(level > k) = SKIP_P^k) and its tower of
+ * next pointers lives in the same allocation as the node, followed by the
+ * copied element.
+ *
+ * Lookups take a probe element: only the fields the comparator looks at
+ * need to be set.
+ *
+ * Concurrent mode (SKIP_CONCURRENT) is a lazy skip list:
+ *   - skl_find, skl_lower_bound, skl_range and skl_contains take no locks;
+ *   - skl_insert / skl_remove lock only the predecessors they relink (plus
+ *     the victim on removal), so writers on different parts of the list do
+ *     not contend;
+ *   - removed nodes are not freed right away (readers may still be on
+ *     them). skl_reclaim frees them and must only be called while no other
+ *     thread is using the list; skl_destroy does the same.
+ * Pointers returned by lookups stay valid until the element is removed and
+ * reclaimed. Without SKIP_CONCURRENT the list is single-threaded and removal
+ * frees immediately.
+ *
+ * Return values follow linked_list: 0 on success, -1 on failure.
+ */
+
+#ifndef SKIP_MAX_LEVEL
+#define SKIP_MAX_LEVEL 24 // enough for ~4^24 elements at SKIP_P = 1/4
+#endif
+
+#define SKIP_P_SHIFT 2 // SKIP_P = 1 / (1 << SKIP_P_SHIFT)
+
+enum { SKIP_CONCURRENT = 1 };
+
+typedef struct skip_list SkipList;
+
+typedef int (*SkipCompare)(const void *a, const void *b);
+typedef void (*SkipVisit)(void *elem, void *ctx);
+
+// NULL on failure (zero elem_size, NULL cmp, out of memory).
+SkipList *skl_create(size_t elem_size, SkipCompare cmp, int flags);
+
+// Returns 0 if inserted, 1 if an equal element is already present (the list
+// is unchanged), -1 on allocation failure.
+int skl_insert(SkipList *list, const void *elem);
+
+// Removes the element equal to key; copies it to out when out is not NULL.
+// Returns -1 if there is none.
+int skl_remove(SkipList *list, const void *key, void *out);
+
+// Element equal to key, or NULL.
+void *skl_find(SkipList *list, const void *key);
+int skl_contains(SkipList *list, const void *key);
+
+// First element not less than key (NULL key: the first element), or NULL.
+void *skl_lower_bound(SkipList *list, const void *key);
+
+// Visits every element e with lo <= e < hi in order; NULL bounds are open.
+// Returns the number of elements visited.
+size_t skl_range(SkipList *list, const void *lo, const void *hi,
+                 SkipVisit visit, void *ctx);
+
+size_t skl_size(const SkipList *list);
+
+// Frees removed nodes (concurrent mode). No other thread may use the list.
+void skl_reclaim(SkipList *list);
+
+void skl_destroy(SkipList *list);
+
+#endif // SKIP_LIST_H
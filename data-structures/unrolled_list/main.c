@@ -0,0 +1,122 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include "../linked_list/linked_list.h"
+#include "unrolled_list.h"
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Compares the unrolled list with LinkedList on two workloads:
+ *   - iteration: summing ITER_N ints, through list_for_each on an untyped
+ *     and a typed (ListType, int-sized nodes) list, list_for_each_batch and
+ *     ulist_for_each;
+ *   - middle insert: INSERTS ints inserted at the middle of a BASE_N list.
+ *
+ * Build: gcc -O2 main.c unrolled_list.c ../linked_list/linked_list.c \
+ *        ../node_pool/node_pool.c
+ */
+
+#define ITER_N 2000000
+#define ITER_REPS 10
+#define BASE_N 100000
+#define INSERTS 20000
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void sum_int(void *elem, void *ctx) { *(long long *)ctx += *(int *)elem; }
+
+static void sum_node(void *data, size_t len, void *ctx) {
+  (void)len;
+  *(long long *)ctx += *(int *)data;
+}
+
+static void sum_batch(void **data, const size_t *lens, size_t n, void *ctx) {
+  (void)lens;
+  long long sum = 0;
+  for (size_t i = 0; i < n; ++i)
+    sum += *(int *)data[i];
+  *(long long *)ctx += sum;
+}
+
+static void bench_iteration(void) {
+  LinkedList *list = create_list();
+  LinkedList *typed = create_typed_list(&(ListType){.elem_size = sizeof(int)});
+  UnrolledList *ul = create_unrolled_list(sizeof(int));
+  assert(list && typed && ul);
+  for (int i = 0; i < ITER_N; ++i) {
+    list_append(list, &i, sizeof(i), NULL);
+    list_append(typed, &i, sizeof(i), NULL);
+    ulist_append(ul, &i);
+  }
+
+  long long sums[4] = {0, 0, 0, 0};
+  double tt = now();
+  for (int r = 0; r < ITER_REPS; ++r)
+    list_for_each(typed, sum_node, &sums[3]);
+  double t0 = now();
+  for (int r = 0; r < ITER_REPS; ++r)
+    list_for_each(list, sum_node, &sums[0]);
+  double t1 = now();
+  for (int r = 0; r < ITER_REPS; ++r)
+    list_for_each_batch(list, sum_batch, &sums[1]);
+  double t2 = now();
+  for (int r = 0; r < ITER_REPS; ++r)
+    ulist_for_each(ul, sum_int, &sums[2]);
+  double t3 = now();
+  assert(sums[0] == sums[2] && sums[1] == sums[2] && sums[3] == sums[2]);
+
+  double per = 1e9 / ITER_N / ITER_REPS;
+  printf("iteration (%d ints x %d): linked_list %.1f ns/elem, "
+         "typed linked_list %.1f ns/elem, linked_list batch %.1f ns/elem, "
+         "unrolled %.1f ns/elem (%zu per node)\n",
+         ITER_N, ITER_REPS, (t1 - t0) * per, (t0 - tt) * per, (t2 - t1) * per,
+         (t3 - t2) * per, ulist_node_capacity(ul));
+  free_list(list);
+  free_list(typed);
+  free_unrolled_list(ul);
+}
+
+static void bench_middle_insert(void) {
+  LinkedList *list = create_list();
+  UnrolledList *ul = create_unrolled_list(sizeof(int));
+  assert(list && ul);
+  for (int i = 0; i < BASE_N; ++i) {
+    list_append(list, &i, sizeof(i), NULL);
+    ulist_append(ul, &i);
+  }
+
+  double t0 = now();
+  for (int i = 0; i < INSERTS; ++i)
+    list_insert_at(list, list_get_node_count(list) / 2, &i, sizeof(i), NULL);
+  double t1 = now();
+  for (int i = 0; i < INSERTS; ++i)
+    ulist_insert_at(ul, ulist_size(ul) / 2, &i);
+  double t2 = now();
+
+  printf("middle insert (%d into %d): linked_list %.1f us/op, "
+         "unrolled %.1f us/op\n",
+         INSERTS, BASE_N, (t1 - t0) * 1e6 / INSERTS,
+         (t2 - t1) * 1e6 / INSERTS);
+  free_list(list);
+  free_unrolled_list(ul);
+}
+
+int main() {
+  // small demo: insert, remove and underflow merging
+  UnrolledList *ul = create_unrolled_list(sizeof(int));
+  for (int i = 0; i < 100; ++i)
+    ulist_insert_at(ul, ulist_size(ul) / 2, &i);
+  for (int i = 0; i < 60; ++i)
+    ulist_remove_at(ul, 10, NULL);
+  printf("%zu elements in %zu nodes, first = %d\n", ulist_size(ul),
+         ulist_node_count(ul), *(int *)ulist_get(ul, 0));
+  free_unrolled_list(ul);
+
+  bench_iteration();
+  bench_middle_insert();
+  return 0;
+}
@@ -0,0 +1,230 @@
+#include "unrolled_list.h"
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct unode {
+  struct unode *next;
+  size_t count;
+  alignas(16) unsigned char elems[];
+};
+
+struct unrolled_list {
+  struct unode *head;
+  struct unode *tail;
+  size_t size;
+  size_t nodes;
+  size_t elem_size;
+  size_t cap; // elements per node
+};
+
+static unsigned char *slot(const UnrolledList *list, struct unode *node,
+                           size_t i) {
+  return node->elems + i * list->elem_size;
+}
+
+static struct unode *new_node(UnrolledList *list) {
+  struct unode *node =
+      malloc(sizeof(struct unode) + list->cap * list->elem_size);
+  if (node == NULL)
+    return NULL;
+  node->next = NULL;
+  node->count = 0;
+  list->nodes++;
+  return node;
+}
+
+UnrolledList *create_unrolled_list(size_t elem_size) {
+  if (elem_size == 0 || elem_size > SIZE_MAX / 4)
+    return NULL;
+  UnrolledList *list = calloc(1, sizeof(UnrolledList));
+  if (list == NULL)
+    return NULL;
+  list->elem_size = elem_size;
+  size_t room = UNROLLED_NODE_BYTES > sizeof(struct unode)
+                    ? UNROLLED_NODE_BYTES - sizeof(struct unode)
+                    : 0;
+  list->cap = room / elem_size;
+  if (list->cap < 4) // keep split/merge meaningful for large elements
+    list->cap = 4;
+  return list;
+}
+
+size_t ulist_node_capacity(const UnrolledList *list) {
+  return list == NULL ? 0 : list->cap;
+}
+
+size_t ulist_size(const UnrolledList *list) {
+  return list == NULL ? 0 : list->size;
+}
+
+size_t ulist_node_count(const UnrolledList *list) {
+  return list == NULL ? 0 : list->nodes;
+}
+
+int ulist_append(UnrolledList *list, const void *elem) {
+  if (list == NULL || elem == NULL)
+    return -1;
+  struct unode *tail = list->tail;
+  if (tail == NULL || tail->count == list->cap) {
+    // appends fill nodes completely: no split needed at the end
+    struct unode *node = new_node(list);
+    if (node == NULL)
+      return -1;
+    if (tail == NULL)
+      list->head = node;
+    else
+      tail->next = node;
+    list->tail = tail = node;
+  }
+  memcpy(slot(list, tail, tail->count), elem, list->elem_size);
+  tail->count++;
+  list->size++;
+  return 0;
+}
+
+// Finds the node holding position index; *offset receives the local index.
+static struct unode *locate(const UnrolledList *list, size_t index,
+                            size_t *offset) {
+  struct unode *node = list->head;
+  while (node != NULL && index >= node->count) {
+    index -= node->count;
+    node = node->next;
+  }
+  *offset = index;
+  return node;
+}
+
+// Moves the upper half of a full node into a new node after it.
+static struct unode *split(UnrolledList *list, struct unode *node) {
+  struct unode *right = new_node(list);
+  if (right == NULL)
+    return NULL;
+  size_t keep = node->count / 2;
+  right->count = node->count - keep;
+  memcpy(right->elems, slot(list, node, keep), right->count * list->elem_size);
+  node->count = keep;
+  right->next = node->next;
+  node->next = right;
+  if (list->tail == node)
+    list->tail = right;
+  return right;
+}
+
+int ulist_insert_at(UnrolledList *list, size_t index, const void *elem) {
+  if (list == NULL || elem == NULL || index > list->size)
+    return -1;
+  if (index == list->size)
+    return ulist_append(list, elem);
+
+  size_t off;
+  struct unode *node = locate(list, index, &off);
+  if (node->count == list->cap) {
+    struct unode *right = split(list, node);
+    if (right == NULL)
+      return -1;
+    if (off > node->count) {
+      off -= node->count;
+      node = right;
+    }
+  }
+  unsigned char *at = slot(list, node, off);
+  memmove(at + list->elem_size, at, (node->count - off) * list->elem_size);
+  memcpy(at, elem, list->elem_size);
+  node->count++;
+  list->size++;
+  return 0;
+}
+
+// Unlinks and frees node; prev is its predecessor (NULL for head).
+static void drop_node(UnrolledList *list, struct unode *prev,
+                      struct unode *node) {
+  if (prev == NULL)
+    list->head = node->next;
+  else
+    prev->next = node->next;
+  if (list->tail == node)
+    list->tail = prev;
+  list->nodes--;
+  free(node);
+}
+
+// Restores the half-full invariant for node after a removal.
+static void rebalance(UnrolledList *list, struct unode *prev,
+                      struct unode *node) {
+  size_t half = list->cap / 2;
+  if (node->count == 0) {
+    drop_node(list, prev, node);
+    return;
+  }
+  struct unode *next = node->next;
+  if (node->count >= half || next == NULL)
+    return;
+
+  size_t es = list->elem_size;
+  if (node->count + next->count <= list->cap) {
+    // merge next into node
+    memcpy(slot(list, node, node->count), next->elems, next->count * es);
+    node->count += next->count;
+    drop_node(list, node, next);
+  } else {
+    // borrow just enough from next to reach half
+    size_t take = half - node->count;
+    memcpy(slot(list, node, node->count), next->elems, take * es);
+    memmove(next->elems, slot(list, next, take), (next->count - take) * es);
+    node->count += take;
+    next->count -= take;
+  }
+}
+
+int ulist_remove_at(UnrolledList *list, size_t index, void *out) {
+  if (list == NULL || index >= list->size)
+    return -1;
+
+  struct unode *prev = NULL, *node = list->head;
+  while (index >= node->count) {
+    index -= node->count;
+    prev = node;
+    node = node->next;
+  }
+  unsigned char *at = slot(list, node, index);
+  if (out != NULL)
+    memcpy(out, at, list->elem_size);
+  memmove(at, at + list->elem_size,
+          (node->count - index - 1) * list->elem_size);
+  node->count--;
+  list->size--;
+  rebalance(list, prev, node);
+  return 0;
+}
+
+void *ulist_get(UnrolledList *list, size_t index) {
+  if (list == NULL || index >= list->size)
+    return NULL;
+  size_t off;
+  struct unode *node = locate(list, index, &off);
+  return slot(list, node, off);
+}
+
+void ulist_for_each(UnrolledList *list, UnrolledVisit visit, void *ctx) {
+  if (list == NULL || visit == NULL)
+    return;
+  for (struct unode *node = list->head; node != NULL; node = node->next) {
+    unsigned char *p = node->elems;
+    for (size_t i = 0; i < node->count; ++i, p += list->elem_size)
+      visit(p, ctx);
+  }
+}
+
+void free_unrolled_list(UnrolledList *list) {
+  if (list == NULL)
+    return;
+  struct unode *node = list->head;
+  while (node != NULL) {
+    struct unode *next = node->next;
+    free(node);
+    node = next;
+  }
+  free(list);
+}
@@ -0,0 +1,56 @@
+#ifndef UNROLLED_LIST_H
+#define UNROLLED_LIST_H
+
+#include <stddef.h>
+
+/*
+ * Unrolled linked list
+ *
+ * Each node stores up to N fixed-size elements contiguously, with N chosen so
+ * that a node fills UNROLLED_NODE_BYTES (two cache lines by default).
+ * Traversal therefore takes one pointer chase per N elements instead of one
+ * per element.
+ *
+ * Invariants:
+ *   - every node except the last holds at least N / 2 elements after a
+ *     removal (underflow is fixed by borrowing from or merging with the next
+ *     node);
+ *   - inserting into a full node splits it into two half-full nodes.
+ *
+ * Return values follow linked_list: 0 on success, -1 on failure.
+ */
+
+#ifndef UNROLLED_NODE_BYTES
+#define UNROLLED_NODE_BYTES 128
+#endif
+
+typedef struct unrolled_list UnrolledList;
+
+typedef void (*UnrolledVisit)(void *elem, void *ctx);
+
+// Creates an empty list of elem_size-byte elements (NULL on failure).
+UnrolledList *create_unrolled_list(size_t elem_size);
+
+// Elements per node chosen for this list.
+size_t ulist_node_capacity(const UnrolledList *list);
+
+int ulist_append(UnrolledList *list, const void *elem);
+
+// Inserts before position index (index == size appends).
+int ulist_insert_at(UnrolledList *list, size_t index, const void *elem);
+
+// Removes the element at index; copies it to out when out is not NULL.
+int ulist_remove_at(UnrolledList *list, size_t index, void *out);
+
+// Pointer to the element at index, or NULL if out of range.
+void *ulist_get(UnrolledList *list, size_t index);
+
+// Calls visit on every element in order.
+void ulist_for_each(UnrolledList *list, UnrolledVisit visit, void *ctx);
+
+size_t ulist_size(const UnrolledList *list);
+size_t ulist_node_count(const UnrolledList *list);
+
+void free_unrolled_list(UnrolledList *list);
+
+#endif // UNROLLED_LIST_H
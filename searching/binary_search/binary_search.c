@@ -1,25 +1,140 @@
 #include "binary_search.h"
+#include "../../common/compare.h"
+#include "../../common/cpu_dispatch.h"
+#include <stdatomic.h>
 #include <stddef.h>
-#include <string.h>
+#if CPU_X86
+#include <immintrin.h>
+#endif
+
+/*
+ * Lower bound kernels for int arrays: index of the first element >= key.
+ *
+ * All variants run the same branchless halving (the compare feeds a
+ * conditional move instead of a hard-to-predict branch). The SIMD ones stop
+ * halving at one or two vectors' worth of candidates and count the
+ * elements < key there with a single compare; since the array is sorted,
+ * that count is the offset of the lower bound.
+ */
+
+typedef size_t (*LowerBoundInt)(const int *arr, size_t len, int key);
+
+static size_t lower_bound_scalar(const int *arr, size_t len, int key) {
+  if (len == 0)
+    return 0;
+  const int *base = arr;
+  while (len > 1) {
+    size_t half = len / 2;
+    base = base[half] < key ? base + half : base;
+    len -= half;
+  }
+  return (size_t)(base - arr) + (*base < key);
+}
+
+#if CPU_X86
+CPU_TARGET_AVX2 static size_t lower_bound_avx2(const int *arr, size_t len,
+                                               int key) {
+  if (len < 8)
+    return lower_bound_scalar(arr, len, key);
+  const int *base = arr;
+  while (len > 16) { // leaves 9..16 candidates in base[0, len)
+    size_t half = len / 2;
+    base = base[half] < key ? base + half : base;
+    len -= half;
+  }
+  // the elements < key form a prefix: count it in the first 8, and only
+  // if all 8 are below look at the last 8 (overlapping, never past len)
+  __m256i k = _mm256_set1_epi32(key);
+  __m256i lo = _mm256_loadu_si256((const __m256i *)base);
+  unsigned below = (unsigned)_mm256_movemask_ps(
+      _mm256_castsi256_ps(_mm256_cmpgt_epi32(k, lo)));
+  size_t count = (size_t)__builtin_popcount(below);
+  if (count == 8) {
+    __m256i hi = _mm256_loadu_si256((const __m256i *)(base + len - 8));
+    below = (unsigned)_mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(k, hi)));
+    count = len - 8 + (size_t)__builtin_popcount(below);
+  }
+  return (size_t)(base - arr) + count;
+}
+
+CPU_TARGET_AVX512 static size_t lower_bound_avx512(const int *arr, size_t len,
+                                                   int key) {
+  if (len < 16)
+    return lower_bound_scalar(arr, len, key);
+  const int *base = arr;
+  while (len > 32) { // leaves 17..32 candidates
+    size_t half = len / 2;
+    base = base[half] < key ? base + half : base;
+    len -= half;
+  }
+  __m512i k = _mm512_set1_epi32(key);
+  unsigned below = _mm512_cmplt_epi32_mask(_mm512_loadu_si512(base), k);
+  size_t count = (size_t)__builtin_popcount(below);
+  if (count == 16) {
+    below = _mm512_cmplt_epi32_mask(_mm512_loadu_si512(base + len - 16), k);
+    count = len - 16 + (size_t)__builtin_popcount(below);
+  }
+  return (size_t)(base - arr) + count;
+}
+#endif
+
+static size_t lower_bound_resolve(const int *arr, size_t len, int key);
+
+static _Atomic(LowerBoundInt) lower_bound_impl = lower_bound_resolve;
+
+// First call: pick the kernel for this CPU, then forward to it.
+static size_t lower_bound_resolve(const int *arr, size_t len, int key) {
+  LowerBoundInt impl = lower_bound_scalar;
+#if CPU_X86
+  switch (cpu_isa()) {
+  case CPU_ISA_AVX512:
+    impl = lower_bound_avx512;
+    break;
+  case CPU_ISA_AVX2:
+    impl = lower_bound_avx2;
+    break;
+  default:
+    break;
+  }
+#endif
+  atomic_store_explicit(&lower_bound_impl, impl, memory_order_relaxed);
+  return impl(arr, len, key);
+}
+
+size_t lower_bound_int(const int *arr, size_t len, int key) {
+  LowerBoundInt impl =
+      atomic_load_explicit(&lower_bound_impl, memory_order_relaxed);
+  return impl(arr, len, key);
+}
+
+ptrdiff_t binary_search_int(const int *arr, size_t len, int key) {
+  size_t idx = lower_bound_int(arr, len, key);
+  return idx < len && arr[idx] == key ? (ptrdiff_t)idx : -1;
+}
+
 /*
  * Iterative binary search implementation
  */
 ptrdiff_t binary_search(void *begin, size_t len, size_t elem_size,
                         const void *element, compfunc comp) {
-  void *end = begin + elem_size * len;
+  if (comp == compare_int && elem_size == sizeof(int))
+    return binary_search_int(begin, len, *(const int *)element);
+
+  const char *base = begin;
+  size_t lo = 0, hi = len; // search [lo, hi)
 
-  while (begin < end) {
-    void *mid = begin + (end - begin) / 2;
-    void *attpt;
-    memcpy(attpt, mid, len);
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    int order = comp(base + mid * elem_size, element);
 
-    if (comp(attpt, element) == 0)
+    if (order == 0)
       return (ptrdiff_t)mid; // Element found, return index
 
-    if (comp(attpt, element) == 1)
-      begin = mid + 1; // Search right half
+    if (order < 0)
+      lo = mid + 1; // Search right half
     else
-      end = mid; // Search left half
+      hi = mid; // Search left half
   }
 
   return -1; // Element not found
@@ -7,21 +7,36 @@
  * Binary Search
  *
  * Params:
- *     array - pointer to the first element of a sorted array
- *     len   - number of elements in the array
- *     num   - value to search for
+ *     begin     - pointer to the first element of a sorted array
+ *     len       - number of elements in the array
+ *     elem_size - size of each element in bytes
+ *     element   - value to search for
+ *     comp      - comparison function, qsort convention: <0 if a < b,
+ *                 0 if equal, >0 if a > b
  *
  * Returns:
  *     Index of the element if found (as ptrdiff_t), or -1 if not found
  *
  * Description:
- *     Implements an iterative binary search on a sorted array of integers.
- *     The array must be sorted in ascending order.
+ *     Implements an iterative binary search on a sorted array.
+ *     The array must be sorted in ascending order according to comp.
  */
 
 typedef int (*compfunc)(const void *a, const void *b);
 
-ptrdiff_t binary_search(void *begin, size_t len, size_t elemt_size,
+ptrdiff_t binary_search(void *begin, size_t len, size_t elem_size,
                         const void *element, compfunc comp);
 
+/*
+ * Typed int versions, dispatched at runtime to a scalar, AVX2 or AVX-512
+ * kernel (see common/cpu_dispatch.h). binary_search takes this path by
+ * itself when called with compare_int (common/compare.h).
+ *
+ * lower_bound_int returns the index of the first element >= key (len if
+ * none); binary_search_int returns the index of the first element equal to
+ * key, or -1.
+ */
+size_t lower_bound_int(const int *arr, size_t len, int key);
+ptrdiff_t binary_search_int(const int *arr, size_t len, int key);
+
 #endif // BINARY_SEARCH_H
@@ -8,7 +8,8 @@
  */
 
 int comp_int(const void *a, const void *b) {
-  return *(int *)a < *(int *)b ? 1 : *(int *)a > *(int *)b ? -1 : 0;
+  int x = *(const int *)a, y = *(const int *)b;
+  return (x > y) - (x < y);
 }
 int main() {
   // Example sorted array
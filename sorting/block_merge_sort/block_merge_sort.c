@@ -0,0 +1,241 @@
+#include "block_merge_sort.h"
+#include "../sort_stats.h"
+#include <string.h>
+
+typedef struct {
+  char *base;
+  size_t size;
+  int (*cmp)(const void *, const void *);
+  char *buf;
+  size_t cap; // buffer capacity in elements
+} Sorter;
+
+static inline char *at(const Sorter *s, size_t i) {
+  return s->base + i * s->size;
+}
+
+static inline int compare(const Sorter *s, const void *a, const void *b) {
+  return SORT_COMPARED(s->cmp(a, b));
+}
+
+// Exchanges two non-overlapping byte ranges through a small stack chunk.
+static void swap_bytes(char *a, char *b, size_t bytes) {
+  unsigned char tmp[64];
+  sort_stat_move(2 * bytes);
+  while (bytes > 0) {
+    size_t n = bytes < sizeof tmp ? bytes : sizeof tmp;
+    memcpy(tmp, a, n);
+    memcpy(a, b, n);
+    memcpy(b, tmp, n);
+    a += n;
+    b += n;
+    bytes -= n;
+  }
+}
+
+/*
+ * Rotation: [first, middle) and [middle, last) trade places. With room in
+ * the buffer for the shorter side, that side is parked there while the
+ * other slides over. Otherwise Gries-Mills block swaps: swapping the
+ * shorter side with the far end of the longer one puts it in its final
+ * place, and what is left is a smaller rotation.
+ */
+static void rotate(const Sorter *s, size_t first, size_t middle, size_t last) {
+  size_t left = middle - first, right = last - middle;
+  if (left == 0 || right == 0)
+    return;
+  size_t sz = s->size;
+
+  if (left <= right && left <= s->cap) {
+    memcpy(s->buf, at(s, first), left * sz);
+    memmove(at(s, first), at(s, middle), right * sz);
+    memcpy(at(s, first + right), s->buf, left * sz);
+    sort_stat_move((left + right) * sz);
+    return;
+  }
+  if (right < left && right <= s->cap) {
+    memcpy(s->buf, at(s, middle), right * sz);
+    memmove(at(s, first + right), at(s, first), left * sz);
+    memcpy(at(s, first), s->buf, right * sz);
+    sort_stat_move((left + right) * sz);
+    return;
+  }
+
+  while (left > 0 && right > 0) {
+    if (left <= right) {
+      swap_bytes(at(s, first), at(s, last - left), left * sz);
+      last -= left;
+      right -= left;
+    } else {
+      swap_bytes(at(s, first), at(s, middle), right * sz);
+      first += right;
+      left -= right;
+    }
+    middle = first + left;
+  }
+}
+
+// First index in [lo, hi) whose element is not less than key.
+static size_t lower_bound(const Sorter *s, size_t lo, size_t hi,
+                          const void *key) {
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (compare(s, at(s, mid), key) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// First index in [lo, hi) whose element is greater than key.
+static size_t upper_bound(const Sorter *s, size_t lo, size_t hi,
+                          const void *key) {
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (compare(s, key, at(s, mid)) < 0)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
+
+/*
+ * Buffered merges. Ties always go to the left run, which is what makes the
+ * sort stable.
+ */
+
+// Left run parked in the buffer, merged forward into [first, last).
+static void merge_forward(const Sorter *s, size_t first, size_t middle,
+                          size_t last) {
+  size_t sz = s->size, left = middle - first;
+  memcpy(s->buf, at(s, first), left * sz);
+  sort_stat_move((last - first + left) * sz);
+
+  char *a = s->buf, *a_end = s->buf + left * sz;
+  char *b = at(s, middle), *b_end = at(s, last);
+  char *out = at(s, first);
+  while (a < a_end && b < b_end) {
+    if (compare(s, b, a) < 0) {
+      memcpy(out, b, sz);
+      b += sz;
+    } else {
+      memcpy(out, a, sz);
+      a += sz;
+    }
+    out += sz;
+  }
+  memcpy(out, a, (size_t)(a_end - a)); // rest of b is already in place
+}
+
+// Right run parked in the buffer, merged backward into [first, last).
+static void merge_backward(const Sorter *s, size_t first, size_t middle,
+                           size_t last) {
+  size_t sz = s->size, right = last - middle;
+  memcpy(s->buf, at(s, middle), right * sz);
+  sort_stat_move((last - first + right) * sz);
+
+  char *a = at(s, middle), *a_begin = at(s, first); // a: one past the end
+  char *b = s->buf + right * sz, *b_begin = s->buf;
+  char *out = at(s, last);
+  while (a > a_begin && b > b_begin) {
+    out -= sz;
+    if (compare(s, b - sz, a - sz) < 0) {
+      a -= sz;
+      memcpy(out, a, sz);
+    } else {
+      b -= sz;
+      memcpy(out, b, sz);
+    }
+  }
+  memcpy(a_begin, b_begin, (size_t)(b - b_begin)); // rest of a is in place
+}
+
+static void merge(const Sorter *s, size_t first, size_t middle, size_t last) {
+  sort_stat_enter();
+  while (first < middle && middle < last &&
+         compare(s, at(s, middle - 1), at(s, middle)) > 0) {
+    size_t left = middle - first, right = last - middle;
+    if (left <= right && left <= s->cap) {
+      merge_forward(s, first, middle, last);
+      break;
+    }
+    if (right <= s->cap) {
+      merge_backward(s, first, middle, last);
+      break;
+    }
+
+    // Split both runs so that everything in the two left pieces belongs
+    // before everything in the two right pieces, swap the middle pieces,
+    // and merge each side. Recurse into the smaller side, loop on the
+    // larger.
+    size_t cut1, cut2;
+    if (left >= right) {
+      cut1 = first + left / 2;
+      cut2 = lower_bound(s, middle, last, at(s, cut1));
+    } else {
+      cut2 = middle + right / 2;
+      cut1 = upper_bound(s, first, middle, at(s, cut2));
+    }
+    rotate(s, cut1, middle, cut2);
+    size_t split = cut1 + (cut2 - middle);
+    if (split - first < last - split) {
+      merge(s, first, cut1, split);
+      first = split;
+      middle = cut2;
+    } else {
+      merge(s, split, cut2, last);
+      last = split;
+      middle = cut1;
+    }
+  }
+  sort_stat_leave();
+}
+
+// Binary insertion sort of [first, last): stable (upper_bound), and the
+// shift is a one-element rotation, so it needs no temporary of its own.
+static void insertion_run(const Sorter *s, size_t first, size_t last) {
+  for (size_t i = first + 1; i < last; ++i) {
+    if (compare(s, at(s, i - 1), at(s, i)) <= 0)
+      continue;
+    size_t pos = upper_bound(s, first, i - 1, at(s, i));
+    rotate(s, pos, i, i + 1);
+  }
+}
+
+static void sort(Sorter *s, size_t len) {
+  for (size_t i = 0; i < len; i += BLOCK_MERGE_RUN) {
+    size_t end = len - i < BLOCK_MERGE_RUN ? len : i + BLOCK_MERGE_RUN;
+    insertion_run(s, i, end);
+  }
+
+  for (size_t width = BLOCK_MERGE_RUN; width < len; width *= 2) {
+    for (size_t first = 0; first + width < len; first += 2 * width) {
+      size_t last = len - first - width < width ? len : first + 2 * width;
+      merge(s, first, first + width, last);
+    }
+  }
+}
+
+void block_merge_sort_buffered(void *base, size_t len, size_t size,
+                               int (*cmp)(const void *, const void *),
+                               void *buf, size_t buf_bytes) {
+  if (base == NULL || cmp == NULL || size == 0 || len < 2)
+    return;
+  unsigned char cache[BLOCK_MERGE_CACHE];
+  Sorter s = {.base = base, .size = size, .cmp = cmp};
+  if (buf != NULL && buf_bytes > sizeof cache) {
+    s.buf = buf;
+    s.cap = buf_bytes / size;
+  } else {
+    s.buf = (char *)cache;
+    s.cap = sizeof cache / size;
+  }
+  sort(&s, len);
+}
+
+void block_merge_sort(void *base, size_t len, size_t size,
+                      int (*cmp)(const void *, const void *)) {
+  block_merge_sort_buffered(base, len, size, cmp, NULL, 0);
+}
@@ -0,0 +1,46 @@
+#ifndef BLOCK_MERGE_SORT_H
+#define BLOCK_MERGE_SORT_H
+
+#include <stddef.h> // for size_t
+
+/**
+ * @brief Stable merge sort in O(1) extra memory, faster with a small buffer.
+ *
+ * Sorts runs of BLOCK_MERGE_RUN elements with binary insertion, then merges
+ * them bottom-up. Each merge uses the best method its working space allows:
+ *   - the smaller run fits in the buffer: an ordinary buffered merge;
+ *   - otherwise: cut the larger run in half, binary search the matching
+ *     cut in the other, rotate the two middle pieces past each other, and
+ *     merge the two halves the same way. Rotations go through the buffer
+ *     when the smaller piece fits, and are done by block swaps otherwise.
+ * Runs that are already in order are not touched, so sorted input costs
+ * one comparison per run.
+ *
+ * The working space is a BLOCK_MERGE_CACHE-byte array on the stack, or the
+ * caller's buffer when that is larger. With no buffer the sort does
+ * O(n log n) comparisons and O(n log^2 n) element moves. A buffer of
+ * sqrt(n) elements (under 1% of the array for n >= 10^4) lets every merge
+ * below that size run buffered and keeps the rotation levels few.
+ *
+ * @param base Pointer to the first element of the array.
+ * @param len Number of elements in the array.
+ * @param size Size of each element in bytes.
+ * @param cmp Comparison function to determine the order.
+ */
+void block_merge_sort(void *base, size_t len, size_t size,
+                      int (*cmp)(const void *, const void *));
+
+/**
+ * @brief block_merge_sort with a caller-provided scratch buffer.
+ *
+ * @param buf Scratch memory (any alignment), or NULL.
+ * @param buf_bytes Size of buf in bytes; only whole elements are used.
+ */
+void block_merge_sort_buffered(void *base, size_t len, size_t size,
+                               int (*cmp)(const void *, const void *),
+                               void *buf, size_t buf_bytes);
+
+#define BLOCK_MERGE_RUN 16
+#define BLOCK_MERGE_CACHE 1024
+
+#endif // BLOCK_MERGE_SORT_H
@@ -0,0 +1,92 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include "block_merge_sort.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Sorts N records on a key with few distinct values, so stability is
+ * visible: records with equal keys must keep their input order (seq).
+ * Each run uses a different amount of scratch memory, from half the array
+ * (every merge buffered: ordinary merge sort) down to none beyond the
+ * built-in stack cache, and is timed against the fully buffered run.
+ *
+ * Build: gcc -O2 example.c block_merge_sort.c -lm
+ */
+
+#define N (1 << 20)
+
+typedef struct {
+  int key;
+  int seq;
+} Record;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int cmp_records(const void *a, const void *b) {
+  const Record *x = a, *y = b;
+  return (x->key > y->key) - (x->key < y->key);
+}
+
+static int stable_sorted(const Record *r, size_t n) {
+  for (size_t i = 1; i < n; ++i)
+    if (r[i - 1].key > r[i].key ||
+        (r[i - 1].key == r[i].key && r[i - 1].seq > r[i].seq))
+      return 0;
+  return 1;
+}
+
+int main() {
+  Record *input = malloc(N * sizeof *input);
+  Record *work = malloc(N * sizeof *work);
+  Record *buf = malloc(N / 2 * sizeof *buf);
+  if (!input || !work || !buf)
+    return 1;
+
+  uint64_t s = 88172645463325252ull;
+  for (size_t i = 0; i < N; ++i) {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    input[i] = (Record){(int)(s % 1000), (int)i};
+  }
+
+  struct {
+    const char *name;
+    size_t elems;
+  } runs[] = {
+      {"n/2 (buffered)", N / 2},
+      {"1% of n", N / 100},
+      {"sqrt(n)", (size_t)sqrt((double)N)},
+      {"none", 0},
+  };
+
+  double base = 0;
+  printf("%-16s %12s %10s %8s %s\n", "buffer", "bytes", "seconds", "ratio",
+         "stable");
+  for (size_t r = 0; r < sizeof runs / sizeof runs[0]; ++r) {
+    memcpy(work, input, N * sizeof *work);
+    size_t bytes = runs[r].elems * sizeof *buf;
+    double t = now();
+    block_merge_sort_buffered(work, N, sizeof *work, cmp_records,
+                              bytes ? buf : NULL, bytes);
+    t = now() - t;
+    if (r == 0)
+      base = t;
+    printf("%-16s %12zu %10.3f %7.2fx %s\n", runs[r].name,
+           bytes ? bytes : (size_t)BLOCK_MERGE_CACHE, t, t / base,
+           stable_sorted(work, N) ? "yes" : "NO");
+  }
+
+  free(buf);
+  free(work);
+  free(input);
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include "bubble_sort.h"
+#include "../sort_stats.h"
 #include <string.h> // for memcpy
 
 // Generic swap implementation
@@ -7,6 +8,7 @@ void swap(void *a, void *b, size_t size) {
   memcpy(tmp, a, size);    // copy first element to temp
   memcpy(a, b, size);      // copy second element to first
   memcpy(b, tmp, size);    // copy temp to second element
+  sort_stat_swap(size);
 }
 
 // Generic bubble sort implementation
@@ -20,7 +22,7 @@ void bubble_sort(void *arr, size_t len, size_t size,
       void *elem2 = base + (j + 1) * size;
 
       // Use comparison function to decide if swap is needed
-      if (cmp(elem1, elem2) > 0) {
+      if (SORT_COMPARED(cmp(elem1, elem2) > 0)) {
         swap(elem1, elem2, size);
       }
     }
@@ -0,0 +1,267 @@
+#include "columnar_sort.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define PREFETCH_AHEAD 16 // rows of lookahead in gather_columns
+
+/*
+ * Order-preserving keys: the unsigned value of key(row) compares like the
+ * column value (descending keys are complemented). Returns the key width in
+ * bytes, which bounds the radix passes.
+ */
+static size_t key_width(ColumnType type) {
+  return type == COL_INT32 || type == COL_UINT32 || type == COL_FLOAT ? 4 : 8;
+}
+
+static void gather_keys(const SortKey *key, const uint32_t *rows, size_t n,
+                        uint64_t *out) {
+  switch (key->type) {
+  case COL_INT32: {
+    const int32_t *col = key->data;
+    for (size_t i = 0; i < n; ++i)
+      out[i] = (uint32_t)col[rows[i]] ^ 0x80000000u;
+    break;
+  }
+  case COL_UINT32: {
+    const uint32_t *col = key->data;
+    for (size_t i = 0; i < n; ++i)
+      out[i] = col[rows[i]];
+    break;
+  }
+  case COL_INT64: {
+    const int64_t *col = key->data;
+    for (size_t i = 0; i < n; ++i)
+      out[i] = (uint64_t)col[rows[i]] ^ (1ull << 63);
+    break;
+  }
+  case COL_UINT64: {
+    const uint64_t *col = key->data;
+    for (size_t i = 0; i < n; ++i)
+      out[i] = col[rows[i]];
+    break;
+  }
+  case COL_FLOAT: {
+    // negative: flip every bit (larger magnitude sorts first);
+    // positive: set the sign bit (sorts after every negative)
+    const float *col = key->data;
+    for (size_t i = 0; i < n; ++i) {
+      uint32_t bits;
+      memcpy(&bits, &col[rows[i]], sizeof bits);
+      out[i] = bits >> 31 ? ~bits : bits | 0x80000000u;
+    }
+    break;
+  }
+  case COL_DOUBLE: {
+    const double *col = key->data;
+    for (size_t i = 0; i < n; ++i) {
+      uint64_t bits;
+      memcpy(&bits, &col[rows[i]], sizeof bits);
+      out[i] = bits >> 63 ? ~bits : bits | (1ull << 63);
+    }
+    break;
+  }
+  }
+  if (key->descending) {
+    uint64_t mask = key_width(key->type) == 4 ? 0xFFFFFFFFull : ~0ull;
+    for (size_t i = 0; i < n; ++i)
+      out[i] ^= mask;
+  }
+}
+
+/*
+ * Sorting one range of (key, row) pairs. Both variants are stable, which
+ * is what keeps rows tied on every key in their original order.
+ */
+
+static void insertion_sort_pairs(uint64_t *k, uint32_t *p, size_t n) {
+  for (size_t i = 1; i < n; ++i) {
+    uint64_t key = k[i];
+    uint32_t row = p[i];
+    size_t j = i;
+    while (j > 0 && k[j - 1] > key) {
+      k[j] = k[j - 1];
+      p[j] = p[j - 1];
+      j--;
+    }
+    k[j] = key;
+    p[j] = row;
+  }
+}
+
+// LSD radix sort, 8 bits per pass. One read computes every pass's
+// histogram; passes where all keys share the byte are skipped.
+static void radix_sort_pairs(uint64_t *k, uint32_t *p, size_t n, size_t width,
+                             uint64_t *k_tmp, uint32_t *p_tmp) {
+  size_t counts[8][256];
+  memset(counts, 0, sizeof counts);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t b = 0; b < width; ++b)
+      counts[b][(k[i] >> (8 * b)) & 0xFF]++;
+
+  uint64_t *k_src = k, *k_dst = k_tmp;
+  uint32_t *p_src = p, *p_dst = p_tmp;
+  for (size_t b = 0; b < width; ++b) {
+    size_t *count = counts[b];
+    if (count[(k_src[0] >> (8 * b)) & 0xFF] == n)
+      continue; // every key has this byte: the pass would not move anything
+
+    size_t sum = 0;
+    for (int d = 0; d < 256; ++d) {
+      size_t c = count[d];
+      count[d] = sum;
+      sum += c;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      size_t at = count[(k_src[i] >> (8 * b)) & 0xFF]++;
+      k_dst[at] = k_src[i];
+      p_dst[at] = p_src[i];
+    }
+    uint64_t *kt = k_src;
+    k_src = k_dst;
+    k_dst = kt;
+    uint32_t *pt = p_src;
+    p_src = p_dst;
+    p_dst = pt;
+  }
+  if (k_src != k) {
+    memcpy(k, k_src, n * sizeof *k);
+    memcpy(p, p_src, n * sizeof *p);
+  }
+}
+
+/*
+ * Refinement. `ties` lists the ranges of perm still tied on the keys so far
+ * (each at least two rows long). Sorting a range by the next key splits it
+ * into runs of equal keys; runs of two or more become the next key's ties.
+ */
+
+typedef struct {
+  uint32_t lo, hi;
+} Range;
+
+int argsort_columns(const SortKey *keys, size_t nkeys, size_t rows,
+                    uint32_t *perm) {
+  if (perm == NULL || (nkeys > 0 && keys == NULL) || rows > UINT32_MAX)
+    return -1;
+  for (size_t k = 0; k < nkeys; ++k)
+    if (keys[k].data == NULL && rows > 0)
+      return -1;
+  for (size_t i = 0; i < rows; ++i)
+    perm[i] = (uint32_t)i;
+  if (rows < 2 || nkeys == 0)
+    return 0;
+
+  uint64_t *k = malloc(rows * sizeof *k);
+  uint64_t *k_tmp = malloc(rows * sizeof *k_tmp);
+  uint32_t *p_tmp = malloc(rows * sizeof *p_tmp);
+  Range *ties = malloc((rows / 2 + 1) * sizeof *ties);
+  Range *next = malloc((rows / 2 + 1) * sizeof *next);
+  int status = -1;
+  if (k == NULL || k_tmp == NULL || p_tmp == NULL || ties == NULL ||
+      next == NULL)
+    goto out;
+
+  size_t nties = 1;
+  ties[0] = (Range){0, (uint32_t)rows};
+  for (size_t key = 0; key < nkeys && nties > 0; ++key) {
+    size_t width = key_width(keys[key].type);
+    int last = key + 1 == nkeys;
+    size_t nnext = 0;
+
+    for (size_t t = 0; t < nties; ++t) {
+      size_t lo = ties[t].lo, n = ties[t].hi - lo;
+      gather_keys(&keys[key], perm + lo, n, k + lo);
+      if (n < COLUMNAR_RADIX_MIN)
+        insertion_sort_pairs(k + lo, perm + lo, n);
+      else
+        radix_sort_pairs(k + lo, perm + lo, n, width, k_tmp, p_tmp);
+      if (last)
+        continue;
+
+      for (size_t i = lo; i < lo + n;) {
+        size_t j = i + 1;
+        while (j < lo + n && k[j] == k[i])
+          j++;
+        if (j - i > 1)
+          next[nnext++] = (Range){(uint32_t)i, (uint32_t)j};
+        i = j;
+      }
+    }
+    Range *swap = ties;
+    ties = next;
+    next = swap;
+    nties = nnext;
+  }
+  status = 0;
+
+out:
+  free(next);
+  free(ties);
+  free(p_tmp);
+  free(k_tmp);
+  free(k);
+  return status;
+}
+
+/*
+ * Applying the permutation
+ */
+
+static void gather_block(const Column *src, void *dst, const uint32_t *perm,
+                         size_t lo, size_t hi) {
+  const char *in = src->data;
+  char *out = dst;
+  size_t size = src->elem_size;
+
+  size_t ahead = hi - lo < PREFETCH_AHEAD ? hi - lo : PREFETCH_AHEAD;
+  for (size_t i = lo; i < lo + ahead; ++i)
+    __builtin_prefetch(in + (size_t)perm[i] * size);
+
+  // 4- and 8-byte columns get plain loads and stores instead of memcpy
+  // calls
+  for (size_t i = lo; i < hi; ++i) {
+    if (i + PREFETCH_AHEAD < hi)
+      __builtin_prefetch(in + (size_t)perm[i + PREFETCH_AHEAD] * size);
+    const char *from = in + (size_t)perm[i] * size;
+    if (size == 8)
+      memcpy(out + i * 8, from, 8);
+    else if (size == 4)
+      memcpy(out + i * 4, from, 4);
+    else
+      memcpy(out + i * size, from, size);
+  }
+}
+
+void gather_columns(const Column *src, void *const *dst, size_t ncols,
+                    size_t rows, const uint32_t *perm) {
+  if (src == NULL || dst == NULL || perm == NULL)
+    return;
+  for (size_t lo = 0; lo < rows; lo += COLUMNAR_GATHER_BLOCK) {
+    size_t hi =
+        rows - lo < COLUMNAR_GATHER_BLOCK ? rows : lo + COLUMNAR_GATHER_BLOCK;
+    for (size_t c = 0; c < ncols; ++c)
+      gather_block(&src[c], dst[c], perm, lo, hi);
+  }
+}
+
+int permute_columns(Column *cols, size_t ncols, size_t rows,
+                    const uint32_t *perm) {
+  if (cols == NULL || perm == NULL)
+    return -1;
+  size_t max_size = 0;
+  for (size_t c = 0; c < ncols; ++c)
+    if (cols[c].elem_size > max_size)
+      max_size = cols[c].elem_size;
+  if (rows == 0 || max_size == 0)
+    return 0;
+
+  void *scratch = malloc(rows * max_size);
+  if (scratch == NULL)
+    return -1;
+  for (size_t c = 0; c < ncols; ++c) {
+    gather_columns(&cols[c], &scratch, 1, rows, perm);
+    memcpy(cols[c].data, scratch, rows * cols[c].elem_size);
+  }
+  free(scratch);
+  return 0;
+}
@@ -0,0 +1,76 @@
+#ifndef COLUMNAR_SORT_H
+#define COLUMNAR_SORT_H
+
+#include <stddef.h> // For size_t
+#include <stdint.h>
+
+/*
+ * Multi-column sort for tables stored as parallel arrays (structure of
+ * arrays)
+ *
+ * argsort_columns computes the permutation that orders the rows
+ * lexicographically by the key columns. permute_columns / gather_columns
+ * then apply it to every column, key or not. No row structs are built.
+ *
+ * Description:
+ *     Every key value is first mapped to an unsigned integer with the same
+ *     order (sign bit flipped for signed ints, IEEE sign trick for
+ *     floating point, complemented for descending keys). The rows are
+ *     sorted by the first key with an LSD radix sort over (key, row)
+ *     pairs; byte positions where every key agrees are skipped. Each run of
+ *     rows tied on the keys so far is then sorted by the next key, and so
+ *     on; ranges shorter than COLUMNAR_RADIX_MIN use insertion sort
+ *     instead. Rows stop being refined once they are no longer tied, so
+ *     later keys cost only as much as the ties need.
+ *
+ *     The sort is stable: rows equal on every key keep their order.
+ *     Floating-point keys order by their bits: -0.0 sorts before +0.0,
+ *     and NaNs go above +inf with the sign bit clear, below -inf with it
+ *     set (mirrored for descending keys).
+ *
+ * Returns:
+ *     0 on success, -1 on failure (bad argument, more than UINT32_MAX rows,
+ *     out of memory).
+ */
+
+#define COLUMNAR_RADIX_MIN 64
+#define COLUMNAR_GATHER_BLOCK 1024 // rows per block in gather_columns
+
+typedef enum {
+  COL_INT32,
+  COL_UINT32,
+  COL_INT64,
+  COL_UINT64,
+  COL_FLOAT,
+  COL_DOUBLE
+} ColumnType;
+
+typedef struct {
+  const void *data; // rows values of `type`
+  ColumnType type;
+  int descending;
+} SortKey;
+
+typedef struct {
+  void *data;
+  size_t elem_size;
+} Column;
+
+// perm[i] = index of the row that goes to position i.
+int argsort_columns(const SortKey *keys, size_t nkeys, size_t rows,
+                    uint32_t *perm);
+
+/*
+ * dst[c][i] = src[c][perm[i]] for every column. dst must not overlap src.
+ * Works through COLUMNAR_GATHER_BLOCK output rows at a time, gathering that
+ * block for all columns before moving on: the block of perm stays in L1
+ * across columns, and source rows are prefetched a few rows ahead.
+ */
+void gather_columns(const Column *src, void *const *dst, size_t ncols,
+                    size_t rows, const uint32_t *perm);
+
+// In place through one scratch column (rows * largest elem_size bytes).
+int permute_columns(Column *cols, size_t ncols, size_t rows,
+                    const uint32_t *perm);
+
+#endif // COLUMNAR_SORT_H
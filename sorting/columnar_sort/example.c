@@ -0,0 +1,102 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include "columnar_sort.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Sorts a ROWS-row table kept as four parallel columns by
+ * (region ASC, score DESC, id ASC), carrying a non-key payload column
+ * along. The result is compared with the classic way: build an array of
+ * row structs and qsort it with a composite comparator.
+ *
+ * Build: gcc -O2 example.c columnar_sort.c
+ */
+
+#define ROWS (1 << 22)
+
+typedef struct {
+  int32_t region;
+  double score;
+  uint64_t id;
+  float payload;
+} Row;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int cmp_rows(const void *a, const void *b) {
+  const Row *x = a, *y = b;
+  if (x->region != y->region)
+    return x->region < y->region ? -1 : 1;
+  if (x->score != y->score)
+    return x->score > y->score ? -1 : 1; // descending
+  return (x->id > y->id) - (x->id < y->id);
+}
+
+int main() {
+  int32_t *region = malloc(ROWS * sizeof *region);
+  double *score = malloc(ROWS * sizeof *score);
+  uint64_t *id = malloc(ROWS * sizeof *id);
+  float *payload = malloc(ROWS * sizeof *payload);
+  uint32_t *perm = malloc(ROWS * sizeof *perm);
+  Row *rows = malloc(ROWS * sizeof *rows);
+  if (!region || !score || !id || !payload || !perm || !rows)
+    return 1;
+
+  // 16 regions, scores with many ties (1000 levels), ids in random order
+  uint64_t s = 88172645463325252ull;
+  for (size_t i = 0; i < ROWS; ++i) {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    region[i] = (int32_t)(s % 16) - 8;
+    score[i] = (double)((s >> 8) % 1000) / 10.0;
+    id[i] = s >> 20;
+    payload[i] = (float)i;
+    rows[i] = (Row){region[i], score[i], id[i], payload[i]};
+  }
+
+  double t0 = now();
+  SortKey keys[] = {{region, COL_INT32, 0},
+                    {score, COL_DOUBLE, 1},
+                    {id, COL_UINT64, 0}};
+  if (argsort_columns(keys, 3, ROWS, perm) != 0)
+    return 1;
+  double t1 = now();
+  Column cols[] = {{region, sizeof *region},
+                   {score, sizeof *score},
+                   {id, sizeof *id},
+                   {payload, sizeof *payload}};
+  if (permute_columns(cols, 4, ROWS, perm) != 0)
+    return 1;
+  double t2 = now();
+
+  qsort(rows, ROWS, sizeof *rows, cmp_rows);
+  double t3 = now();
+
+  size_t mismatches = 0;
+  for (size_t i = 0; i < ROWS; ++i)
+    mismatches += rows[i].region != region[i] || rows[i].score != score[i] ||
+                  rows[i].id != id[i];
+
+  printf("%d rows by (region ASC, score DESC, id ASC):\n", ROWS);
+  printf("  argsort_columns   %.3f s\n", t1 - t0);
+  printf("  permute_columns   %.3f s (4 columns)\n", t2 - t1);
+  printf("  row structs qsort %.3f s\n", t3 - t2);
+  printf("  first row: region %d, score %.1f, id %llu, payload row %.0f\n",
+         region[0], score[0], (unsigned long long)id[0], payload[0]);
+  printf("  %zu mismatches against qsort\n", mismatches);
+
+  free(rows);
+  free(perm);
+  free(payload);
+  free(id);
+  free(score);
+  free(region);
+  return mismatches != 0;
+}
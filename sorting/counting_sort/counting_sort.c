@@ -0,0 +1,306 @@
+#include "counting_sort.h"
+#include "../../common/parallel.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * Parallel driver: phases run through parallel_run (common/parallel.h), as
+ * in sample_sort. Worker t always owns input chunk t, and per-thread
+ * results live in its Worker.
+ */
+
+typedef struct {
+  // int arrays
+  int *arr;
+  int min;
+  // records
+  char *base, *tmp;
+  size_t size;
+  size_t (*key)(const void *);
+  uint32_t *keys; // key(record i), cached by the first pass
+
+  size_t len, range;
+  unsigned threads;
+  size_t *hist;  // [thread][range]: count, then write position
+  size_t *start; // int arrays: range + 1 run starts
+} CountingSort;
+
+typedef struct {
+  ParallelTask task;
+  CountingSort *s;
+  int lo, hi;     // key bounds seen in the chunk
+  size_t max_key; // records: largest key seen in the chunk
+  int bad;        // a key outside the range
+} Worker;
+
+static void chunk_of(const Worker *w, size_t *begin, size_t *end) {
+  parallel_chunk(w->s->len, w->s->threads, w->task.id, begin, end);
+}
+
+// A thread per COUNTING_SORT_GRAIN elements at most, and per `range`
+// elements, so merging the histograms never outweighs filling them.
+static unsigned pick_threads(unsigned threads, size_t len, size_t range) {
+  if (threads == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = online > 0 ? (unsigned)online : 1;
+  }
+  size_t grain = range > COUNTING_SORT_GRAIN ? range : COUNTING_SORT_GRAIN;
+  size_t most = len / grain;
+  if (most < threads)
+    threads = most > 0 ? (unsigned)most : 1;
+  return threads;
+}
+
+/*
+ * int arrays
+ */
+
+static void *find_range(void *arg) {
+  Worker *w = arg;
+  size_t begin, end;
+  chunk_of(w, &begin, &end);
+  const int *arr = w->s->arr;
+  int lo = arr[begin], hi = arr[begin];
+  for (size_t i = begin + 1; i < end; ++i) {
+    lo = arr[i] < lo ? arr[i] : lo;
+    hi = arr[i] > hi ? arr[i] : hi;
+  }
+  w->lo = lo;
+  w->hi = hi;
+  return NULL;
+}
+
+static void *count_ints(void *arg) {
+  Worker *w = arg;
+  CountingSort *s = w->s;
+  size_t begin, end;
+  chunk_of(w, &begin, &end);
+  size_t *hist = s->hist + (size_t)w->task.id * s->range;
+  // Unsigned offsets: a key below min wraps around and fails the same
+  // test as one above max.
+  unsigned min = (unsigned)s->min;
+  size_t range = s->range, bad = 0;
+  for (size_t i = begin; i < end; ++i) {
+    size_t k = (unsigned)s->arr[i] - min;
+    bad |= k >= range;
+    hist[k < range ? k : 0]++;
+  }
+  w->bad = bad != 0;
+  return NULL;
+}
+
+// Worker t writes output positions [begin, end), starting from the run
+// that covers `begin`.
+static void *fill_ints(void *arg) {
+  Worker *w = arg;
+  CountingSort *s = w->s;
+  size_t begin, end;
+  chunk_of(w, &begin, &end);
+  if (begin == end)
+    return NULL;
+
+  size_t lo = 0, hi = s->range; // last k with start[k] <= begin
+  while (hi - lo > 1) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (s->start[mid] <= begin)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  for (size_t k = lo, i = begin; i < end; ++k) {
+    size_t stop = s->start[k + 1] < end ? s->start[k + 1] : end;
+    int x = (int)((unsigned)s->min + (unsigned)k);
+    for (; i < stop; ++i)
+      s->arr[i] = x;
+  }
+  return NULL;
+}
+
+static int sort_ints(int arr[], size_t len, int min, int max, int find,
+                     unsigned threads) {
+  if (len < 2)
+    return 0;
+
+  CountingSort s = {.arr = arr, .len = len};
+  s.threads = pick_threads(threads, len, 0);
+  Worker *workers = malloc(s.threads * sizeof *workers);
+  int status = -1;
+  if (workers == NULL)
+    goto out;
+  for (unsigned t = 0; t < s.threads; ++t)
+    workers[t] = (Worker){.s = &s};
+
+  if (find) {
+    parallel_run(workers, sizeof *workers, s.threads, find_range);
+    min = workers[0].lo;
+    max = workers[0].hi;
+    for (unsigned t = 1; t < s.threads; ++t) {
+      min = workers[t].lo < min ? workers[t].lo : min;
+      max = workers[t].hi > max ? workers[t].hi : max;
+    }
+  }
+  if (min > max || (long long)max - min >= COUNTING_SORT_MAX_RANGE)
+    goto out;
+  s.min = min;
+  s.range = (size_t)((long long)max - min + 1);
+
+  // fewer threads for a wide range; chunks follow s.threads
+  s.threads = pick_threads(s.threads, len, s.range);
+  s.hist = calloc((size_t)s.threads * s.range, sizeof *s.hist);
+  s.start = malloc((s.range + 1) * sizeof *s.start);
+  if (s.hist == NULL || s.start == NULL)
+    goto out;
+
+  parallel_run(workers, sizeof *workers, s.threads, count_ints);
+  for (unsigned t = 0; t < s.threads; ++t)
+    if (workers[t].bad)
+      goto out;
+
+  size_t pos = 0;
+  for (size_t k = 0; k < s.range; ++k) {
+    s.start[k] = pos;
+    for (unsigned t = 0; t < s.threads; ++t)
+      pos += s.hist[(size_t)t * s.range + k];
+  }
+  s.start[s.range] = pos;
+  parallel_run(workers, sizeof *workers, s.threads, fill_ints);
+  status = 0;
+
+out:
+  free(s.start);
+  free(s.hist);
+  free(workers);
+  return status;
+}
+
+int counting_sort(int arr[], size_t len, unsigned threads) {
+  return sort_ints(arr, len, 0, 0, 1, threads);
+}
+
+int counting_sort_range(int arr[], size_t len, int min, int max,
+                        unsigned threads) {
+  return sort_ints(arr, len, min, max, 0, threads);
+}
+
+/*
+ * Records
+ */
+
+static void *extract_keys(void *arg) {
+  Worker *w = arg;
+  CountingSort *s = w->s;
+  size_t begin, end;
+  chunk_of(w, &begin, &end);
+  size_t max_key = 0;
+  for (size_t i = begin; i < end; ++i) {
+    size_t k = s->key(s->base + i * s->size);
+    max_key = k > max_key ? k : max_key;
+    s->keys[i] = (uint32_t)k; // only used once max_key is known to fit
+  }
+  w->max_key = max_key;
+  return NULL;
+}
+
+static void *count_keys(void *arg) {
+  Worker *w = arg;
+  CountingSort *s = w->s;
+  size_t begin, end;
+  chunk_of(w, &begin, &end);
+  size_t *hist = s->hist + (size_t)w->task.id * s->range;
+  for (size_t i = begin; i < end; ++i)
+    hist[s->keys[i]]++;
+  return NULL;
+}
+
+static void *scatter_records(void *arg) {
+  Worker *w = arg;
+  CountingSort *s = w->s;
+  size_t begin, end;
+  chunk_of(w, &begin, &end);
+  size_t *pos = s->hist + (size_t)w->task.id * s->range;
+  size_t size = s->size;
+
+  // Common record sizes get fixed-size copies instead of memcpy calls.
+  for (size_t i = begin; i < end; ++i) {
+    char *to = s->tmp + pos[s->keys[i]]++ * size;
+    const char *from = s->base + i * size;
+    if (size == 4)
+      memcpy(to, from, 4);
+    else if (size == 8)
+      memcpy(to, from, 8);
+    else if (size == 16)
+      memcpy(to, from, 16);
+    else
+      memcpy(to, from, size);
+  }
+  return NULL;
+}
+
+static void *copy_back(void *arg) {
+  Worker *w = arg;
+  CountingSort *s = w->s;
+  size_t begin, end;
+  chunk_of(w, &begin, &end);
+  memcpy(s->base + begin * s->size, s->tmp + begin * s->size,
+         (end - begin) * s->size);
+  return NULL;
+}
+
+int counting_sort_by_key(void *base, size_t len, size_t size,
+                         size_t (*key)(const void *record), size_t range,
+                         unsigned threads) {
+  if (base == NULL || key == NULL || size == 0 ||
+      range > COUNTING_SORT_MAX_RANGE)
+    return -1;
+  if (len < 2)
+    return 0;
+
+  CountingSort s = {.base = base, .size = size, .key = key, .len = len};
+  s.threads = pick_threads(threads, len, range);
+  Worker *workers = malloc(s.threads * sizeof *workers);
+  s.keys = malloc(len * sizeof *s.keys);
+  int status = -1;
+  if (workers == NULL || s.keys == NULL)
+    goto out;
+  for (unsigned t = 0; t < s.threads; ++t)
+    workers[t] = (Worker){.s = &s};
+
+  parallel_run(workers, sizeof *workers, s.threads, extract_keys);
+  size_t max_key = 0;
+  for (unsigned t = 0; t < s.threads; ++t)
+    max_key = workers[t].max_key > max_key ? workers[t].max_key : max_key;
+  if (max_key >= COUNTING_SORT_MAX_RANGE || (range > 0 && max_key >= range))
+    goto out;
+  s.range = range > 0 ? range : max_key + 1;
+  s.threads = pick_threads(s.threads, len, s.range); // keys are cached
+
+  s.hist = calloc((size_t)s.threads * s.range, sizeof *s.hist);
+  s.tmp = malloc(len * size);
+  if (s.hist == NULL || s.tmp == NULL)
+    goto out;
+  parallel_run(workers, sizeof *workers, s.threads, count_keys);
+
+  // Key-major, thread-minor offsets: thread t's records of key k follow
+  // those of threads 0..t-1, which is what keeps the sort stable.
+  size_t pos = 0;
+  for (size_t k = 0; k < s.range; ++k)
+    for (unsigned t = 0; t < s.threads; ++t) {
+      size_t *h = &s.hist[(size_t)t * s.range + k];
+      size_t count = *h;
+      *h = pos;
+      pos += count;
+    }
+
+  parallel_run(workers, sizeof *workers, s.threads, scatter_records);
+  parallel_run(workers, sizeof *workers, s.threads, copy_back);
+  status = 0;
+
+out:
+  free(s.tmp);
+  free(s.hist);
+  free(s.keys);
+  free(workers);
+  return status;
+}
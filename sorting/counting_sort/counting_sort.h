@@ -0,0 +1,80 @@
+#ifndef COUNTING_SORT_H
+#define COUNTING_SORT_H
+
+#include <stddef.h> // For size_t
+
+/*
+ * Counting Sort (int arrays)
+ *
+ * Params:
+ *     arr     - pointer to the array
+ *     len     - number of elements
+ *     threads - worker threads; 0 uses every online CPU
+ *
+ * Returns:
+ *     0 on success, -1 if max - min + 1 exceeds COUNTING_SORT_MAX_RANGE or
+ *     a buffer could not be allocated (arr is then left untouched, and the
+ *     caller should fall back to a comparison sort).
+ *
+ * Description:
+ *     One pass finds the key range, one pass counts every key into a
+ *     per-thread histogram, and the merged counts are written back as runs
+ *     of equal keys. O(n + range) time, O(threads * range) extra space.
+ */
+int counting_sort(int arr[], size_t len, unsigned threads);
+
+/*
+ * Counting Sort over a known key range
+ *
+ * Params:
+ *     arr      - pointer to the array
+ *     len      - number of elements
+ *     min, max - inclusive bounds every key must lie in
+ *     threads  - worker threads; 0 uses every online CPU
+ *
+ * Returns:
+ *     0 on success, -1 if the range is too large, a key lies outside
+ *     [min, max], or a buffer could not be allocated (arr is then left
+ *     untouched).
+ *
+ * Description:
+ *     counting_sort without the range-finding pass.
+ */
+int counting_sort_range(int arr[], size_t len, int min, int max,
+                        unsigned threads);
+
+/*
+ * Stable Counting Sort of records by an extracted key
+ *
+ * Params:
+ *     base    - pointer to the first record
+ *     len     - number of records
+ *     size    - size of each record in bytes
+ *     key     - returns the record's key, in [0, range)
+ *     range   - number of possible keys; 0 detects it as max key + 1
+ *     threads - worker threads; 0 uses every online CPU
+ *
+ * Returns:
+ *     0 on success, -1 if the range is too large, a key is not below a
+ *     given range, or a buffer could not be allocated (base is then left
+ *     untouched).
+ *
+ * Description:
+ *     Sorts whole records, so everything besides the key travels with it.
+ *       1. each thread calls key() once per record of its chunk, caching
+ *          the keys, and counts them into its own histogram;
+ *       2. a prefix sum over (key, thread) gives every thread its own
+ *          output range per key, in input order;
+ *       3. each thread scatters its records into a buffer, which is then
+ *          copied back.
+ *     Records with equal keys keep their input order. O(n + range) time,
+ *     O(n * size + threads * range) extra space.
+ */
+int counting_sort_by_key(void *base, size_t len, size_t size,
+                         size_t (*key)(const void *record), size_t range,
+                         unsigned threads);
+
+#define COUNTING_SORT_MAX_RANGE (1 << 20)
+#define COUNTING_SORT_GRAIN (1 << 16) // fewest elements worth a thread
+
+#endif // COUNTING_SORT_H
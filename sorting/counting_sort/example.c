@@ -0,0 +1,97 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include "counting_sort.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Two small-domain workloads, each against qsort:
+ *   - N day-of-year ints (0..365), range detected by counting_sort;
+ *   - N event records keyed by a 16-bit code, sorted by key callback; the
+ *     sequence number they carry checks the order of equal codes.
+ *
+ * Build: gcc -O2 -pthread example.c counting_sort.c ../../common/parallel.c
+ */
+
+#define N (1 << 24)
+
+typedef struct {
+  uint16_t code;
+  uint32_t seq;
+  double value;
+} Event;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int cmp_int(const void *a, const void *b) {
+  int x = *(const int *)a, y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+
+// qsort is not stable, so the reference breaks ties on seq itself
+static int cmp_events(const void *a, const void *b) {
+  const Event *x = a, *y = b;
+  if (x->code != y->code)
+    return x->code < y->code ? -1 : 1;
+  return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+static size_t event_code(const void *record) {
+  return ((const Event *)record)->code;
+}
+
+int main() {
+  int *days = malloc(N * sizeof *days);
+  int *ref = malloc(N * sizeof *ref);
+  Event *events = malloc(N * sizeof *events);
+  Event *events_ref = malloc(N * sizeof *events_ref);
+  if (!days || !ref || !events || !events_ref)
+    return 1;
+
+  uint64_t s = 88172645463325252ull;
+  for (size_t i = 0; i < N; ++i) {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    days[i] = (int)(s % 366);
+    events[i] = (Event){(uint16_t)(s >> 32), (uint32_t)i, (double)i};
+  }
+  memcpy(ref, days, N * sizeof *days);
+  memcpy(events_ref, events, N * sizeof *events);
+
+  double t = now();
+  int status = counting_sort(days, N, 0);
+  double t_count = now() - t;
+  t = now();
+  qsort(ref, N, sizeof *ref, cmp_int);
+  double t_qsort = now() - t;
+  printf("day-of-year ints: counting_sort %.3f s, qsort %.3f s (%.1fx), %s\n",
+         t_count, t_qsort, t_qsort / t_count,
+         status == 0 && memcmp(days, ref, N * sizeof *days) == 0 ? "equal"
+                                                                  : "DIFFER");
+
+  t = now();
+  status = counting_sort_by_key(events, N, sizeof *events, event_code,
+                                UINT16_MAX + 1, 0);
+  t_count = now() - t;
+  t = now();
+  qsort(events_ref, N, sizeof *events_ref, cmp_events);
+  t_qsort = now() - t;
+  printf("16-bit code events: counting_sort %.3f s, qsort %.3f s (%.1fx), %s\n",
+         t_count, t_qsort, t_qsort / t_count,
+         status == 0 && memcmp(events, events_ref, N * sizeof *events) == 0
+             ? "stable"
+             : "NOT STABLE");
+
+  free(events_ref);
+  free(events);
+  free(ref);
+  free(days);
+  return 0;
+}
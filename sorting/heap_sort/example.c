@@ -0,0 +1,132 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include "heap_sort.h"
+#include "../../common/compare.h"
+#include "../../data-structures/heap/heap.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Binary vs 4-ary vs 8-ary heaps on N ints, three ways:
+ *   - heap sort, typed heaps (HEAP_DEFINE, inlined comparisons);
+ *   - heap sort, generic heap_sort_arity (comparator calls);
+ *   - priority queue "hold" workload: a heap of N/4 elements, then N
+ *     pushpops, each pushing the popped value plus a random increment,
+ *     the usual pattern of an event scheduler.
+ *
+ * Build: gcc -O2 example.c heap_sort.c ../../data-structures/heap/heap.c \
+ *        ../../data-structures/dynamic_array/dynamic_array.c \
+ *        ../../common/compare.c
+ */
+
+#define N (1 << 22)
+
+#define LESS_INT(a, b) ((a) < (b))
+#define GREATER_INT(a, b) ((a) > (b))
+
+HEAP_DEFINE(max2, int, 2, GREATER_INT)
+HEAP_DEFINE(max4, int, 4, GREATER_INT)
+HEAP_DEFINE(max8, int, 8, GREATER_INT)
+HEAP_DEFINE(min2, int, 2, LESS_INT)
+HEAP_DEFINE(min4, int, 4, LESS_INT)
+HEAP_DEFINE(min8, int, 8, LESS_INT)
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t xorshift(uint64_t *s) {
+  *s ^= *s << 13;
+  *s ^= *s >> 7;
+  *s ^= *s << 17;
+  return *s;
+}
+
+static int sorted(const int *a, size_t n) {
+  for (size_t i = 1; i < n; ++i)
+    if (a[i - 1] > a[i])
+      return 0;
+  return 1;
+}
+
+#define TYPED_SORT(name, a, n)                                                 \
+  do {                                                                         \
+    name##_make(a, n);                                                         \
+    for (size_t m = n; m > 1; --m)                                             \
+      name##_pop_array(a, m);                                                  \
+  } while (0)
+
+// Returns a checksum of the popped values so the work is not optimised out.
+#define TYPED_HOLD(name, heap, n, ops, seed)                                   \
+  do {                                                                         \
+    uint64_t s = seed;                                                         \
+    for (size_t i = 0; i < n; ++i)                                             \
+      name##_push(heap, (int)(xorshift(&s) % 1000000));                        \
+    for (size_t i = 0; i < ops; ++i) {                                         \
+      int top = *name##_top(heap), out;                                        \
+      name##_pushpop(heap, top + (int)(xorshift(&s) % 1000), &out);            \
+      sum += (uint64_t)out;                                                    \
+    }                                                                          \
+  } while (0)
+
+int main() {
+  int *input = malloc(N * sizeof *input);
+  int *work = malloc(N * sizeof *work);
+  if (!input || !work)
+    return 1;
+  uint64_t s = 88172645463325252ull;
+  for (size_t i = 0; i < N; ++i)
+    input[i] = (int)(xorshift(&s) >> 33);
+
+  printf("%-8s %14s %14s %14s\n", "arity", "typed sort", "generic sort",
+         "typed hold");
+  for (unsigned d = 2; d <= 8; d *= 2) {
+    memcpy(work, input, N * sizeof *work);
+    double t = now();
+    if (d == 2)
+      TYPED_SORT(max2, work, N);
+    else if (d == 4)
+      TYPED_SORT(max4, work, N);
+    else
+      TYPED_SORT(max8, work, N);
+    double typed = now() - t;
+    int ok = sorted(work, N);
+
+    memcpy(work, input, N * sizeof *work);
+    t = now();
+    heap_sort_arity(work, N, sizeof *work, compare_int, d);
+    double generic = now() - t;
+    ok &= sorted(work, N);
+
+    DynamicArray *heap = da_create(sizeof(int));
+    if (!heap || da_reserve(heap, N / 4) != DYN_OK)
+      return 1;
+    uint64_t sum = 0;
+    t = now();
+    if (d == 2)
+      TYPED_HOLD(min2, heap, N / 4, N, 42);
+    else if (d == 4)
+      TYPED_HOLD(min4, heap, N / 4, N, 42);
+    else
+      TYPED_HOLD(min8, heap, N / 4, N, 42);
+    double hold = now() - t;
+    da_destroy(heap);
+
+    printf("%-8u %12.3f s %12.3f s %12.3f s  %s (checksum %llu)\n", d, typed,
+           generic, hold, ok ? "sorted" : "NOT SORTED",
+           (unsigned long long)sum);
+  }
+
+  memcpy(work, input, N * sizeof *work);
+  double t = now();
+  qsort(work, N, sizeof *work, compare_int);
+  printf("qsort    %12.3f s\n", now() - t);
+
+  free(work);
+  free(input);
+  return 0;
+}
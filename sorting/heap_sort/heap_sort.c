@@ -0,0 +1,54 @@
+#include "heap_sort.h"
+#include "../../common/compare.h"
+#include "../../data-structures/heap/heap.h"
+#include "../sort_stats.h"
+#include <stdlib.h>
+#include <string.h>
+
+// a ranks first in a max-heap: ascending order comes out of the tail
+#define GREATER_INT(a, b) SORT_COMPARED((a) > (b))
+
+HEAP_DEFINE(max_int4, int, 4, GREATER_INT)
+
+void heap_sort_int(int *arr, size_t len) {
+  if (len < 2)
+    return;
+  max_int4_make(arr, len);
+  for (size_t n = len; n > 1; --n)
+    max_int4_pop_array(arr, n);
+}
+
+static void reverse(char *base, size_t len, size_t size, char *tmp) {
+  for (size_t i = 0, j = len - 1; i < j; ++i, --j) {
+    memcpy(tmp, base + i * size, size);
+    memcpy(base + i * size, base + j * size, size);
+    memcpy(base + j * size, tmp, size);
+  }
+  sort_stat_move(len / 2 * 3 * size);
+}
+
+void heap_sort_arity(void *base, size_t len, size_t size,
+                     int (*cmp)(const void *, const void *), unsigned arity) {
+  if (base == NULL || cmp == NULL || size == 0 || len < 2 || arity < 2 ||
+      arity > HEAP_MAX_ARITY)
+    return;
+  char *tmp = malloc(size);
+  if (!tmp)
+    return;
+
+  heap_make(base, len, size, arity, cmp, tmp);
+  for (size_t n = len; n > 1; --n)
+    heap_pop_array(base, n, size, arity, cmp, tmp);
+  reverse(base, len, size, tmp); // popped minima filled the tail first
+
+  free(tmp);
+}
+
+void heap_sort(void *base, size_t len, size_t size,
+               int (*cmp)(const void *, const void *)) {
+  if (cmp == compare_int && size == sizeof(int)) {
+    heap_sort_int(base, len);
+    return;
+  }
+  heap_sort_arity(base, len, size, cmp, HEAP_DEFAULT_ARITY);
+}
@@ -0,0 +1,39 @@
+#ifndef HEAP_SORT_H
+#define HEAP_SORT_H
+
+#include <stddef.h> // for size_t
+
+/**
+ * @brief Heap Sort on a 4-ary heap (data-structures/heap).
+ *
+ * Builds a min-heap in O(n) and pops it into the tail of the array, which
+ * leaves the elements in descending order; one reversal pass makes them
+ * ascending. Called with compare_int (common/compare.h) on int-sized
+ * elements it takes heap_sort_int instead. In place, not stable,
+ * O(n log n) in every case.
+ *
+ * @param base Pointer to the first element of the array.
+ * @param len Number of elements in the array.
+ * @param size Size of each element in bytes.
+ * @param cmp Comparison function to determine the order.
+ */
+void heap_sort(void *base, size_t len, size_t size,
+               int (*cmp)(const void *, const void *));
+
+/**
+ * @brief heap_sort with a chosen heap arity (2 .. HEAP_MAX_ARITY), for
+ * comparing layouts. heap_sort uses HEAP_DEFAULT_ARITY.
+ */
+void heap_sort_arity(void *base, size_t len, size_t size,
+                     int (*cmp)(const void *, const void *), unsigned arity);
+
+/**
+ * @brief Heap Sort for int arrays on a typed 4-ary max-heap (HEAP_DEFINE):
+ * inlined comparisons, no reversal pass.
+ *
+ * @param arr Pointer to the first element of the array.
+ * @param len Number of elements in the array.
+ */
+void heap_sort_int(int *arr, size_t len);
+
+#endif // HEAP_SORT_H
@@ -1,9 +1,132 @@
+#include "insertion_sort.h"
+#include "../../common/compare.h"
+#include "../../common/cpu_dispatch.h"
+#include "../sort_stats.h"
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#if CPU_X86
+#include <immintrin.h>
+#endif
+
+/*
+ * int kernels. Each finds where arr[i] goes in the sorted prefix, then
+ * shifts the block with memmove. The SIMD ones find the spot by comparing a
+ * whole vector of the prefix (scanning back from i) with the key at once:
+ * the elements > key are a suffix of the prefix, so the first vector that
+ * is not entirely > key contains the spot, and a popcount gives it.
+ * Equal elements are never passed, which keeps the sort stable.
+ */
+
+typedef void (*InsertionSortInt)(int *arr, size_t len);
+
+static void insertion_sort_scalar(int *arr, size_t len) {
+  for (size_t i = 1; i < len; ++i) {
+    int key = arr[i];
+    size_t j = i;
+    while (j > 0 && SORT_COMPARED(arr[j - 1] > key)) {
+      arr[j] = arr[j - 1];
+      j--;
+    }
+    arr[j] = key;
+    sort_stat_move((i - j + 1) * sizeof *arr);
+  }
+}
+
+static inline void insert_at(int *arr, size_t i, size_t j, int key) {
+  memmove(arr + j + 1, arr + j, (i - j) * sizeof *arr);
+  arr[j] = key;
+  sort_stat_move((i - j + 1) * sizeof *arr);
+}
+
+#if CPU_X86
+CPU_TARGET_AVX2 static void insertion_sort_avx2(int *arr, size_t len) {
+  for (size_t i = 1; i < len; ++i) {
+    int key = arr[i];
+    if (SORT_COMPARED(arr[i - 1] <= key)) // already in place (nearly sorted)
+      continue;
+    __m256i k = _mm256_set1_epi32(key);
+    size_t j = i;
+    while (j >= 8) {
+      __m256i v = _mm256_loadu_si256((const __m256i *)(arr + j - 8));
+      unsigned greater = (unsigned)_mm256_movemask_ps(
+          _mm256_castsi256_ps(_mm256_cmpgt_epi32(v, k)));
+      sort_stat_compare(8);
+      if (greater != 0xFF) {
+        j -= (size_t)__builtin_popcount(greater);
+        goto found;
+      }
+      j -= 8;
+    }
+    while (j > 0 && SORT_COMPARED(arr[j - 1] > key))
+      j--;
+  found:
+    insert_at(arr, i, j, key);
+  }
+}
+
+CPU_TARGET_AVX512 static void insertion_sort_avx512(int *arr, size_t len) {
+  for (size_t i = 1; i < len; ++i) {
+    int key = arr[i];
+    if (SORT_COMPARED(arr[i - 1] <= key))
+      continue;
+    __m512i k = _mm512_set1_epi32(key);
+    size_t j = i;
+    while (j >= 16) {
+      unsigned greater = _mm512_cmpgt_epi32_mask(
+          _mm512_loadu_si512(arr + j - 16), k);
+      sort_stat_compare(16);
+      if (greater != 0xFFFF) {
+        j -= (size_t)__builtin_popcount(greater);
+        goto found;
+      }
+      j -= 16;
+    }
+    while (j > 0 && SORT_COMPARED(arr[j - 1] > key))
+      j--;
+  found:
+    insert_at(arr, i, j, key);
+  }
+}
+#endif
+
+static void insertion_sort_resolve(int *arr, size_t len);
+
+static _Atomic(InsertionSortInt) insertion_sort_impl = insertion_sort_resolve;
+
+// First call: pick the kernel for this CPU, then forward to it.
+static void insertion_sort_resolve(int *arr, size_t len) {
+  InsertionSortInt impl = insertion_sort_scalar;
+#if CPU_X86
+  switch (cpu_isa()) {
+  case CPU_ISA_AVX512:
+    impl = insertion_sort_avx512;
+    break;
+  case CPU_ISA_AVX2:
+    impl = insertion_sort_avx2;
+    break;
+  default:
+    break;
+  }
+#endif
+  atomic_store_explicit(&insertion_sort_impl, impl, memory_order_relaxed);
+  impl(arr, len);
+}
+
+void insertion_sort_int(int *arr, size_t len) {
+  InsertionSortInt impl =
+      atomic_load_explicit(&insertion_sort_impl, memory_order_relaxed);
+  impl(arr, len);
+}
 
 void insertion_sort(void *base, size_t len, size_t size,
                     int (*cmp)(const void *, const void *)) {
+  if (cmp == compare_int && size == sizeof(int)) {
+    insertion_sort_int(base, len);
+    return;
+  }
+
   char *array = base;
   char *key = malloc(size);
   if (!key)
@@ -14,7 +137,7 @@ void insertion_sort(void *base, size_t len, size_t size,
     memcpy(key, curr, size);
 
     size_t j = i;
-    while (j > 0 && cmp(array + (j - 1) * size, key) > 0) {
+    while (j > 0 && SORT_COMPARED(cmp(array + (j - 1) * size, key) > 0)) {
       j--;
     }
 
@@ -23,6 +146,7 @@ void insertion_sort(void *base, size_t len, size_t size,
 
     // Insere a chave
     memcpy(array + j * size, key, size);
+    sort_stat_move((i - j + 1) * size);
   }
 
   free(key);
@@ -14,4 +14,16 @@
 void insertion_sort(void *base, size_t len, size_t size,
                     int (*cmp)(const void *, const void *));
 
+/**
+ * @brief Insertion Sort for int arrays, dispatched at runtime to a scalar,
+ * AVX2 or AVX-512 kernel (see common/cpu_dispatch.h).
+ *
+ * insertion_sort takes this path by itself when called with compare_int
+ * (common/compare.h) on int-sized elements.
+ *
+ * @param arr Pointer to the first element of the array.
+ * @param len Number of elements in the array.
+ */
+void insertion_sort_int(int *arr, size_t len);
+
 #endif // INSERTION_SORT_H
@@ -0,0 +1,21 @@
+#include "merge_sort.h"
+#include <stdio.h>
+
+int main() {
+  int arr[] = {1, 2, 5, 10, 2, 33, 0, 4};
+  size_t len = sizeof(arr) / sizeof(int);
+
+  printf("Array original: ");
+  for (size_t i = 0; i < len; ++i)
+    printf("%d ", arr[i]);
+  printf("\n");
+
+  merge_sort(arr, 0, len - 1);
+
+  printf("Array ordenado: ");
+  for (size_t i = 0; i < len; ++i)
+    printf("%d ", arr[i]);
+  printf("\n");
+
+  return 0;
+}
@@ -1,50 +1,40 @@
-#include <stddef.h>
-#include <stdio.h>
+#include "merge_sort.h"
+#include "../sort_stats.h"
 #include <stdlib.h>
+#include <string.h>
 
+/*
+ * Merges the sorted runs arr[begin..mid] and arr[mid+1..end].
+ * On equal keys the left run goes first, which keeps the sort stable.
+ */
 void merge(int *arr, size_t begin, size_t mid, size_t end) {
-  int *temp_buffer = malloc((end - begin + 1) * sizeof(int));
-  printf("%zu %zu %zu\n", begin, mid, end);
+  size_t len = end - begin + 1;
+  int *temp_buffer = malloc(len * sizeof(int));
+  if (temp_buffer == NULL)
+    return;
+
   size_t first_arr = begin, second_arr = mid + 1;
-  for (size_t i = 0; i < end - begin + 1; ++i) {
-    if ((first_arr <= mid && arr[first_arr] <= arr[second_arr]) ||
-        second_arr > end) {
-      temp_buffer[i] = arr[i];
-      arr[i] = arr[first_arr];
-      ++first_arr;
-    } else {
-      temp_buffer[i] = arr[i];
-      arr[i] = arr[second_arr];
-      ++second_arr;
-    }
+  for (size_t i = 0; i < len; ++i) {
+    if (second_arr > end ||
+        (first_arr <= mid && SORT_COMPARED(arr[first_arr] <= arr[second_arr])))
+      temp_buffer[i] = arr[first_arr++];
+    else
+      temp_buffer[i] = arr[second_arr++];
   }
+
+  memcpy(arr + begin, temp_buffer, len * sizeof(int));
+  sort_stat_move(2 * len * sizeof(int)); // into the buffer and back
+  free(temp_buffer);
 }
 
 void merge_sort(int *arr, size_t begin, size_t end) {
   if (begin < end) {
+    sort_stat_enter();
     size_t mid = begin + (end - begin) / 2;
 
     merge_sort(arr, begin, mid);
     merge_sort(arr, mid + 1, end);
     merge(arr, begin, mid, end);
+    sort_stat_leave();
   }
 }
-
-int main() {
-  int arr[] = {1, 2, 5, 10, 2, 33, 0, 4};
-  size_t len = sizeof(arr) / sizeof(int);
-
-  printf("Array original: ");
-  for (size_t i = 0; i < len; ++i)
-    printf("%d ", arr[i]);
-  printf("\n");
-
-  merge_sort(arr, 0, len - 1);
-
-  printf("Array ordenado: ");
-  for (size_t i = 0; i < len; ++i)
-    printf("%d ", arr[i]);
-  printf("\n");
-
-  return 0;
-}
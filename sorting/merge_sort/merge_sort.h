@@ -0,0 +1,20 @@
+#ifndef MERGE_SORT_H
+#define MERGE_SORT_H
+
+#include <stddef.h> // For size_t
+
+/*
+ * Merge Sort algorithm (top-down, stable)
+ *
+ * Params:
+ *     arr   - pointer to the array
+ *     begin - start index of the subarray
+ *     end   - end index of the subarray (inclusive)
+ *
+ * Description:
+ *     Recursively sorts both halves of arr[begin..end] and merges them
+ *     through a temporary buffer. O(n log n) time, O(n) extra space.
+ */
+void merge_sort(int *arr, size_t begin, size_t end);
+
+#endif // MERGE_SORT_H
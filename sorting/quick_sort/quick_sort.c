@@ -1,4 +1,5 @@
 #include "quick_sort.h"
+#include "../sort_stats.h"
 #include <assert.h>
 #include <stdlib.h> // for rand()
 
@@ -17,6 +18,7 @@ static inline void swap(int *a, int *b) {
   int temp = *a;
   *a = *b;
   *b = temp;
+  sort_stat_swap(sizeof(int));
 }
 
 /*
@@ -33,7 +35,7 @@ size_t Lomuto(int arr[], size_t begin, size_t end) {
   size_t pivot_idx = begin;
 
   for (size_t i = begin; i < end; ++i) {
-    if (arr[i] <= pivot) {
+    if (SORT_COMPARED(arr[i] <= pivot)) {
       swap(&arr[i], &arr[pivot_idx]);
       ++pivot_idx;
     }
@@ -61,12 +63,15 @@ size_t random_Lomuto(int arr[], size_t begin, size_t end) {
  */
 void quick_sort(int arr[], size_t begin, size_t end) {
   if (begin < end) {
+    sort_stat_enter();
     size_t pivot_idx = random_Lomuto(arr, begin, end);
+    sort_stat_partition(pivot_idx - begin, end - pivot_idx);
 
     // Sort left subarray
     quick_sort(arr, begin, (pivot_idx > 0) ? pivot_idx - 1 : 0);
 
     // Sort right subarray
     quick_sort(arr, pivot_idx + 1, end);
+    sort_stat_leave();
   }
 }
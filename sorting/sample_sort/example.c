@@ -0,0 +1,77 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#include "../quick_sort/quick_sort.h"
+#include "sample_sort.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Scaling of sample_sort against the single-threaded quick_sort, on N
+ * random ints and on N ints with only 16 distinct values (where
+ * quick_sort's Lomuto partition goes quadratic, so it is skipped).
+ *
+ * Build: gcc -O2 -pthread example.c sample_sort.c ../quick_sort/quick_sort.c \
+ *        ../insertion_sort/insertion_sort.c ../../common/cpu_dispatch.c \
+ *        ../../common/compare.c ../../common/parallel.c
+ */
+
+#define N (1 << 24)
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void fill(int *arr, size_t n, unsigned distinct) {
+  uint64_t s = 88172645463325252ull;
+  for (size_t i = 0; i < n; ++i) {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    arr[i] = distinct ? (int)(s % distinct) : (int)(uint32_t)s;
+  }
+}
+
+static int is_sorted(const int *arr, size_t n) {
+  for (size_t i = 1; i < n; ++i)
+    if (arr[i - 1] > arr[i])
+      return 0;
+  return 1;
+}
+
+static void run(const char *name, unsigned distinct, int *arr) {
+  double base = 0;
+  printf("%s, n = %d:\n", name, N);
+  if (distinct == 0) {
+    fill(arr, N, distinct);
+    double t0 = now();
+    quick_sort(arr, 0, N - 1);
+    base = now() - t0;
+    printf("  quick_sort           %7.3f s%s\n", base,
+           is_sorted(arr, N) ? "" : "  NOT SORTED");
+  }
+  for (unsigned threads = 1; threads <= 8; threads *= 2) {
+    fill(arr, N, distinct);
+    double t0 = now();
+    int rc = sample_sort(arr, N, threads);
+    double dt = now() - t0;
+    if (base == 0)
+      base = dt; // no quick_sort baseline: relative to 1 thread
+    printf("  sample_sort %u thread%s %7.3f s  (x%.2f)%s\n", threads,
+           threads > 1 ? "s" : " ", dt, base / dt,
+           rc == 0 && is_sorted(arr, N) ? "" : "  NOT SORTED");
+  }
+}
+
+int main() {
+  int *arr = malloc(N * sizeof *arr);
+  if (arr == NULL)
+    return 1;
+  run("random", 0, arr);
+  run("16 distinct values", 16, arr);
+  free(arr);
+  return 0;
+}
@@ -0,0 +1,339 @@
+#define _GNU_SOURCE // sched_setaffinity, CPU_SET
+#include "sample_sort.h"
+#include "../insertion_sort/insertion_sort.h"
+#include "../../common/parallel.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#define SPLITTERS (1u << SAMPLE_SORT_LOG_SPLITTERS) // tree leaves
+#define BUCKETS (2 * SPLITTERS) // a regular and an equality bucket per leaf
+#define SMALL_SORT 24           // insertion sort below this many elements
+#define PAGE_INTS (4096 / sizeof(int))
+
+/*
+ * Serial kernel: quicksort with a median-of-three pivot and Hoare
+ * partitioning. Hoare stops on elements equal to the pivot on both sides,
+ * so runs of duplicates split down the middle instead of going quadratic
+ * the way Lomuto does. It recurses into the smaller side only, which keeps
+ * the stack at O(log n).
+ */
+
+static inline void swap_int(int *a, int *b) {
+  int t = *a;
+  *a = *b;
+  *b = t;
+}
+
+static void sort_serial(int *a, size_t n) {
+  while (n > SMALL_SORT) {
+    // order a[0], a[mid], a[n-1], then move the median to a[0] as pivot
+    int *mid = a + n / 2, *last = a + n - 1;
+    if (*mid < *a)
+      swap_int(mid, a);
+    if (*last < *mid) {
+      swap_int(last, mid);
+      if (*mid < *a)
+        swap_int(mid, a);
+    }
+    swap_int(a, mid);
+    int pivot = a[0];
+
+    // a[0..j] <= pivot <= a[j+1..n-1], both sides non-empty
+    ptrdiff_t i = -1, j = (ptrdiff_t)n;
+    for (;;) {
+      do
+        i++;
+      while (a[i] < pivot);
+      do
+        j--;
+      while (a[j] > pivot);
+      if (i >= j)
+        break;
+      swap_int(&a[i], &a[j]);
+    }
+
+    size_t left = (size_t)j + 1, right = n - left;
+    if (left < right) {
+      sort_serial(a, left);
+      a += left;
+      n = right;
+    } else {
+      sort_serial(a + left, right);
+      n = left;
+    }
+  }
+  insertion_sort_int(a, n);
+}
+
+/*
+ * Splitter tree. tree[1 .. SPLITTERS) holds the sorted splitters in
+ * breadth-first (Eytzinger) order: the children of node j are 2j and 2j+1.
+ * Descending compares without branching (j = 2j + (tree[j] < x)); after
+ * LOG_SPLITTERS steps, j - SPLITTERS is the number of splitters below x.
+ * Unused splitter slots repeat the largest splitter, which only leaves
+ * some buckets empty.
+ */
+
+typedef struct {
+  int tree[SPLITTERS];
+  int sorted[SPLITTERS]; // sorted[i]: splitter bounding leaf i from above
+} Splitters;
+
+static void build_tree(Splitters *sp, unsigned node, unsigned lo,
+                       unsigned hi) {
+  if (node >= SPLITTERS)
+    return;
+  unsigned mid = lo + (hi - lo) / 2;
+  sp->tree[node] = sp->sorted[mid];
+  build_tree(sp, 2 * node, lo, mid);
+  build_tree(sp, 2 * node + 1, mid + 1, hi);
+}
+
+// Regular bucket 2i for x in (sorted[i-1], sorted[i]); equality bucket
+// 2i+1 for x == sorted[i].
+static inline unsigned classify(const Splitters *sp, int x) {
+  unsigned j = 1;
+  for (int level = 0; level < SAMPLE_SORT_LOG_SPLITTERS; ++level)
+    j = 2 * j + (sp->tree[j] < x);
+  j -= SPLITTERS;
+  return 2 * j + (x == sp->sorted[j]);
+}
+
+static uint64_t splitmix(uint64_t *state) {
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+static int cmp_int(const void *a, const void *b) {
+  int x = *(const int *)a, y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+
+// Oversample, sort the sample, keep every OVERSAMPLE-th distinct value.
+static void pick_splitters(Splitters *sp, const int *arr, size_t len) {
+  enum { SAMPLES = SPLITTERS * SAMPLE_SORT_OVERSAMPLE };
+  int sample[SAMPLES];
+  uint64_t state = len;
+  for (size_t i = 0; i < SAMPLES; ++i)
+    sample[i] = arr[splitmix(&state) % len];
+  qsort(sample, SAMPLES, sizeof *sample, cmp_int);
+
+  unsigned count = 0;
+  for (unsigned i = 1; i < SPLITTERS; ++i) {
+    int s = sample[i * SAMPLE_SORT_OVERSAMPLE];
+    if (count == 0 || s != sp->sorted[count - 1])
+      sp->sorted[count++] = s;
+  }
+  for (unsigned i = count; i < SPLITTERS; ++i)
+    sp->sorted[i] = sp->sorted[count - 1];
+  build_tree(sp, 1, 0, SPLITTERS - 1);
+}
+
+/*
+ * Parallel driver: phases run through parallel_run (common/parallel.h),
+ * one thread per worker, joined before the next phase starts.
+ */
+
+typedef struct {
+  int *arr, *tmp;
+  size_t len;
+  unsigned threads;
+  Splitters sp;
+  size_t *hist;         // [thread][bucket]: count, then write position
+  size_t *bucket_start; // BUCKETS + 1 entries
+  unsigned *first;      // worker t sorts buckets [first[t], first[t + 1])
+  int *cpus;            // CPU to pin worker t to: cpus[t % ncpus]
+  unsigned ncpus;
+} SampleSort;
+
+typedef struct {
+  ParallelTask task; // pinned only when task.own_thread
+  SampleSort *s;
+} Worker;
+
+static void pin(const Worker *w) {
+#ifdef __linux__
+  const SampleSort *s = w->s;
+  if (!w->task.own_thread || s->ncpus == 0)
+    return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(s->cpus[w->task.id % s->ncpus], &set);
+  sched_setaffinity(0, sizeof set, &set); // this thread only
+#else
+  (void)w;
+#endif
+}
+
+static void *classify_chunk(void *arg) {
+  Worker *w = arg;
+  SampleSort *s = w->s;
+  pin(w);
+  size_t begin, end;
+  parallel_chunk(s->len, s->threads, w->task.id, &begin, &end);
+  size_t *hist = s->hist + (size_t)w->task.id * BUCKETS;
+
+  // four independent descents in flight hide the compare latency
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    unsigned b0 = classify(&s->sp, s->arr[i]);
+    unsigned b1 = classify(&s->sp, s->arr[i + 1]);
+    unsigned b2 = classify(&s->sp, s->arr[i + 2]);
+    unsigned b3 = classify(&s->sp, s->arr[i + 3]);
+    hist[b0]++;
+    hist[b1]++;
+    hist[b2]++;
+    hist[b3]++;
+  }
+  for (; i < end; ++i)
+    hist[classify(&s->sp, s->arr[i])]++;
+  return NULL;
+}
+
+static void *touch_buckets(void *arg) {
+  Worker *w = arg;
+  SampleSort *s = w->s;
+  pin(w);
+  size_t begin = s->bucket_start[s->first[w->task.id]];
+  size_t end = s->bucket_start[s->first[w->task.id + 1]];
+  for (size_t i = begin; i < end; i += PAGE_INTS)
+    s->tmp[i] = 0;
+  return NULL;
+}
+
+static void *scatter_chunk(void *arg) {
+  Worker *w = arg;
+  SampleSort *s = w->s;
+  pin(w);
+  size_t begin, end;
+  parallel_chunk(s->len, s->threads, w->task.id, &begin, &end);
+  size_t *pos = s->hist + (size_t)w->task.id * BUCKETS;
+
+  // classifying again is cheaper than storing and re-reading a bucket id
+  // per element
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    int x0 = s->arr[i], x1 = s->arr[i + 1];
+    int x2 = s->arr[i + 2], x3 = s->arr[i + 3];
+    unsigned b0 = classify(&s->sp, x0), b1 = classify(&s->sp, x1);
+    unsigned b2 = classify(&s->sp, x2), b3 = classify(&s->sp, x3);
+    s->tmp[pos[b0]++] = x0;
+    s->tmp[pos[b1]++] = x1;
+    s->tmp[pos[b2]++] = x2;
+    s->tmp[pos[b3]++] = x3;
+  }
+  for (; i < end; ++i) {
+    int x = s->arr[i];
+    s->tmp[pos[classify(&s->sp, x)]++] = x;
+  }
+  return NULL;
+}
+
+static void *sort_buckets(void *arg) {
+  Worker *w = arg;
+  SampleSort *s = w->s;
+  pin(w);
+  for (unsigned b = s->first[w->task.id]; b < s->first[w->task.id + 1]; ++b) {
+    if (b % 2 == 1) // equality bucket: already sorted
+      continue;
+    size_t begin = s->bucket_start[b];
+    sort_serial(s->tmp + begin, s->bucket_start[b + 1] - begin);
+  }
+  size_t begin = s->bucket_start[s->first[w->task.id]];
+  size_t end = s->bucket_start[s->first[w->task.id + 1]];
+  memcpy(s->arr + begin, s->tmp + begin, (end - begin) * sizeof *s->arr);
+  return NULL;
+}
+
+// Offsets from the histograms, then whole buckets to workers by size.
+static void plan(SampleSort *s) {
+  size_t pos = 0;
+  for (unsigned b = 0; b < BUCKETS; ++b) {
+    s->bucket_start[b] = pos;
+    for (unsigned t = 0; t < s->threads; ++t) {
+      size_t *h = &s->hist[(size_t)t * BUCKETS + b];
+      size_t count = *h;
+      *h = pos;
+      pos += count;
+    }
+  }
+  s->bucket_start[BUCKETS] = pos;
+
+  unsigned b = 0;
+  s->first[0] = 0;
+  for (unsigned t = 1; t < s->threads; ++t) {
+    size_t target = s->len * t / s->threads;
+    while (b < BUCKETS && s->bucket_start[b + 1] <= target)
+      b++;
+    s->first[t] = b;
+  }
+  s->first[s->threads] = BUCKETS;
+}
+
+static void find_cpus(SampleSort *s) {
+  s->ncpus = 0;
+#ifdef __linux__
+  cpu_set_t set;
+  if (sched_getaffinity(0, sizeof set, &set) != 0)
+    return;
+  for (int cpu = 0; cpu < CPU_SETSIZE && s->ncpus < s->threads; ++cpu)
+    if (CPU_ISSET(cpu, &set))
+      s->cpus[s->ncpus++] = cpu;
+#endif
+}
+
+int sample_sort(int arr[], size_t len, unsigned threads) {
+  if (threads == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = online > 0 ? (unsigned)online : 1;
+  }
+  if (len < SAMPLE_SORT_SERIAL || threads == 1) {
+    sort_serial(arr, len);
+    return 0;
+  }
+
+  SampleSort *s = malloc(sizeof *s);
+  if (s == NULL)
+    return -1;
+  s->arr = arr;
+  s->len = len;
+  s->threads = threads;
+  s->tmp = malloc(len * sizeof *arr); // pages placed by touch_buckets
+  s->hist = calloc((size_t)threads * BUCKETS, sizeof *s->hist);
+  s->bucket_start = malloc((BUCKETS + 1) * sizeof *s->bucket_start);
+  s->first = malloc((threads + 1) * sizeof *s->first);
+  s->cpus = malloc(threads * sizeof *s->cpus);
+  Worker *workers = malloc(threads * sizeof *workers);
+  int status = -1;
+  if (s->tmp == NULL || s->hist == NULL || s->bucket_start == NULL ||
+      s->first == NULL || s->cpus == NULL || workers == NULL)
+    goto out;
+  for (unsigned t = 0; t < threads; ++t)
+    workers[t] = (Worker){.s = s};
+
+  find_cpus(s);
+  pick_splitters(&s->sp, arr, len);
+  parallel_run(workers, sizeof *workers, threads, classify_chunk);
+  plan(s);
+  parallel_run(workers, sizeof *workers, threads, touch_buckets);
+  parallel_run(workers, sizeof *workers, threads, scatter_chunk);
+  parallel_run(workers, sizeof *workers, threads, sort_buckets);
+  status = 0;
+
+out:
+  free(workers);
+  free(s->cpus);
+  free(s->first);
+  free(s->bucket_start);
+  free(s->hist);
+  free(s->tmp);
+  free(s);
+  return status;
+}
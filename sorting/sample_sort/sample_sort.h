@@ -0,0 +1,48 @@
+#ifndef SAMPLE_SORT_H
+#define SAMPLE_SORT_H
+
+#include <stddef.h> // For size_t
+
+/*
+ * Parallel Sample Sort (int arrays)
+ *
+ * Params:
+ *     arr     - pointer to the array
+ *     len     - number of elements
+ *     threads - worker threads; 0 uses every online CPU
+ *
+ * Returns:
+ *     0 on success, -1 if a buffer could not be allocated (arr is then
+ *     left untouched).
+ *
+ * Description:
+ *     Draws SAMPLE_SORT_OVERSAMPLE samples per bucket and picks evenly
+ *     spaced splitters from them. Then:
+ *       1. each thread classifies its chunk through a branchless splitter
+ *          tree and builds a per-thread bucket histogram;
+ *       2. the histograms give every (thread, bucket) pair its own output
+ *          range, so the scatter into a buffer needs no synchronisation;
+ *       3. each thread sorts a contiguous run of whole buckets and copies
+ *          it back.
+ *     Elements equal to a splitter go to a separate equality bucket, which
+ *     is never sorted, so heavy duplicates cost no extra work.
+ *
+ *     NUMA: workers are pinned to distinct CPUs. Before the scatter, each
+ *     worker first-touches the pages of the buckets it will sort, so the
+ *     kernel places them on its node. Bucket sorting, the memory-heavy
+ *     phase, then runs on node-local memory without a NUMA library.
+ *
+ *     Below SAMPLE_SORT_SERIAL elements, or with one thread, the array is
+ *     sorted in place by the same serial kernel the buckets use
+ *     (median-of-three quicksort, insertion sort for small ranges).
+ *
+ *     Not stable. O(n log n) work, O(n) extra space.
+ */
+
+#define SAMPLE_SORT_LOG_SPLITTERS 8 // 2^8 - 1 splitters, 512 buckets
+#define SAMPLE_SORT_OVERSAMPLE 16
+#define SAMPLE_SORT_SERIAL (1 << 16)
+
+int sample_sort(int arr[], size_t len, unsigned threads);
+
+#endif // SAMPLE_SORT_H
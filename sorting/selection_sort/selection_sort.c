@@ -1,4 +1,5 @@
 #include "selection_sort.h"
+#include "../sort_stats.h"
 #include <assert.h>
 #include <stdbool.h>
 
@@ -8,6 +9,7 @@ static inline void swap(int *a, int *b) {
   int temp = *a;
   *a = *b;
   *b = temp;
+  sort_stat_swap(sizeof(int));
 }
 
 /* Selection Sort implementation */
@@ -17,7 +19,7 @@ void selection_sort(int arr[], size_t len) {
 
     // Find the index of the minimum element in arr[i .. len-1]
     for (size_t j = i + 1; j < len; ++j) {
-      if (arr[j] < arr[min_idx]) {
+      if (SORT_COMPARED(arr[j] < arr[min_idx])) {
         min_idx = j;
       }
     }
@@ -0,0 +1,48 @@
+#include "sort_stats.h"
+#include <string.h>
+
+#ifdef SORT_STATS
+_Thread_local SortStats sort_stats_tls;
+_Thread_local size_t sort_stats_depth;
+
+int sort_stats_get(SortStats *out) {
+  if (out == NULL)
+    return -1;
+  *out = sort_stats_tls;
+  return 0;
+}
+
+void sort_stats_reset(void) {
+  memset(&sort_stats_tls, 0, sizeof sort_stats_tls);
+  sort_stats_depth = 0;
+}
+
+void sort_stats_dump(FILE *out) {
+  if (out == NULL)
+    return;
+  const SortStats *s = &sort_stats_tls;
+  fprintf(out,
+          "sort_stats: %llu comparisons, %llu swaps, %llu bytes moved, "
+          "depth %zu",
+          (unsigned long long)s->comparisons, (unsigned long long)s->swaps,
+          (unsigned long long)s->bytes_moved, s->max_depth);
+  if (s->partitioned > 0)
+    fprintf(out, ", %llu partitions (balance %.3f)",
+            (unsigned long long)s->partitions,
+            (double)s->smaller_side / (double)s->partitioned);
+  fputc('\n', out);
+}
+#else
+int sort_stats_get(SortStats *out) {
+  if (out)
+    memset(out, 0, sizeof(*out));
+  return -1;
+}
+
+void sort_stats_reset(void) {}
+
+void sort_stats_dump(FILE *out) {
+  if (out)
+    fputs("sort_stats: built without SORT_STATS\n", out);
+}
+#endif
@@ -0,0 +1,102 @@
+#ifndef SORT_STATS_H
+#define SORT_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Operation counters for the sorting algorithms (optional)
+ *
+ * Only collected when the sorts are compiled with -DSORT_STATS (and
+ * sort_stats.c is linked). Otherwise every hook below is an empty inline
+ * that the compiler drops, and sort_stats_get reports -1 with zeroed
+ * output. sort_stats.c can always be linked, with or without the option.
+ *
+ * Counters are thread-local: each thread sees the work of the sorts it ran
+ * since its last sort_stats_reset, so concurrent sorts do not mix.
+ *
+ *   comparisons  - element comparisons: comparator calls, or elements
+ *                  covered by a SIMD compare
+ *   swaps        - element exchanges
+ *   bytes_moved  - bytes written into the array or a merge buffer, by
+ *                  swaps (2 elements each), memcpy/memmove and stores
+ *   max_depth    - deepest recursion reached (quick_sort, merge_sort)
+ *   partitions   - quick_sort partition steps
+ *   partitioned  - elements those steps split (pivots excluded)
+ *   smaller_side - of those, elements that landed on the smaller side.
+ *                  smaller_side / partitioned is the size-weighted
+ *                  partition balance: 0.5 for perfect splits, about 0.25
+ *                  for random pivots, near 0 when pivots are extremes
+ *                  (the quadratic case)
+ *
+ * Returns follow linked_list: 0 on success, -1 on failure.
+ */
+
+typedef struct {
+  uint64_t comparisons;
+  uint64_t swaps;
+  uint64_t bytes_moved;
+  size_t max_depth;
+  uint64_t partitions;
+  uint64_t partitioned;
+  uint64_t smaller_side;
+} SortStats;
+
+// This thread's counters. -1 (and zeroed output) without SORT_STATS.
+int sort_stats_get(SortStats *out);
+
+void sort_stats_reset(void);
+
+// One line summary of this thread's counters.
+void sort_stats_dump(FILE *out);
+
+/* -------------------------
+ * Hooks used by the sorts
+ * ------------------------- */
+
+#ifdef SORT_STATS
+extern _Thread_local SortStats sort_stats_tls;
+extern _Thread_local size_t sort_stats_depth;
+
+static inline void sort_stat_compare(uint64_t n) {
+  sort_stats_tls.comparisons += n;
+}
+
+static inline void sort_stat_swap(size_t elem_size) {
+  sort_stats_tls.swaps++;
+  sort_stats_tls.bytes_moved += 2 * elem_size;
+}
+
+static inline void sort_stat_move(size_t bytes) {
+  sort_stats_tls.bytes_moved += bytes;
+}
+
+static inline void sort_stat_enter(void) {
+  if (++sort_stats_depth > sort_stats_tls.max_depth)
+    sort_stats_tls.max_depth = sort_stats_depth;
+}
+
+static inline void sort_stat_leave(void) { sort_stats_depth--; }
+
+static inline void sort_stat_partition(size_t left, size_t right) {
+  sort_stats_tls.partitions++;
+  sort_stats_tls.partitioned += left + right;
+  sort_stats_tls.smaller_side += left < right ? left : right;
+}
+#else
+static inline void sort_stat_compare(uint64_t n) { (void)n; }
+static inline void sort_stat_swap(size_t elem_size) { (void)elem_size; }
+static inline void sort_stat_move(size_t bytes) { (void)bytes; }
+static inline void sort_stat_enter(void) {}
+static inline void sort_stat_leave(void) {}
+static inline void sort_stat_partition(size_t left, size_t right) {
+  (void)left;
+  (void)right;
+}
+#endif
+
+// Counts one comparison and yields the value of expr.
+#define SORT_COMPARED(expr) (sort_stat_compare(1), (expr))
+
+#endif // SORT_STATS_H
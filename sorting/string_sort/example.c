@@ -0,0 +1,117 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime, strdup
+#include "string_sort.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Two string workloads, each against qsort with strcmp:
+ *   - N URLs on a few hosts, so keys share long prefixes
+ *     ("https://www.example.com/users/1234/...");
+ *   - N identifiers ("order_12345678", "customer_00042", ...), also
+ *     sorted as slices without their NUL terminators.
+ *
+ * Build: gcc -O2 -pthread example.c string_sort.c ../../common/parallel.c
+ */
+
+#define N (1 << 21)
+
+static const char *hosts[] = {
+    "https://www.example.com",
+    "https://www.example.org",
+    "https://api.example.com",
+    "http://cdn.example.net",
+};
+static const char *paths[] = {"users", "orders", "static/img", "search"};
+static const char *kinds[] = {"order", "customer", "invoice", "shipment"};
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t xorshift(uint64_t *s) {
+  *s ^= *s << 13;
+  *s ^= *s >> 7;
+  *s ^= *s << 17;
+  return *s;
+}
+
+static int cmp_str(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static int equal(char **a, char **b, size_t n) {
+  for (size_t i = 0; i < n; ++i)
+    if (strcmp(a[i], b[i]) != 0)
+      return 0;
+  return 1;
+}
+
+static void compare(const char *what, char **keys, char **ref) {
+  double t = now();
+  int status = string_sort(keys, N, 1);
+  double t_one = now() - t;
+  memcpy(keys, ref, N * sizeof *keys);
+  t = now();
+  status |= string_sort(keys, N, 0);
+  double t_all = now() - t;
+  t = now();
+  qsort(ref, N, sizeof *ref, cmp_str);
+  double t_qsort = now() - t;
+  printf("%s: string_sort %.3f s (1 thread), %.3f s (all CPUs), "
+         "qsort %.3f s (%.1fx), %s\n",
+         what, t_one, t_all, t_qsort, t_qsort / t_one,
+         status == 0 && equal(keys, ref, N) ? "equal" : "DIFFER");
+}
+
+int main() {
+  char **urls = malloc(N * sizeof *urls), **ids = malloc(N * sizeof *ids);
+  char **ref = malloc(N * sizeof *ref);
+  StringSlice *slices = malloc(N * sizeof *slices);
+  if (!urls || !ids || !ref || !slices)
+    return 1;
+
+  uint64_t s = 88172645463325252ull;
+  char buf[128];
+  for (size_t i = 0; i < N; ++i) {
+    uint64_t r = xorshift(&s);
+    snprintf(buf, sizeof buf, "%s/%s/%llu/item-%llu", hosts[r % 4],
+             paths[(r >> 2) % 4], (unsigned long long)(r >> 40) % 100000,
+             (unsigned long long)(r >> 20) % 1000);
+    urls[i] = strdup(buf);
+    snprintf(buf, sizeof buf, "%s_%08llu", kinds[(r >> 8) % 4],
+             (unsigned long long)(r >> 24) % 100000000);
+    ids[i] = strdup(buf);
+    if (!urls[i] || !ids[i])
+      return 1;
+    slices[i] = (StringSlice){ids[i], strlen(ids[i])};
+  }
+
+  memcpy(ref, urls, N * sizeof *ref);
+  compare("URLs", urls, ref);
+  memcpy(ref, ids, N * sizeof *ref);
+  compare("identifiers", ids, ref);
+
+  double t = now();
+  int status = string_sort_slices(slices, N, 1);
+  double t_slices = now() - t;
+  int ok = status == 0;
+  for (size_t i = 0; i < N && ok; ++i) // ref now holds the sorted ids
+    ok = slices[i].ptr == ref[i] || strcmp(slices[i].ptr, ref[i]) == 0;
+  printf("identifier slices: string_sort_slices %.3f s (1 thread), %s\n",
+         t_slices, ok ? "equal" : "DIFFER");
+
+  for (size_t i = 0; i < N; ++i) {
+    free(urls[i]);
+    free(ids[i]);
+  }
+  free(slices);
+  free(ref);
+  free(ids);
+  free(urls);
+  return 0;
+}
@@ -0,0 +1,505 @@
+#include "string_sort.h"
+#include "../sort_stats.h"
+#include "../../common/parallel.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define INSERTION 16       // groups below this finish with insertion sort
+#define PREFETCH_AHEAD 8   // keys loaded ahead while refilling caches
+#define TOP_BUCKETS 65536  // parallel top level: two bytes
+
+/*
+ * Entries. Every key of a group shares its first `depth` bytes, and the
+ * group's next `avail` bytes (0 .. 8) sit in the top of each cache,
+ * big-endian, zero-padded past the key's end. Padding only ever makes two
+ * caches tie, never inverts them: a key that ends is a prefix of any key
+ * it ties with. Groups never advance past the end of a key, so
+ * len - depth does not wrap.
+ */
+
+typedef struct {
+  uint64_t cache;
+  const unsigned char *ptr;
+  size_t len;
+} Entry;
+
+static inline void swap_entries(Entry *a, Entry *b) {
+  Entry t = *a;
+  *a = *b;
+  *b = t;
+}
+
+static inline uint64_t load_cache(const unsigned char *p, size_t rem) {
+  uint64_t x = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  if (rem >= 8) {
+    memcpy(&x, p, 8);
+    return __builtin_bswap64(x);
+  }
+#endif
+  for (size_t i = 0; i < 8; ++i)
+    x = x << 8 | (i < rem ? p[i] : 0);
+  return x;
+}
+
+static void refill(Entry *a, size_t n, size_t depth) {
+  for (size_t i = 0; i < n; ++i) {
+    if (i + PREFETCH_AHEAD < n)
+      __builtin_prefetch(a[i + PREFETCH_AHEAD].ptr + depth);
+    a[i].cache = load_cache(a[i].ptr + depth, a[i].len - depth);
+  }
+}
+
+static int compare_tail(const Entry *x, const Entry *y, size_t depth) {
+  size_t lx = x->len - depth, ly = y->len - depth;
+  size_t common = lx < ly ? lx : ly;
+  int c = common > 0 ? memcmp(x->ptr + depth, y->ptr + depth, common) : 0;
+  if (c != 0)
+    return c;
+  return (lx > ly) - (lx < ly);
+}
+
+static int compare_entries(const Entry *x, const Entry *y, size_t depth,
+                           unsigned avail) {
+  if (avail > 0) {
+    if (x->cache != y->cache)
+      return x->cache < y->cache ? -1 : 1;
+    // either key ends in the cached bytes: it is a prefix of the other
+    if (x->len - depth <= avail || y->len - depth <= avail)
+      return (x->len > y->len) - (x->len < y->len);
+    depth += avail;
+  }
+  return compare_tail(x, y, depth);
+}
+
+static void insertion(Entry *a, size_t n, size_t depth, unsigned avail) {
+  for (size_t i = 1; i < n; ++i) {
+    Entry x = a[i];
+    size_t j = i;
+    while (j > 0 &&
+           SORT_COMPARED(compare_entries(&x, &a[j - 1], depth, avail) < 0)) {
+      a[j] = a[j - 1];
+      --j;
+    }
+    a[j] = x;
+  }
+}
+
+static inline uint64_t median3(uint64_t a, uint64_t b, uint64_t c) {
+  if (a > b) {
+    uint64_t t = a;
+    a = b;
+    b = t;
+  }
+  return c <= a ? a : c >= b ? b : c;
+}
+
+static uint64_t pick_pivot(const Entry *a, size_t n) {
+  if (n < 128)
+    return median3(a[0].cache, a[n / 2].cache, a[n - 1].cache);
+  size_t e = n / 8; // Tukey's ninther
+  return median3(median3(a[0].cache, a[e].cache, a[2 * e].cache),
+                 median3(a[3 * e].cache, a[4 * e].cache, a[5 * e].cache),
+                 median3(a[6 * e].cache, a[7 * e].cache, a[n - 1].cache));
+}
+
+/*
+ * Serial kernel, in place. Each step splits the group, recurses into the
+ * smaller parts and loops on the largest, so the recursion stays
+ * O(log n) deep however long the shared prefixes are.
+ */
+
+static void sort_group(Entry *a, size_t n, size_t depth, unsigned avail);
+
+static inline unsigned bucket_of(const Entry *e, size_t depth) {
+  return e->len == depth ? 0 : (unsigned)(e->cache >> 56) + 1;
+}
+
+// One MSD radix step on the top cached byte. Bucket 0 holds keys that end
+// at depth (all equal, done); bucket b + 1 those whose next byte is b.
+// Returns 0 when the caller should stop, else the number of bytes consumed
+// with the largest bucket left in *a, *n to continue with.
+static unsigned radix_step(Entry **a, size_t *n, size_t depth,
+                           unsigned avail) {
+  size_t count[257] = {0};
+  Entry *in = *a;
+  size_t len = *n, min_rem = SIZE_MAX;
+  uint64_t diff = 0; // bits where some cache differs from the first
+  for (size_t i = 0; i < len; ++i) {
+    size_t rem = in[i].len - depth;
+    count[bucket_of(&in[i], depth)]++;
+    diff |= in[i].cache ^ in[0].cache;
+    min_rem = rem < min_rem ? rem : min_rem;
+  }
+  if (count[0] == len)
+    return 0;
+
+  // No split: skip every cached byte all keys share in this one pass
+  // instead of a pass per byte, stopping at the end of the shortest key.
+  unsigned same = diff ? (unsigned)__builtin_clzll(diff) / 8 : 8;
+  same = same < avail ? same : avail;
+  same = min_rem < same ? (unsigned)min_rem : same;
+  if (same > 0) {
+    for (size_t i = 0; i < len; ++i)
+      in[i].cache = same < 8 ? in[i].cache << 8 * same : 0;
+    return same;
+  }
+
+  unsigned largest = 1;
+  for (unsigned b = 2; b < 257; ++b)
+    largest = count[b] > count[largest] ? b : largest;
+
+  size_t start[258];
+  start[0] = 0;
+  for (unsigned b = 0; b < 257; ++b)
+    start[b + 1] = start[b] + count[b];
+  // American flag sort: follow each displaced entry to its bucket, so
+  // every entry moves once and no buffer is needed.
+  size_t pos[257];
+  memcpy(pos, start, sizeof pos);
+  for (unsigned b = 0; b < 257; ++b) {
+    while (pos[b] < start[b + 1]) {
+      Entry e = in[pos[b]];
+      unsigned d = bucket_of(&e, depth);
+      while (d != b) {
+        Entry next = in[pos[d]];
+        e.cache <<= 8;
+        in[pos[d]++] = e;
+        e = next;
+        d = bucket_of(&e, depth);
+      }
+      e.cache <<= 8;
+      in[pos[b]++] = e;
+    }
+  }
+  sort_stat_move(len * sizeof *in);
+
+  for (unsigned b = 1; b < 257; ++b)
+    if (b != largest && count[b] > 1)
+      sort_group(in + start[b], count[b], depth + 1, avail - 1);
+  *a = in + start[largest];
+  *n = count[largest];
+  return 1;
+}
+
+// Keys whose equal caches hold their whole remainder, ordered by length.
+// At most avail + 1 lengths occur, so a pass per length is linear.
+static void sort_finished(Entry *a, size_t n, size_t depth, unsigned avail) {
+  size_t done = 0;
+  for (unsigned r = 0; r < avail && done < n; ++r)
+    for (size_t i = done; i < n; ++i)
+      if (a[i].len - depth == r)
+        swap_entries(&a[done++], &a[i]);
+}
+
+static void sort_group(Entry *a, size_t n, size_t depth, unsigned avail) {
+  sort_stat_enter();
+  for (;;) {
+    if (n < 2)
+      break;
+    if (avail == 0) { // also for insertion sort: n loads beat n^2 compares
+      refill(a, n, depth);
+      avail = 8;
+    }
+    if (n < INSERTION) {
+      insertion(a, n, depth, avail);
+      break;
+    }
+    if (n >= STRING_SORT_RADIX) {
+      unsigned used = radix_step(&a, &n, depth, avail);
+      if (used == 0)
+        break;
+      depth += used;
+      avail -= used;
+      continue;
+    }
+
+    // Multikey quicksort: three-way partition on the cached bytes.
+    uint64_t p = pick_pivot(a, n);
+    size_t lt = 0, i = 0, gt = n;
+    while (i < gt) {
+      uint64_t c = a[i].cache;
+      if (SORT_COMPARED(c < p))
+        swap_entries(&a[lt++], &a[i++]);
+      else if (c > p)
+        swap_entries(&a[i], &a[--gt]);
+      else
+        i++;
+    }
+    sort_stat_partition(lt, n - gt);
+
+    // Equal part: keys that end within the cache are done once ordered by
+    // length; the rest share avail more bytes and continue past them.
+    Entry *eq = a + lt;
+    size_t f = 0;
+    for (size_t j = 0; j < gt - lt; ++j)
+      if (eq[j].len - depth <= avail)
+        swap_entries(&eq[f++], &eq[j]);
+    sort_finished(eq, f, depth, avail);
+
+    size_t n_lt = lt, n_gt = n - gt, n_eq = gt - lt - f;
+    if (n_eq >= n_lt && n_eq >= n_gt) {
+      sort_group(a, n_lt, depth, avail);
+      sort_group(a + gt, n_gt, depth, avail);
+      a = eq + f;
+      n = n_eq;
+      depth += avail;
+      avail = 0;
+    } else if (n_lt >= n_gt) {
+      sort_group(eq + f, n_eq, depth + avail, 0);
+      sort_group(a + gt, n_gt, depth, avail);
+      n = n_lt;
+    } else {
+      sort_group(eq + f, n_eq, depth + avail, 0);
+      sort_group(a, n_lt, depth, avail);
+      a += gt;
+      n = n_gt;
+    }
+  }
+  sort_stat_leave();
+}
+
+/*
+ * Parallel driver: phases run through parallel_run (common/parallel.h), as
+ * in sample_sort. Worker t always owns input chunk t.
+ */
+
+typedef struct {
+  char **strs;         // input and output, or
+  StringSlice *slices; // this one
+  size_t len;
+  unsigned threads;
+  Entry *a, *tmp;
+  size_t depth;         // bytes every key shares, for the top level
+  unsigned shift;       // top-level bucket: (cache << shift) >> 48
+  size_t *hist;         // [thread][TOP_BUCKETS]: count, then write position
+  size_t *bucket_start; // TOP_BUCKETS + 1 entries
+  unsigned *first;      // worker t sorts buckets [first[t], first[t + 1])
+} StringSort;
+
+typedef struct {
+  ParallelTask task;
+  StringSort *s;
+  uint64_t lo, hi; // cache bounds seen in the chunk
+  size_t min_len;  // shortest key in the chunk
+} Worker;
+
+static void chunk_of(const Worker *w, size_t *begin, size_t *end) {
+  parallel_chunk(w->s->len, w->s->threads, w->task.id, begin, end);
+}
+
+static void build_entries(const StringSort *s, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    Entry *e = &s->a[i];
+    if (s->strs) {
+      e->ptr = (const unsigned char *)s->strs[i];
+      e->len = strlen(s->strs[i]);
+    } else {
+      e->ptr = (const unsigned char *)s->slices[i].ptr;
+      e->len = s->slices[i].len;
+    }
+    e->cache = load_cache(e->ptr, e->len);
+  }
+}
+
+static void write_back(const StringSort *s, const Entry *from, size_t begin,
+                       size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    if (s->strs)
+      s->strs[i] = (char *)from[i].ptr;
+    else
+      s->slices[i] = (StringSlice){(const char *)from[i].ptr, from[i].len};
+  }
+}
+
+static void bounds_of(Worker *w, size_t begin, size_t end) {
+  const Entry *a = w->s->a;
+  uint64_t lo = UINT64_MAX, hi = 0;
+  size_t min_len = SIZE_MAX;
+  for (size_t i = begin; i < end; ++i) {
+    lo = a[i].cache < lo ? a[i].cache : lo;
+    hi = a[i].cache > hi ? a[i].cache : hi;
+    min_len = a[i].len < min_len ? a[i].len : min_len;
+  }
+  w->lo = lo;
+  w->hi = hi;
+  w->min_len = min_len;
+}
+
+static void *build_chunk(void *arg) {
+  Worker *w = arg;
+  size_t begin, end;
+  chunk_of(w, &begin, &end);
+  build_entries(w->s, begin, end);
+  bounds_of(w, begin, end);
+  return NULL;
+}
+
+static void *refill_chunk(void *arg) {
+  Worker *w = arg;
+  size_t begin, end;
+  chunk_of(w, &begin, &end);
+  refill(w->s->a + begin, end - begin, w->s->depth);
+  bounds_of(w, begin, end);
+  return NULL;
+}
+
+static inline size_t top_bucket(const StringSort *s, const Entry *e) {
+  return (size_t)((e->cache << s->shift) >> 48);
+}
+
+static void *count_chunk(void *arg) {
+  Worker *w = arg;
+  StringSort *s = w->s;
+  size_t begin, end;
+  chunk_of(w, &begin, &end);
+  size_t *hist = s->hist + (size_t)w->task.id * TOP_BUCKETS;
+  for (size_t i = begin; i < end; ++i)
+    hist[top_bucket(s, &s->a[i])]++;
+  return NULL;
+}
+
+static void *scatter_chunk(void *arg) {
+  Worker *w = arg;
+  StringSort *s = w->s;
+  size_t begin, end;
+  chunk_of(w, &begin, &end);
+  size_t *pos = s->hist + (size_t)w->task.id * TOP_BUCKETS;
+  for (size_t i = begin; i < end; ++i)
+    s->tmp[pos[top_bucket(s, &s->a[i])]++] = s->a[i];
+  return NULL;
+}
+
+// Buckets are sorted where the scatter left them, in tmp, and written
+// straight to the output.
+static void *sort_buckets(void *arg) {
+  Worker *w = arg;
+  StringSort *s = w->s;
+  for (unsigned b = s->first[w->task.id]; b < s->first[w->task.id + 1]; ++b) {
+    size_t begin = s->bucket_start[b];
+    size_t n = s->bucket_start[b + 1] - begin;
+    if (n > 1)
+      sort_group(s->tmp + begin, n, s->depth, 8);
+  }
+  write_back(s, s->tmp, s->bucket_start[s->first[w->task.id]],
+             s->bucket_start[s->first[w->task.id + 1]]);
+  return NULL;
+}
+
+// Offsets from the histograms, then whole buckets to workers by size.
+static void plan(StringSort *s) {
+  size_t pos = 0;
+  for (size_t b = 0; b < TOP_BUCKETS; ++b) {
+    s->bucket_start[b] = pos;
+    for (unsigned t = 0; t < s->threads; ++t) {
+      size_t *h = &s->hist[(size_t)t * TOP_BUCKETS + b];
+      size_t count = *h;
+      *h = pos;
+      pos += count;
+    }
+  }
+  s->bucket_start[TOP_BUCKETS] = pos;
+
+  unsigned b = 0;
+  s->first[0] = 0;
+  for (unsigned t = 1; t < s->threads; ++t) {
+    size_t target = s->len * t / s->threads;
+    while (b < TOP_BUCKETS && s->bucket_start[b + 1] <= target)
+      b++;
+    s->first[t] = b;
+  }
+  s->first[s->threads] = TOP_BUCKETS;
+}
+
+// Merge the workers' bounds; 1 if every key has 8 more bytes in common.
+static int all_share_cache(const StringSort *s, const Worker *workers,
+                           uint64_t *lo, uint64_t *hi) {
+  size_t min_len = SIZE_MAX;
+  *lo = UINT64_MAX;
+  *hi = 0;
+  for (unsigned t = 0; t < s->threads; ++t) {
+    *lo = workers[t].lo < *lo ? workers[t].lo : *lo;
+    *hi = workers[t].hi > *hi ? workers[t].hi : *hi;
+    min_len = workers[t].min_len < min_len ? workers[t].min_len : min_len;
+  }
+  return *lo == *hi && min_len >= s->depth + 8;
+}
+
+static int sort_parallel(StringSort *s) {
+  s->tmp = malloc(s->len * sizeof *s->tmp);
+  s->hist = calloc((size_t)s->threads * TOP_BUCKETS, sizeof *s->hist);
+  s->bucket_start = malloc((TOP_BUCKETS + 1) * sizeof *s->bucket_start);
+  s->first = malloc((s->threads + 1) * sizeof *s->first);
+  Worker *workers = malloc(s->threads * sizeof *workers);
+  int status = -1;
+  if (s->tmp == NULL || s->hist == NULL || s->bucket_start == NULL ||
+      s->first == NULL || workers == NULL)
+    goto out;
+  for (unsigned t = 0; t < s->threads; ++t)
+    workers[t] = (Worker){.s = s};
+
+  // Skip the prefix all keys share (e.g. "https://www."), 8 bytes a pass,
+  // then bucket on the first two bytes where the cache bounds differ.
+  uint64_t lo, hi;
+  parallel_run(workers, sizeof *workers, s->threads, build_chunk);
+  while (all_share_cache(s, workers, &lo, &hi)) {
+    s->depth += 8;
+    parallel_run(workers, sizeof *workers, s->threads, refill_chunk);
+  }
+  unsigned same = lo == hi ? 8 : (unsigned)__builtin_clzll(lo ^ hi) / 8;
+  s->shift = 8 * (same < 6 ? same : 6);
+
+  parallel_run(workers, sizeof *workers, s->threads, count_chunk);
+  plan(s);
+  parallel_run(workers, sizeof *workers, s->threads, scatter_chunk);
+  parallel_run(workers, sizeof *workers, s->threads, sort_buckets);
+  status = 0;
+
+out:
+  free(workers);
+  free(s->first);
+  free(s->bucket_start);
+  free(s->hist);
+  free(s->tmp);
+  return status;
+}
+
+static int sort_strings(StringSort *s, unsigned threads) {
+  if (s->len < 2)
+    return 0;
+  if (threads == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = online > 0 ? (unsigned)online : 1;
+  }
+  s->threads = s->len < STRING_SORT_SERIAL ? 1 : threads;
+  s->a = malloc(s->len * sizeof *s->a);
+  if (s->a == NULL)
+    return -1;
+
+  int status = 0;
+  if (s->threads > 1) {
+    status = sort_parallel(s);
+  } else {
+    build_entries(s, 0, s->len);
+    sort_group(s->a, s->len, 0, 8);
+    write_back(s, s->a, 0, s->len);
+  }
+  free(s->a);
+  return status;
+}
+
+int string_sort(char *strs[], size_t len, unsigned threads) {
+  if (strs == NULL)
+    return len == 0 ? 0 : -1;
+  StringSort s = {.strs = strs, .len = len};
+  return sort_strings(&s, threads);
+}
+
+int string_sort_slices(StringSlice slices[], size_t len, unsigned threads) {
+  if (slices == NULL)
+    return len == 0 ? 0 : -1;
+  StringSort s = {.slices = slices, .len = len};
+  return sort_strings(&s, threads);
+}
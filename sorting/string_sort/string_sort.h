@@ -0,0 +1,79 @@
+#ifndef STRING_SORT_H
+#define STRING_SORT_H
+
+#include <stddef.h> // For size_t
+
+/*
+ * A byte string that need not be NUL-terminated and may contain NULs.
+ */
+typedef struct {
+  const char *ptr;
+  size_t len;
+} StringSlice;
+
+/*
+ * String Sort (arrays of NUL-terminated strings)
+ *
+ * Params:
+ *     strs    - pointer to the array of string pointers
+ *     len     - number of strings
+ *     threads - worker threads; 0 uses every online CPU
+ *
+ * Returns:
+ *     0 on success, -1 if a buffer could not be allocated (strs is then
+ *     left untouched).
+ *
+ * Description:
+ *     Sorts the pointers into strcmp order (bytes compared as unsigned
+ *     char); the strings themselves are not moved. A comparison sort with
+ *     strcmp re-reads the common prefix of two keys on every comparison
+ *     and follows both pointers to do it. Here each key instead gets an
+ *     entry caching its next 8 bytes as one big-endian integer, so most
+ *     decisions are a single integer compare on contiguous memory:
+ *       - groups of at least STRING_SORT_RADIX entries are split by one
+ *         byte at a time (in-place MSD radix, 256 buckets plus one for
+ *         keys that end there), shifting the byte out of the cache; bytes
+ *         every key of the group shares are skipped in a single pass;
+ *       - smaller groups use multikey quicksort (Bentley-Sedgewick) on
+ *         the cached 8 bytes, three-way: the equal part advances 8 bytes
+ *         at once, so a shared prefix is never compared again;
+ *       - the cache is refilled, with prefetching, only when a group has
+ *         used all 8 bytes, and tiny groups finish with insertion sort
+ *         that starts at the group's known common prefix.
+ *
+ *     With several threads and at least STRING_SORT_SERIAL strings, the
+ *     top level runs in parallel: threads build the entries of their
+ *     chunk, the prefix shared by every key is skipped, and the keys are
+ *     scattered into 65536 buckets by the next two bytes, as in
+ *     sample_sort. Each thread then sorts a contiguous run of whole
+ *     buckets.
+ *
+ *     Not stable (equal strings may be reordered, which only matters if
+ *     their addresses do). O(D + n log n) work for D distinguishing
+ *     bytes, O(n) extra space.
+ */
+int string_sort(char *strs[], size_t len, unsigned threads);
+
+/*
+ * String Sort (arrays of slices)
+ *
+ * Params:
+ *     slices  - pointer to the array of slices
+ *     len     - number of slices
+ *     threads - worker threads; 0 uses every online CPU
+ *
+ * Returns:
+ *     0 on success, -1 if a buffer could not be allocated (slices is then
+ *     left untouched).
+ *
+ * Description:
+ *     string_sort for keys with explicit lengths: bytes are compared as
+ *     unsigned char, and a key that is a prefix of another sorts first.
+ *     No strlen pass is needed.
+ */
+int string_sort_slices(StringSlice slices[], size_t len, unsigned threads);
+
+#define STRING_SORT_RADIX (1 << 12)   // smallest group split by radix
+#define STRING_SORT_SERIAL (1 << 16)  // fewest strings worth the threads
+
+#endif // STRING_SORT_H